@@ -76,12 +76,7 @@ Action::Action(SolverManager& smgr,
       d_returns(returns),
       d_is_empty(empty),
       d_kind(kind)
-
 {
-  MURXLA_CHECK_CONFIG(kind.size() <= MURXLA_MAX_KIND_LEN)
-      << "'" << kind
-      << "' exceeds maximum length for action kinds, increase limit by "
-         "adjusting value of macro MURXLA_MAX_KIND_LEN in config.hpp";
 }
 
 void
@@ -527,7 +522,7 @@ ActionMkSort::generate()
   SortKind kind = d_smgr.pick_sort_kind_data().d_kind;
   RNGenerator::Choice pick;
 
-  ++d_smgr.d_mbt_stats->d_sorts[kind];
+  d_smgr.d_mbt_stats->inc_sort(kind);
 
   switch (kind)
   {
@@ -782,7 +777,7 @@ ActionMkSort::generate()
     default: assert(false);
   }
 
-  ++d_smgr.d_mbt_stats->d_sorts_ok[kind];
+  d_smgr.d_mbt_stats->inc_sort_ok(kind);
 
   return true;
 }
@@ -1293,7 +1288,7 @@ ActionMkTerm::generate(Op::Kind kind)
     sort_kind = *sort_kinds.begin();
   }
 
-  ++d_smgr.d_mbt_stats->d_ops[op.d_id];
+  d_smgr.d_mbt_stats->inc_op(op.d_id);
 
   if (kind == Op::DT_APPLY_CONS)
   {
@@ -1859,7 +1854,7 @@ ActionMkTerm::generate(Op::Kind kind)
     run(kind, sort_kind, args, indices);
   }
 
-  ++d_smgr.d_mbt_stats->d_ops_ok[op.d_id];
+  d_smgr.d_mbt_stats->inc_op_ok(op.d_id);
 
   return true;
 }
@@ -2018,7 +2013,7 @@ ActionMkTerm::generate()
     assert(sort_kind != SORT_ANY);
     run(kind, sort_kind, args, {});
 
-    ++d_smgr.d_mbt_stats->d_ops[op.d_id];
+    d_smgr.d_mbt_stats->inc_op(op.d_id);
     return true;
   }
   return generate(kind);
@@ -2140,7 +2135,11 @@ ActionMkTerm::run(Op::Kind kind,
     }
   }
 
-  Term res = d_solver.mk_term(kind, args, indices);
+  Term res;
+  {
+    auto timer = d_smgr.d_mbt_stats->time_op(kind);
+    res        = d_solver.mk_term(kind, args, indices);
+  }
   // MURXLA_TEST(res->get_sort() == nullptr
   //             || d_solver.get_sort(res, sort_kind)->equals(res->get_sort()));
 
@@ -2190,7 +2189,11 @@ ActionMkTerm::run(Op::Kind kind,
   MURXLA_TRACE << get_kind() << trace_str.str();
   reset_sat();
 
-  Term res = d_solver.mk_term(kind, str_args, args);
+  Term res;
+  {
+    auto timer = d_smgr.d_mbt_stats->time_op(kind);
+    res        = d_solver.mk_term(kind, str_args, args);
+  }
   d_smgr.add_term(res, sort_kind, args);
   Sort res_sort = res->get_sort();
 
@@ -312,6 +312,8 @@ struct ActionTuple
   Action* d_action;
   /** The next state. */
   State* d_next;
+  /** The id of the transition in the statistics. */
+  uint64_t d_id = 0u;
 };
 
 /* -------------------------------------------------------------------------- */
@@ -11,41 +11,14 @@
 #define __MURXLA__CONFIG_H
 
 /**
- * Maximum number of actions.
+ * Number of shards of the statistics counters.
  *
- * There is no real upper limit, but we have to define this statically, because
- * statistics are created in shared memory (and thus no dynamic data structure
- * can be used). If an exception is raised to indicate that the maximum number
- * of actions has been exceeded, increase this value.
+ * Statistics are created in shared memory and updated concurrently by all
+ * processes that run tests, each of which increments the counters of one
+ * shard. Processes are assigned to shards by process id, shards are only
+ * shared by processes if there are more concurrent processes than shards.
  */
-#define MURXLA_MAX_N_ACTIONS 100
-/**
- * Maximum number of operators.
- *
- * There is no real upper limit, but we have to define this statically, because
- * statistics are created in shared memory (and thus no dynamic data structure
- * can be used). If an exception is raised to indicate that the maximum number
- * of operators has been exceeded, increase this value.
- */
-#define MURXLA_MAX_N_OPS 300
-/**
- * Maximum number of states.
- *
- * There is no real upper limit, but we have to define this statically, because
- * statistics are created in shared memory (and thus no dynamic data structure
- * can be used). If an exception is raised to indicate that the maximum number
- * of states has been exceeded, increase this value.
- */
-#define MURXLA_MAX_N_STATES 100
-/**
- * Maximum length of action, operator and state kinds.
- *
- * There is no real upper limit, but we have to define this statically, because
- * statistics are created in shared memory (and thus no dynamic data structure
- * can be used). If an exception is raised to indicate that the maximum length
- * of a kind has been exceeded, increase this value.
- */
-#define MURXLA_MAX_KIND_LEN 100
+#define MURXLA_STATS_N_SHARDS 16
 
 /** Minimum bit-width for bit-vector terms. */
 #define MURXLA_BW_MIN 1
@@ -0,0 +1,224 @@
+/***
+ * Murxla: A Model-Based API Fuzzer for SMT solvers.
+ *
+ * This file is part of Murxla.
+ *
+ * Copyright (C) 2019-2022 by the authors listed in the AUTHORS file.
+ *
+ * See LICENSE for more information on using this software.
+ */
+#include "connection.hpp"
+
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "except.hpp"
+#include "util.hpp"
+
+namespace murxla {
+
+/* -------------------------------------------------------------------------- */
+
+namespace {
+
+/** Return true if given address is the path of a UNIX domain socket. */
+bool
+is_unix_address(const std::string& address)
+{
+  return address.find('/') != std::string::npos
+         || address.find(':') == std::string::npos;
+}
+
+/** Get the UNIX domain socket address of given path. */
+sockaddr_un
+get_unix_address(const std::string& path)
+{
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  MURXLA_EXIT_ERROR(path.size() >= sizeof(addr.sun_path))
+      << "socket path too long '" << path << "'";
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+  return addr;
+}
+
+/**
+ * Resolve given TCP address '<host>:<port>'.
+ * passive: True to resolve an address to listen on.
+ */
+addrinfo*
+get_tcp_address(const std::string& address, bool passive)
+{
+  size_t pos       = address.rfind(':');
+  std::string host = address.substr(0, pos);
+  std::string port = address.substr(pos + 1);
+
+  addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family   = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags    = passive ? AI_PASSIVE : 0;
+
+  addrinfo* res = nullptr;
+  int32_t err   = getaddrinfo(
+      host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &res);
+  MURXLA_EXIT_ERROR(err != 0)
+      << "unable to resolve address '" << address << "': " << gai_strerror(err);
+  return res;
+}
+
+}  // namespace
+
+/* -------------------------------------------------------------------------- */
+
+int32_t
+Connection::listen(const std::string& address)
+{
+  int32_t fd = -1;
+  if (is_unix_address(address))
+  {
+    sockaddr_un addr = get_unix_address(address);
+    fd               = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    /* Remove the socket of a previous coordinator. */
+    unlink(address.c_str());
+    if (fd >= 0
+        && bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+    {
+      close(fd);
+      fd = -1;
+    }
+  }
+  else
+  {
+    addrinfo* res = get_tcp_address(address, true);
+    for (addrinfo* ai = res; ai; ai = ai->ai_next)
+    {
+      fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, 0);
+      if (fd < 0) continue;
+      int32_t reuse = 1;
+      setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+      if (bind(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+      close(fd);
+      fd = -1;
+    }
+    freeaddrinfo(res);
+  }
+  MURXLA_EXIT_ERROR(fd < 0 || ::listen(fd, SOMAXCONN) != 0)
+      << "unable to listen on '" << address << "': " << strerror(errno);
+  return fd;
+}
+
+std::unique_ptr<Connection>
+Connection::accept(int32_t fd)
+{
+  int32_t conn_fd = accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+  if (conn_fd < 0)
+  {
+    return nullptr;
+  }
+  return std::make_unique<Connection>(conn_fd);
+}
+
+std::unique_ptr<Connection>
+Connection::connect(const std::string& address)
+{
+  int32_t fd = -1;
+  if (is_unix_address(address))
+  {
+    sockaddr_un addr = get_unix_address(address);
+    fd               = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd >= 0
+        && ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr))
+               != 0)
+    {
+      close(fd);
+      fd = -1;
+    }
+  }
+  else
+  {
+    addrinfo* res = get_tcp_address(address, false);
+    for (addrinfo* ai = res; ai; ai = ai->ai_next)
+    {
+      fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, 0);
+      if (fd < 0) continue;
+      if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+      close(fd);
+      fd = -1;
+    }
+    freeaddrinfo(res);
+  }
+  MURXLA_EXIT_ERROR(fd < 0)
+      << "unable to connect to '" << address << "': " << strerror(errno);
+  return std::make_unique<Connection>(fd);
+}
+
+Connection::~Connection() { close(d_fd); }
+
+/* -------------------------------------------------------------------------- */
+
+bool
+Connection::send(const nlohmann::json& msg)
+{
+  std::string data = dump_json(msg) + "\n";
+  for (size_t n = 0; n < data.size();)
+  {
+    /* Do not raise SIGPIPE if the peer closed the connection. */
+    ssize_t res = ::send(d_fd, data.c_str() + n, data.size() - n, MSG_NOSIGNAL);
+    if (res < 0 && errno == EINTR) continue;
+    if (res <= 0) return false;
+    n += res;
+  }
+  return true;
+}
+
+bool
+Connection::receive(nlohmann::json& msg)
+{
+  while (!next(msg))
+  {
+    if (!read()) return false;
+  }
+  return true;
+}
+
+bool
+Connection::read()
+{
+  char buf[4096];
+  ssize_t n;
+  do
+  {
+    n = ::read(d_fd, buf, sizeof(buf));
+  } while (n < 0 && errno == EINTR);
+  if (n <= 0) return false;
+  d_buffer.append(buf, n);
+  return true;
+}
+
+bool
+Connection::next(nlohmann::json& msg)
+{
+  size_t pos;
+  while ((pos = d_buffer.find('\n')) != std::string::npos)
+  {
+    std::string line = d_buffer.substr(0, pos);
+    d_buffer.erase(0, pos + 1);
+    msg = nlohmann::json::parse(line, nullptr, false);
+    if (!msg.is_discarded() && msg.is_object() && msg["type"].is_string())
+    {
+      return true;
+    }
+    MURXLA_WARN(true) << "ignoring invalid message '" << line << "'";
+  }
+  return false;
+}
+
+/* -------------------------------------------------------------------------- */
+
+}  // namespace murxla
@@ -0,0 +1,82 @@
+/***
+ * Murxla: A Model-Based API Fuzzer for SMT solvers.
+ *
+ * This file is part of Murxla.
+ *
+ * Copyright (C) 2019-2022 by the authors listed in the AUTHORS file.
+ *
+ * See LICENSE for more information on using this software.
+ */
+#ifndef __MURXLA__CONNECTION_H
+#define __MURXLA__CONNECTION_H
+
+#include <cstdint>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <string>
+
+namespace murxla {
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * A connection between the coordinator and a worker of a distributed
+ * campaign (see Murxla::coordinate() and Murxla::work()).
+ *
+ * Messages are JSON objects with a "type" field, sent as one line each.
+ * Addresses are either of the form '<host>:<port>' for TCP or the path of a
+ * UNIX domain socket (any address containing a '/' or no ':').
+ */
+class Connection
+{
+ public:
+  /** Listen on given address, returns the listening socket. */
+  static int32_t listen(const std::string& address);
+  /** Accept a connection on given listening socket. */
+  static std::unique_ptr<Connection> accept(int32_t fd);
+  /** Connect to given address. */
+  static std::unique_ptr<Connection> connect(const std::string& address);
+
+  /** Constructor, takes ownership of socket 'fd'. */
+  Connection(int32_t fd) : d_fd(fd) {}
+  /** Destructor, closes the socket. */
+  ~Connection();
+
+  /** Get the socket of this connection. */
+  int32_t get_fd() const { return d_fd; }
+
+  /**
+   * Send given message.
+   * Returns false if the connection was closed by the peer.
+   */
+  bool send(const nlohmann::json& msg);
+  /**
+   * Receive the next message, blocks until a complete message is received.
+   * Returns false if the connection was closed by the peer.
+   */
+  bool receive(nlohmann::json& msg);
+
+  /**
+   * Read the data that is available on the socket (without blocking if the
+   * socket is readable, e.g., after poll()) into the receive buffer.
+   * Returns false if the connection was closed by the peer.
+   */
+  bool read();
+  /**
+   * Get the next complete message from the receive buffer.
+   * Returns false if the buffer does not contain a complete message.
+   */
+  bool next(nlohmann::json& msg);
+
+ private:
+  /** The socket. */
+  int32_t d_fd;
+  /** The received data that was not consumed yet. */
+  std::string d_buffer;
+};
+
+/* -------------------------------------------------------------------------- */
+
+}  // namespace murxla
+
+#endif
@@ -9,8 +9,10 @@
  */
 #include "dd.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <fstream>
+#include <nlohmann/json.hpp>
 
 #include "except.hpp"
 #include "fs.hpp"
@@ -71,6 +73,88 @@ split_superset(const std::vector<size_t> superset, size_t subset_size)
   assert(subsets.size() == (size_t) superset_size / subset_size);
   return subsets;
 }
+
+/**
+ * Compute the 64-bit FNV-1a digest of the given string.
+ *
+ * In contrast to std::hash, this digest is stable across builds and can be
+ * persisted in checkpoints.
+ */
+uint64_t
+digest_fnv1a(const std::string& s)
+{
+  uint64_t h = 0xcbf29ce484222325;
+  for (unsigned char c : s)
+  {
+    h = (h ^ c) * 0x100000001b3;
+  }
+  return h;
+}
+
+/**
+ * Compute a second 64-bit digest of the given string, independent of
+ * digest_fnv1a(), to verify hits in the cache of test outcomes.
+ */
+uint64_t
+digest_check(const std::string& s)
+{
+  uint64_t h = s.size();
+  for (unsigned char c : s)
+  {
+    h = (h ^ c) * 0x9e3779b97f4a7c15;
+    h ^= h >> 29;
+  }
+  return h;
+}
+
+/** Copy a (non-JSON) file written while checkpointing back into place. */
+void
+restore_checkpoint_file(const std::string& file_name,
+                        const std::string& dest_file_name)
+{
+  MURXLA_EXIT_ERROR(!filesystem::exists(file_name))
+      << "missing checkpoint file '" << file_name << "'";
+  filesystem::copy_file(
+      file_name, dest_file_name, filesystem::copy_options::overwrite_existing);
+}
+
+/** Read a JSON file written while checkpointing. */
+nlohmann::json
+read_checkpoint_file(const std::string& file_name)
+{
+  nlohmann::json j;
+  MURXLA_EXIT_ERROR(!filesystem::exists(file_name))
+      << "missing checkpoint file '" << file_name << "'";
+  std::ifstream in_file = open_input_file(file_name, false);
+  try
+  {
+    in_file >> j;
+  }
+  catch (const nlohmann::detail::exception& e)
+  {
+    MURXLA_EXIT_ERROR(true)
+        << "invalid checkpoint file '" << file_name << "': " << e.what();
+  }
+  return j;
+}
+
+/**
+ * Write a JSON file while checkpointing.
+ *
+ * Writes to a temp file first and renames it to not end up with a corrupted
+ * checkpoint when killed while writing.
+ */
+void
+write_checkpoint_file(const nlohmann::json& j, const std::string& file_name)
+{
+  std::string tmp_file_name = file_name + ".tmp";
+  {
+    std::ofstream out_file = open_output_file(tmp_file_name, false);
+    out_file << dump_json(j);
+    out_file.close();
+  }
+  filesystem::rename(tmp_file_name, file_name);
+}
 }  // namespace
 
 /* -------------------------------------------------------------------------- */
@@ -92,36 +176,112 @@ DD::run(const std::string& input_trace_file_name,
         std::string reduced_trace_file_name)
 {
   assert(!input_trace_file_name.empty());
+  assert(!reduced_trace_file_name.empty());
 
-  Result gold_exit;
-
-  std::string tmp_api_trace_file_name =
-      get_tmp_file_path(API_TRACE, d_murxla->d_tmp_dir);
   std::string tmp_input_trace_file_name =
       get_tmp_file_path("tmp-dd.trace", d_murxla->d_tmp_dir);
 
-  MURXLA_MESSAGE_DD << "start minimizing file '"
-                    << input_trace_file_name.c_str() << "'";
-
-  /* golden run */
-  auto start = std::chrono::system_clock::now();
-  gold_exit  = d_murxla->run(d_seed,
-                            0,
-                            d_gold_out_file_name,
-                            d_gold_err_file_name,
-                            tmp_input_trace_file_name,
-                            input_trace_file_name,
-                            true,
-                            false,
-                            Murxla::TraceMode::TO_FILE);
-  auto end   = std::chrono::system_clock::now();
-  // Compute time limit for delta-debugging tests (3 * golden runtime).
-  auto gold_time = std::chrono::duration<double>(end - start).count();
-  d_time         = gold_time * 3;
+  if (!d_murxla->d_options.out_dir.empty())
+  {
+    reduced_trace_file_name =
+        prepend_path(d_murxla->d_options.out_dir, reduced_trace_file_name);
+  }
+  d_checkpoint_file_name = reduced_trace_file_name + CHECKPOINT_SUFFIX;
 
-  MURXLA_EXIT_ERROR(gold_exit == RESULT_ERROR_UNTRACE) << d_murxla->d_error_msg;
+  if (d_murxla->d_options.dd_resume
+      && filesystem::exists(d_checkpoint_file_name))
+  {
+    MURXLA_MESSAGE_DD << "resuming from checkpoint '"
+                      << d_checkpoint_file_name.c_str() << "'";
+    read_checkpoint();
+    d_checkpoint_outcomes_file.open(
+        d_checkpoint_file_name + CHECKPOINT_OUTCOMES_SUFFIX, std::ios::app);
+    /* terminate a possibly incomplete last line */
+    d_checkpoint_outcomes_file << std::endl;
+    write_lines_to_file(d_lines, d_included_lines, d_tmp_trace_file_name);
+    MURXLA_MESSAGE_DD << "golden exit: " << d_gold_exit;
+  }
+  else
+  {
+    if (d_murxla->d_options.dd_resume)
+    {
+      MURXLA_MESSAGE_DD << "no checkpoint '" << d_checkpoint_file_name.c_str()
+                        << "' found, starting from scratch";
+    }
+    MURXLA_MESSAGE_DD << "start minimizing file '"
+                      << input_trace_file_name.c_str() << "'";
+
+    /* golden run, limited by the time limit of the original test run (with
+     * some safety margin) to not hang on traces that run into a timeout */
+    double gold_limit = d_murxla->d_options.time * TIME_FACTOR;
+    auto start        = std::chrono::system_clock::now();
+    d_gold_exit = d_murxla->run(d_seed,
+                                gold_limit,
+                                d_gold_out_file_name,
+                                d_gold_err_file_name,
+                                tmp_input_trace_file_name,
+                                input_trace_file_name,
+                                true,
+                                false,
+                                Murxla::TraceMode::TO_FILE);
+    auto end       = std::chrono::system_clock::now();
+    auto gold_time = std::chrono::duration<double>(end - start).count();
+
+    MURXLA_EXIT_ERROR(d_gold_exit == RESULT_ERROR_UNTRACE)
+        << d_murxla->d_error_msg;
+
+    MURXLA_MESSAGE_DD << "golden exit: " << d_gold_exit;
+    init_time(d_gold_exit, gold_time, gold_limit);
+
+    /* Represent input trace as vector of lines.
+     *
+     * A line is a vector of strings with at most two elements.
+     * Trace statements that do not expect a return statement are represented
+     * as a line (vector) with one element.  Trace statements that expect a
+     * return statement are represented as one line, that is, a vector with
+     * two elements: the statement and the return statement.
+     */
+
+    std::string line;
+    std::ifstream trace_file =
+        open_input_file(tmp_input_trace_file_name, false);
+    while (std::getline(trace_file, line))
+    {
+      std::string token;
+      if (line[0] == '#') continue;
+      if (line.rfind("set-murxla-options", 0) == 0)
+      {
+        d_options_line = line;
+        continue;
+      }
+      if (std::getline(
+              std::stringstream(line.erase(0, line.find_first_not_of(' '))),
+              token,
+              ' ')
+          && token == "return")
+      {
+        std::stringstream ss;
+        assert(d_lines.size() > 0);
+        std::vector<std::string>& prev = d_lines.back();
+        prev.push_back(line);
+      }
+      else
+      {
+        d_lines.push_back(std::vector{line});
+      }
+    }
+    trace_file.close();
+
+    d_size = filesystem::file_size(tmp_input_trace_file_name);
+    d_included_lines.resize(d_lines.size());
+    std::iota(d_included_lines.begin(), d_included_lines.end(), 0);
+    d_checkpoint_outcomes_file.open(
+        d_checkpoint_file_name + CHECKPOINT_OUTCOMES_SUFFIX, std::ios::trunc);
+    write_checkpoint_gold();
+    write_checkpoint_lines();
+    write_checkpoint();
+  }
 
-  MURXLA_MESSAGE_DD << "golden exit: " << gold_exit;
   {
     std::ifstream gold_out_file = open_input_file(d_gold_out_file_name, false);
     std::stringstream ss;
@@ -159,87 +319,71 @@ DD::run(const std::string& input_trace_file_name,
 
   /* Start delta debugging */
 
-  /* Represent input trace as vector of lines.
-   *
-   * A line is a vector of strings with at most two elements.
-   * Trace statements that do not expect a return statement are represented
-   * as a line (vector) with one element.  Trace statements that expect a
-   * return statement are represented as one line, that is, a vector with two
-   * elements: the statement and the return statement.
-   */
+  std::vector<std::vector<std::string>> lines = d_lines;
+  std::vector<size_t> included_lines          = d_included_lines;
+  Result gold_exit                            = d_gold_exit;
 
-  std::string line;
-  std::vector<std::vector<std::string>> lines;
-  std::ifstream trace_file = open_input_file(tmp_input_trace_file_name, false);
-  while (std::getline(trace_file, line))
+  /* When resuming from a checkpoint, passes prior to d_pass are skipped in
+   * the first iteration. */
+  do
   {
-    std::string token;
-    if (line[0] == '#') continue;
-    if (line.rfind("set-murxla-options", 0) == 0)
-    {
-      d_options_line = line;
-      continue;
-    }
-    if (std::getline(
-            std::stringstream(line.erase(0, line.find_first_not_of(' '))),
-            token,
-            ' ')
-        && token == "return")
+    if (d_pass == Pass::MINIMIZE_LINES)
     {
-      std::stringstream ss;
-      assert(lines.size() > 0);
-      std::vector<std::string>& prev = lines.back();
-      prev.push_back(line);
-    }
-    else
-    {
-      lines.push_back(std::vector{line});
-    }
-  }
-  trace_file.close();
+      d_fixed_point = true;
 
-  uint64_t iterations = 0;
-  std::uintmax_t size = filesystem::file_size(tmp_input_trace_file_name);
-  std::vector<size_t> included_lines(lines.size());
-  std::iota(included_lines.begin(), included_lines.end(), 0);
-  bool success, fixed_point;
+      bool success = minimize_lines(
+          gold_exit, lines, included_lines, tmp_input_trace_file_name);
 
-  do
-  {
-    fixed_point = true;
+      if (!success && d_iterations > 0) break;
 
-    success = minimize_lines(
-        gold_exit, lines, included_lines, tmp_input_trace_file_name);
-
-    if (!success && iterations > 0) break;
+      next_pass(Pass::SUBSTITUTE_SUBTERMS);
+    }
 
-    if (minimize_line(
-            gold_exit, lines, included_lines, tmp_input_trace_file_name))
+    if (d_pass == Pass::SUBSTITUTE_SUBTERMS)
     {
-      fixed_point = false;
+      if (substitute_subterms(
+              gold_exit, lines, included_lines, tmp_input_trace_file_name))
+      {
+        d_fixed_point = false;
+      }
+      next_pass(Pass::MINIMIZE_LINE);
     }
 
-    if (substitute_terms(
-            gold_exit, lines, included_lines, tmp_input_trace_file_name))
+    if (d_pass == Pass::MINIMIZE_LINE)
     {
-      fixed_point = false;
+      if (minimize_line(
+              gold_exit, lines, included_lines, tmp_input_trace_file_name))
+      {
+        d_fixed_point = false;
+      }
+      next_pass(Pass::SUBSTITUTE_TERMS);
     }
 
-    iterations += 1;
-  } while (!fixed_point);
+    if (d_pass == Pass::SUBSTITUTE_TERMS)
+    {
+      if (substitute_terms(
+              gold_exit, lines, included_lines, tmp_input_trace_file_name))
+      {
+        d_fixed_point = false;
+      }
+    }
 
-  /* Write minimized trace file to path if given. */
-  assert(!reduced_trace_file_name.empty());
-  if (!d_murxla->d_options.out_dir.empty())
-  {
-    reduced_trace_file_name =
-        prepend_path(d_murxla->d_options.out_dir, reduced_trace_file_name);
-  }
+    d_iterations += 1;
+    next_pass(Pass::MINIMIZE_LINES);
+  } while (!d_fixed_point);
 
   MURXLA_MESSAGE_DD;
   MURXLA_MESSAGE_DD << d_ntests_success << " (of " << d_ntests
                     << ") tests reduced successfully";
+  if (d_ntests_cached)
+  {
+    MURXLA_MESSAGE_DD << d_ntests_cached
+                      << " tests answered from cached outcomes";
+  }
+  MURXLA_MESSAGE_DD << "final time limit per test: " << std::fixed
+                    << std::setprecision(2) << d_time << "s";
 
+  /* Write minimized trace file to path. */
   if (filesystem::exists(d_tmp_trace_file_name))
   {
     filesystem::copy(d_tmp_trace_file_name,
@@ -250,13 +394,21 @@ DD::run(const std::string& input_trace_file_name,
     MURXLA_MESSAGE_DD << "file reduced to "
                       << (static_cast<double>(
                               filesystem::file_size(reduced_trace_file_name))
-                          / static_cast<double>(size) * 100)
+                          / static_cast<double>(d_size) * 100)
                       << "% of original size";
   }
   else
   {
     MURXLA_MESSAGE_DD << "unable to reduce api trace";
   }
+
+  d_checkpoint_outcomes_file.close();
+  filesystem::remove(d_checkpoint_file_name);
+  filesystem::remove(d_checkpoint_file_name + CHECKPOINT_GOLD_SUFFIX);
+  filesystem::remove(d_checkpoint_file_name + CHECKPOINT_GOLD_SUFFIX + ".out");
+  filesystem::remove(d_checkpoint_file_name + CHECKPOINT_GOLD_SUFFIX + ".err");
+  filesystem::remove(get_checkpoint_lines_file_name(d_lines_version));
+  filesystem::remove(d_checkpoint_file_name + CHECKPOINT_OUTCOMES_SUFFIX);
 }
 
 bool
@@ -266,9 +418,15 @@ DD::minimize_lines(Result golden_exit,
                    const std::string& input_trace_file_name)
 {
   MURXLA_MESSAGE_DD << "trying to minimize number of trace lines ...";
-  size_t n_lines     = included_lines.size();
-  size_t n_lines_cur = n_lines;
-  size_t subset_size = n_lines_cur / 2;
+  /* Continue with the granularity of the checkpoint when resuming. */
+  if (d_granularity == 0)
+  {
+    d_n_lines     = included_lines.size();
+    d_granularity = d_n_lines / 2;
+  }
+  size_t n_lines     = d_n_lines;
+  size_t n_lines_cur = included_lines.size();
+  size_t subset_size = d_granularity;
 
   while (subset_size > 0)
   {
@@ -298,15 +456,18 @@ DD::minimize_lines(Result golden_exit,
     }
     if (superset_cur.empty())
     {
-      subset_size = subset_size / 2;
+      subset_size   = subset_size / 2;
+      d_granularity = subset_size;
+      write_checkpoint();
     }
     else
     {
       /* write found subset immediately to file and continue */
-      write_lines_to_file(lines, superset_cur, d_tmp_trace_file_name);
       included_lines = superset_cur;
       n_lines_cur    = included_lines.size();
       subset_size    = n_lines_cur / 2;
+      d_granularity  = subset_size;
+      save(lines, included_lines);
       MURXLA_MESSAGE_DD << ">> number of lines reduced to " << std::fixed
                         << std::setprecision(2)
                         << (static_cast<double>(included_lines.size())
@@ -648,6 +809,146 @@ collect_terms_by_sort(
     terms[sort_id].push_back(term_id);
   }
 }
+
+/**
+ * The term DAG defined by the mk-term lines of an api trace.
+ *
+ * Terms and sorts are represented by their id strings.
+ */
+struct TermDag
+{
+  /** Map term id of an mk-term term to the index of its defining line. */
+  std::unordered_map<std::string, size_t> d_lines;
+  /** Map term id of an mk-term term to its sort id. */
+  std::unordered_map<std::string, std::string> d_sorts;
+  /** Map term id of an mk-term term to the ids of its mk-term children. */
+  std::unordered_map<std::string, std::vector<std::string>> d_children;
+  /**
+   * Map term id of an mk-term term to the indices of the lines it occurs in
+   * (excluding its defining line).
+   */
+  std::unordered_map<std::string, std::vector<size_t>> d_occurrences;
+  /**
+   * Map sort id to the simple terms of that sort, given as pairs of the index
+   * of the defining line and the term id. Values are listed before constants,
+   * and in order of occurrence otherwise.
+   */
+  std::unordered_map<std::string, std::vector<std::pair<size_t, std::string>>>
+      d_simple;
+  /** The mk-term terms that do not occur as children of other terms. */
+  std::vector<std::string> d_roots;
+};
+
+/**
+ * Collect the term DAG defined by the mk-term lines of an api trace.
+ *
+ * lines         : The set of trace lines representing the full (unminimized)
+ *                 trace.  A line is represented as a vector of strings with at
+ *                 most 2 elements.
+ * included_lines: The current set of considered lines.
+ * dag           : The resulting term DAG.
+ */
+void
+collect_term_dag(const std::vector<std::vector<std::string>>& lines,
+                 const std::vector<size_t>& included_lines,
+                 TermDag& dag)
+{
+  std::vector<std::string> terms;
+  std::unordered_set<std::string> children;
+  std::unordered_map<std::string, std::vector<std::pair<size_t, std::string>>>
+      consts;
+
+  for (size_t line_idx : included_lines)
+  {
+    const auto& [seed, action_kind, tokens] = tokenize(lines[line_idx][0]);
+
+    /* Record occurrences of mk-term terms (defined on previous lines). */
+    for (const auto& token : tokens)
+    {
+      auto it = dag.d_lines.find(token);
+      if (it == dag.d_lines.end()) continue;
+      auto& occs = dag.d_occurrences[token];
+      if (occs.empty() || occs.back() != line_idx)
+      {
+        occs.push_back(line_idx);
+      }
+      if (action_kind == ActionMkTerm::s_name)
+      {
+        children.insert(token);
+      }
+    }
+
+    if (lines[line_idx].size() != 2 || tokens.empty()) continue;
+
+    const auto& [seed_return, action_kind_return, tokens_return] =
+        tokenize(lines[line_idx][1]);
+    assert(action_kind_return == "return");
+
+    if (action_kind == ActionMkTerm::s_name)
+    {
+      assert(tokens_return.size() == 2);
+      const std::string& term_id = tokens_return[0];
+      std::vector<std::string>& term_children = dag.d_children[term_id];
+      for (const auto& token : tokens)
+      {
+        if (dag.d_lines.find(token) != dag.d_lines.end())
+        {
+          term_children.push_back(token);
+        }
+      }
+      dag.d_lines.emplace(term_id, line_idx);
+      dag.d_sorts.emplace(term_id, tokens_return[1]);
+      terms.push_back(term_id);
+    }
+    else if (action_kind == ActionMkValue::s_name
+             || action_kind == ActionMkSpecialValue::s_name)
+    {
+      assert(tokens_return.size() == 1);
+      dag.d_simple[tokens[0]].emplace_back(line_idx, tokens_return[0]);
+    }
+    else if (action_kind == ActionMkConst::s_name)
+    {
+      assert(tokens_return.size() == 1);
+      consts[tokens[0]].emplace_back(line_idx, tokens_return[0]);
+    }
+  }
+
+  for (const auto& [sort_id, c] : consts)
+  {
+    auto& simple = dag.d_simple[sort_id];
+    simple.insert(simple.end(), c.begin(), c.end());
+  }
+
+  for (const auto& term_id : terms)
+  {
+    if (children.find(term_id) == children.end())
+    {
+      dag.d_roots.push_back(term_id);
+    }
+  }
+}
+
+/**
+ * Replace all occurrences of the term ids given in 'substs' in the given
+ * action line.
+ *
+ * line  : The action line.
+ * substs: Map from term id to the id of the term to substitute it with.
+ */
+std::string
+substitute_in_line(const std::string& line,
+                   const std::unordered_map<std::string, std::string>& substs)
+{
+  const auto& [seed, action_kind, tokens] = tokenize(line);
+  std::stringstream ss;
+  ss << seed << " " << action_kind;
+  for (const auto& token : tokens)
+  {
+    auto it = substs.find(token);
+    ss << " " << (it == substs.end() ? token : it->second);
+  }
+  return ss.str();
+}
 }  // namespace
 
 bool
@@ -737,7 +1038,7 @@ DD::substitute_terms(Result golden_exit,
           else
           {
             /* write found subset immediately to file and continue */
-            write_lines_to_file(lines, included_lines, d_tmp_trace_file_name);
+            save(lines, included_lines);
             superset    = superset_cur;
             n_lines_cur = superset.size();
             subset_size = n_lines_cur / 2;
@@ -757,6 +1058,154 @@ DD::substitute_terms(Result golden_exit,
   return res;
 }
 
+bool
+DD::substitute_subterms(Result golden_exit,
+                        std::vector<std::vector<std::string>>& lines,
+                        const std::vector<size_t>& included_lines,
+                        const std::string& input_trace_file_name)
+{
+  MURXLA_MESSAGE_DD << "trying to minimize trace by substituting subterms ...";
+
+  TermDag dag;
+  collect_term_dag(lines, included_lines, dag);
+
+  std::unordered_set<std::string> substituted;
+  std::unordered_set<std::string> visited(dag.d_roots.begin(),
+                                          dag.d_roots.end());
+  std::vector<std::string> level = dag.d_roots;
+
+  while (!level.empty())
+  {
+    /* Pick a simple term of the same sort that is defined before the term to
+     * substitute (and thus before all of its occurrences). */
+    std::vector<std::pair<std::string, std::string>> batch;
+    for (const auto& term_id : level)
+    {
+      if (dag.d_occurrences.find(term_id) == dag.d_occurrences.end()) continue;
+      auto it = dag.d_simple.find(dag.d_sorts.at(term_id));
+      if (it == dag.d_simple.end()) continue;
+      size_t line_idx = dag.d_lines.at(term_id);
+      for (const auto& [simple_line_idx, simple_id] : it->second)
+      {
+        if (simple_line_idx < line_idx)
+        {
+          batch.emplace_back(term_id, simple_id);
+          break;
+        }
+      }
+    }
+
+    if (!batch.empty())
+    {
+      size_t n_substituted = substituted.size();
+      substitute_subterms_aux(golden_exit,
+                              lines,
+                              included_lines,
+                              input_trace_file_name,
+                              dag.d_occurrences,
+                              batch,
+                              substituted);
+      if (substituted.size() > n_substituted)
+      {
+        MURXLA_MESSAGE_DD << ">> substituted "
+                          << (substituted.size() - n_substituted) << " (of "
+                          << batch.size() << ") subterms";
+      }
+    }
+
+    /* Descend into the children of terms that were not substituted. */
+    std::vector<std::string> next;
+    for (const auto& term_id : level)
+    {
+      if (substituted.find(term_id) != substituted.end()) continue;
+      for (const auto& child : dag.d_children.at(term_id))
+      {
+        if (visited.insert(child).second)
+        {
+          next.push_back(child);
+        }
+      }
+    }
+    level = std::move(next);
+  }
+
+  return !substituted.empty();
+}
+
+void
+DD::substitute_subterms_aux(
+    Result golden_exit,
+    std::vector<std::vector<std::string>>& lines,
+    const std::vector<size_t>& included_lines,
+    const std::string& input_trace_file_name,
+    const std::unordered_map<std::string, std::vector<size_t>>& occurrences,
+    const std::vector<std::pair<std::string, std::string>>& batch,
+    std::unordered_set<std::string>& substituted)
+{
+  assert(!batch.empty());
+
+  /* Cache previous state of lines to update and update lines. */
+  std::unordered_map<std::string, std::string> substs(batch.begin(),
+                                                      batch.end());
+  std::unordered_map<size_t, std::string> lines_cur;
+  for (const auto& [term_id, simple_id] : batch)
+  {
+    for (size_t line_idx : occurrences.at(term_id))
+    {
+      if (lines_cur.find(line_idx) == lines_cur.end())
+      {
+        lines_cur[line_idx] = lines[line_idx][0];
+      }
+    }
+  }
+  for (const auto& l : lines_cur)
+  {
+    lines[l.first][0] = substitute_in_line(l.second, substs);
+  }
+
+  std::vector<size_t> tmp_superset =
+      test(golden_exit, lines, included_lines, input_trace_file_name);
+
+  if (!tmp_superset.empty())
+  {
+    /* success, write to file */
+    save(lines, included_lines);
+    for (const auto& [term_id, simple_id] : batch)
+    {
+      substituted.insert(term_id);
+    }
+    return;
+  }
+
+  /* failure */
+  for (const auto& l : lines_cur)
+  {
+    lines[l.first][0] = l.second;
+  }
+  if (batch.size() > 1)
+  {
+    size_t half = batch.size() / 2;
+    substitute_subterms_aux(
+        golden_exit,
+        lines,
+        included_lines,
+        input_trace_file_name,
+        occurrences,
+        std::vector<std::pair<std::string, std::string>>(batch.begin(),
+                                                         batch.begin() + half),
+        substituted);
+    substitute_subterms_aux(
+        golden_exit,
+        lines,
+        included_lines,
+        input_trace_file_name,
+        occurrences,
+        std::vector<std::pair<std::string, std::string>>(batch.begin() + half,
+                                                         batch.end()),
+        substituted);
+  }
+}
+
 bool
 DD::minimize_line_aux(Result golden_exit,
                       std::vector<std::vector<std::string>>& lines,
@@ -834,7 +1283,7 @@ DD::minimize_line_aux(Result golden_exit,
     else
     {
       /* write to file and continue */
-      write_lines_to_file(lines, included_lines, d_tmp_trace_file_name);
+      save(lines, included_lines);
       line_superset = cur_line_superset;
       subset_size   = line_superset.size() / 2;
       res           = true;
@@ -983,8 +1432,27 @@ DD::test(Result golden_exit,
   std::string tmp_err_file_name =
       get_tmp_file_path("tmp-dd.err", d_murxla->d_tmp_dir);
 
-  write_lines_to_file(lines, superset, untrace_file_name);
+  /* Tests are identified by the digest of their trace, cache hits are
+   * verified by the size and a second digest of the trace. */
+  std::string trace = lines_to_string(lines, superset);
+  uint64_t digest   = digest_fnv1a(trace);
+  uint64_t check    = digest_check(trace);
+  auto it           = d_outcomes.find(digest);
+  if (it != d_outcomes.end() && it->second.size == trace.size()
+      && it->second.check == check)
+  {
+    d_ntests_cached += 1;
+    if (it->second.success) res_superset = superset;
+    return res_superset;
+  }
+
+  {
+    std::ofstream out_file = open_output_file(untrace_file_name, false);
+    out_file << trace;
+    out_file.close();
+  }
   /* while delta debugging, do not trace to file or stdout */
+  auto start  = std::chrono::system_clock::now();
   Result exit = d_murxla->run(d_seed,
                               d_time,
                               tmp_out_file_name,
@@ -994,6 +1462,7 @@ DD::test(Result golden_exit,
                               true,
                               false,
                               Murxla::TraceMode::NONE);
+  auto end = std::chrono::system_clock::now();
   d_ntests += 1;
   if (exit == golden_exit
       && (d_murxla->d_options.dd_ignore_out
@@ -1009,36 +1478,267 @@ DD::test(Result golden_exit,
   {
     res_superset = superset;
     d_ntests_success += 1;
+    update_time(std::chrono::duration<double>(end - start).count());
+  }
+  bool success       = !res_superset.empty();
+  d_outcomes[digest] = {trace.size(), check, success};
+  d_checkpoint_outcomes_file << digest << " " << trace.size() << " " << check
+                             << " " << success << std::endl;
+
+  if (get_cur_wall_time() - d_checkpoint_time >= CHECKPOINT_INTERVAL)
+  {
+    write_checkpoint();
   }
   return res_superset;
 }
 
 void
-DD::write_lines_to_file(const std::vector<std::vector<std::string>>& lines,
-                        const std::vector<size_t> indices,
-                        const std::string& out_file_name)
+DD::init_time(Result gold_exit, double gold_time, double gold_limit)
 {
-  size_t size            = lines.size();
-  std::ofstream out_file = open_output_file(out_file_name, false);
+  d_times.clear();
+  d_gold_timeout = gold_exit == RESULT_TIMEOUT;
+  if (d_gold_timeout)
+  {
+    /* Tightening the time limit would turn candidates that terminate after
+     * the tightened limit into (spurious) successful test runs. */
+    d_time     = gold_limit;
+    d_time_max = gold_limit;
+    MURXLA_MESSAGE_DD << "golden run timed out, using fixed time limit of "
+                      << std::fixed << std::setprecision(2) << d_time
+                      << "s per test";
+    return;
+  }
+  d_time_max = std::max(gold_time * TIME_FACTOR, TIME_MIN);
+  d_time     = d_time_max;
+  /* The golden runtime is considered until TIME_WINDOW successful test runs
+   * have been observed. */
+  d_times.push_back(gold_time);
+  MURXLA_MESSAGE_DD << "initial time limit per test: " << std::fixed
+                    << std::setprecision(2) << d_time << "s";
+}
+
+void
+DD::update_time(double time)
+{
+  if (d_gold_timeout) return;
+
+  d_times.push_back(time);
+  if (d_times.size() > TIME_WINDOW)
+  {
+    d_times.pop_front();
+  }
+  double max = *std::max_element(d_times.begin(), d_times.end());
+  d_time     = std::min(std::max(max * TIME_FACTOR, TIME_MIN), d_time_max);
+}
+
+std::string
+DD::lines_to_string(const std::vector<std::vector<std::string>>& lines,
+                    const std::vector<size_t>& indices) const
+{
+  size_t size = lines.size();
+  std::stringstream ss;
   if (!d_options_line.empty())
   {
-    out_file << d_options_line << std::endl;
+    ss << d_options_line << std::endl;
   }
   for (size_t idx : indices)
   {
     assert(idx < size);
     assert(lines[idx].size() > 0);
     assert(lines[idx].size() <= 2);
-    out_file << lines[idx][0];
+    ss << lines[idx][0];
     if (lines[idx].size() == 2)
     {
-      out_file << std::endl << lines[idx][1];
+      ss << std::endl << lines[idx][1];
     }
-    out_file << std::endl;
+    ss << std::endl;
   }
+  return ss.str();
+}
+
+void
+DD::write_lines_to_file(const std::vector<std::vector<std::string>>& lines,
+                        const std::vector<size_t> indices,
+                        const std::string& out_file_name)
+{
+  std::ofstream out_file = open_output_file(out_file_name, false);
+  out_file << lines_to_string(lines, indices);
   out_file.close();
 }
 
+void
+DD::save(const std::vector<std::vector<std::string>>& lines,
+         const std::vector<size_t>& included_lines)
+{
+  write_lines_to_file(lines, included_lines, d_tmp_trace_file_name);
+  if (lines != d_lines)
+  {
+    d_lines = lines;
+    write_checkpoint_lines();
+  }
+  d_included_lines = included_lines;
+  write_checkpoint();
+}
+
+void
+DD::next_pass(Pass pass)
+{
+  d_pass        = pass;
+  d_granularity = 0;
+  write_checkpoint();
+}
+
+void
+DD::write_checkpoint()
+{
+  nlohmann::json j;
+
+  j["seed"]           = d_seed;
+  j["lines_version"]  = d_lines_version;
+  j["included_lines"] = d_included_lines;
+
+  j["pass"]        = static_cast<int32_t>(d_pass);
+  j["granularity"] = d_granularity;
+  j["n_lines"]     = d_n_lines;
+  j["iterations"]  = d_iterations;
+  j["fixed_point"] = d_fixed_point;
+
+  j["time"]["limit"]        = d_time;
+  j["time"]["limit_max"]    = d_time_max;
+  j["time"]["gold_timeout"] = d_gold_timeout;
+  j["time"]["runtimes"]     = d_times;
+
+  j["ntests"]         = d_ntests;
+  j["ntests_success"] = d_ntests_success;
+
+  write_checkpoint_file(j, d_checkpoint_file_name);
+  d_checkpoint_time = get_cur_wall_time();
+
+  /* The previous lines file is only removed after the checkpoint referring
+   * to the new version was written, so that being killed in between leaves
+   * a consistent checkpoint. */
+  if (d_checkpoint_lines_version != d_lines_version)
+  {
+    filesystem::remove(
+        get_checkpoint_lines_file_name(d_checkpoint_lines_version));
+    d_checkpoint_lines_version = d_lines_version;
+  }
+}
+
+void
+DD::write_checkpoint_gold()
+{
+  nlohmann::json j;
+
+  j["seed"]         = d_seed;
+  j["options_line"] = d_options_line;
+  j["size"]         = d_size;
+  j["exit"]         = static_cast<int32_t>(d_gold_exit);
+
+  /* The output of the golden run is not necessarily valid UTF-8 and thus
+   * copied as is rather than stored in the JSON file. */
+  std::string gold_file_name = d_checkpoint_file_name + CHECKPOINT_GOLD_SUFFIX;
+  filesystem::copy_file(d_gold_out_file_name,
+                        gold_file_name + ".out",
+                        filesystem::copy_options::overwrite_existing);
+  filesystem::copy_file(d_gold_err_file_name,
+                        gold_file_name + ".err",
+                        filesystem::copy_options::overwrite_existing);
+
+  write_checkpoint_file(j, gold_file_name);
+}
+
+void
+DD::write_checkpoint_lines()
+{
+  nlohmann::json j;
+
+  d_lines_version += 1;
+  j["lines_version"] = d_lines_version;
+  j["lines"]         = d_lines;
+
+  write_checkpoint_file(j, get_checkpoint_lines_file_name(d_lines_version));
+}
+
+std::string
+DD::get_checkpoint_lines_file_name(uint64_t version) const
+{
+  return d_checkpoint_file_name + CHECKPOINT_LINES_SUFFIX + "."
+         + std::to_string(version);
+}
+
+void
+DD::read_checkpoint()
+{
+  nlohmann::json j = read_checkpoint_file(d_checkpoint_file_name);
+  nlohmann::json g =
+      read_checkpoint_file(d_checkpoint_file_name + CHECKPOINT_GOLD_SUFFIX);
+
+  MURXLA_EXIT_ERROR(j["seed"].get<uint64_t>() != d_seed
+                    || g["seed"].get<uint64_t>() != d_seed)
+      << "checkpoint file '" << d_checkpoint_file_name
+      << "' was created with a different seed";
+
+  /* The lines file of the next version may have been written before we were
+   * killed, it is not referred to by the checkpoint and thus discarded. */
+  d_lines_version            = j["lines_version"];
+  d_checkpoint_lines_version = d_lines_version;
+  nlohmann::json l =
+      read_checkpoint_file(get_checkpoint_lines_file_name(d_lines_version));
+  filesystem::remove(get_checkpoint_lines_file_name(d_lines_version + 1));
+
+  d_options_line = g["options_line"];
+  d_size         = g["size"];
+  d_gold_exit    = static_cast<Result>(g["exit"].get<int32_t>());
+
+  std::string gold_file_name = d_checkpoint_file_name + CHECKPOINT_GOLD_SUFFIX;
+  restore_checkpoint_file(gold_file_name + ".out", d_gold_out_file_name);
+  restore_checkpoint_file(gold_file_name + ".err", d_gold_err_file_name);
+
+  d_lines          = l["lines"].get<std::vector<std::vector<std::string>>>();
+  d_included_lines = j["included_lines"].get<std::vector<size_t>>();
+
+  d_pass        = static_cast<Pass>(j["pass"].get<int32_t>());
+  d_granularity = j["granularity"];
+  d_n_lines     = j["n_lines"];
+  d_iterations  = j["iterations"];
+  d_fixed_point = j["fixed_point"];
+
+  d_time         = j["time"]["limit"];
+  d_time_max     = j["time"]["limit_max"];
+  d_gold_timeout = j["time"]["gold_timeout"];
+  d_times        = j["time"]["runtimes"].get<std::deque<double>>();
+
+  d_ntests         = j["ntests"];
+  d_ntests_success = j["ntests_success"];
+
+  read_checkpoint_outcomes();
+
+  d_checkpoint_time = get_cur_wall_time();
+}
+
+void
+DD::read_checkpoint_outcomes()
+{
+  std::string file_name = d_checkpoint_file_name + CHECKPOINT_OUTCOMES_SUFFIX;
+  if (!filesystem::exists(file_name)) return;
+
+  std::ifstream in_file = open_input_file(file_name, false);
+  std::string line;
+  while (std::getline(in_file, line))
+  {
+    /* The last line may be incomplete when killed while writing, we
+     * simply ignore it. */
+    std::stringstream ss(line);
+    uint64_t digest;
+    Outcome outcome;
+    if (ss >> digest >> outcome.size >> outcome.check >> outcome.success)
+    {
+      d_outcomes[digest] = outcome;
+    }
+  }
+}
+
 /* -------------------------------------------------------------------------- */
 
 }  // namespace murxla
@@ -11,7 +11,10 @@
 #define __MURXLA__DD_H
 
 #include <cstdint>
+#include <deque>
+#include <fstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "action.hpp"
@@ -27,6 +30,38 @@ class DD
   /** The default api trace file name for temporary trace files. */
   inline static const std::string API_TRACE    = "tmp-dd-api.trace";
 
+  /**
+   * The safety factor applied to observed runtimes when computing the time
+   * limit for a delta debugging test run.
+   */
+  static constexpr double TIME_FACTOR = 3;
+  /** The lower bound for the time limit of a delta debugging test run. */
+  static constexpr double TIME_MIN = 0.25;
+  /**
+   * The number of most recent runtimes of successful test runs the time limit
+   * for a delta debugging test run is computed from.
+   */
+  static constexpr size_t TIME_WINDOW = 16;
+
+  /**
+   * The suffix appended to the name of the reduced trace file to obtain the
+   * name of the checkpoint file.
+   */
+  inline static const std::string CHECKPOINT_SUFFIX = ".checkpoint";
+  /**
+   * The suffixes appended to the name of the checkpoint file to obtain the
+   * names of the files holding the golden run, the trace lines and the log of
+   * test outcomes.
+   */
+  inline static const std::string CHECKPOINT_GOLD_SUFFIX     = ".gold";
+  inline static const std::string CHECKPOINT_LINES_SUFFIX    = ".lines";
+  inline static const std::string CHECKPOINT_OUTCOMES_SUFFIX = ".outcomes";
+  /**
+   * The interval (in seconds) in which checkpoints are written while no
+   * reduction was found.
+   */
+  static constexpr double CHECKPOINT_INTERVAL = 30;
+
   /**
    * Constructor.
    *
@@ -39,14 +74,28 @@ class DD
   /**
    * Delta debug a given api trace.
    *
+   * The current state is periodically checkpointed to file
+   * '<reduced_trace_file_name>.checkpoint' (and the accompanying '.gold*',
+   * '.lines.*' and '.outcomes' files), which is removed when done.
+   * If option --dd-resume is enabled and a checkpoint file exists, delta
+   * debugging continues from that checkpoint.
+   *
    * input_trace_file_name  : The name of the api trace file to minimize.
-   * reduced_trace_file_name: The name of the resulting reduced trace, may be
-   *                          empty.
+   * reduced_trace_file_name: The name of the resulting reduced trace.
    */
   void run(const std::string& input_trace_file_name,
            std::string reduced_trace_file_name);
 
  private:
+  /** The minimization passes, in the order they are applied. */
+  enum class Pass
+  {
+    MINIMIZE_LINES,
+    SUBSTITUTE_SUBTERMS,
+    MINIMIZE_LINE,
+    SUBSTITUTE_TERMS,
+  };
+
   bool minimize_lines(Result golden_exit,
                       const std::vector<std::vector<std::string>>& lines,
                       std::vector<size_t>& included_lines,
@@ -68,6 +117,40 @@ class DD
                                                       std::vector<std::string>,
                                                       size_t>>& to_minimize);
 
+  /**
+   * Minimize trace by replacing subterms with simple terms of the same sort.
+   *
+   * Walks the term DAG defined by the mk-term lines top-down and tries to
+   * replace all occurrences of a term with a value or constant of the same
+   * sort. The terms on each level of the DAG are substituted as one batch,
+   * which is bisected on failure. Only the children of terms that could not
+   * be substituted are considered on the next level.
+   */
+  bool substitute_subterms(Result golden_exit,
+                           std::vector<std::vector<std::string>>& lines,
+                           const std::vector<size_t>& included_lines,
+                           const std::string& input_trace_file_name);
+
+  /**
+   * Helper for substitute_subterms().
+   *
+   * Tries to substitute the given batch of terms at once and bisects the batch
+   * on failure.
+   *
+   * occurrences: Map from term id to the indices of the lines it occurs in.
+   * batch      : The batch of substitutions to try, given as pairs of the id
+   *              of the term to substitute and the id of the substitution.
+   * substituted: The resulting set of successfully substituted term ids.
+   */
+  void substitute_subterms_aux(
+      Result golden_exit,
+      std::vector<std::vector<std::string>>& lines,
+      const std::vector<size_t>& included_lines,
+      const std::string& input_trace_file_name,
+      const std::unordered_map<std::string, std::vector<size_t>>& occurrences,
+      const std::vector<std::pair<std::string, std::string>>& batch,
+      std::unordered_set<std::string>& substituted);
+
   bool substitute_terms(Result golden_exit,
                         std::vector<std::vector<std::string>>& lines,
                         std::vector<size_t>& included_lines,
@@ -78,6 +161,91 @@ class DD
                            const std::vector<size_t>& superset,
                            const std::string& input_trace_file_name);
 
+  /**
+   * Initialize the time limit for delta debugging test runs based on the
+   * golden run.
+   *
+   * If the golden run terminated, the time limit is adapted to the runtimes
+   * of successful test runs (see update_time()), and 'gold_time * TIME_FACTOR'
+   * serves as an upper bound. If the golden run ran into a timeout, the time
+   * limit of the golden run is used for all test runs since a test run is
+   * only successful if it also exceeds this time limit.
+   *
+   * gold_exit : The exit status of the golden run.
+   * gold_time : The runtime of the golden run.
+   * gold_limit: The time limit of the golden run.
+   */
+  void init_time(Result gold_exit, double gold_time, double gold_limit);
+
+  /**
+   * Update the time limit for delta debugging test runs with the runtime of
+   * a successful test run.
+   *
+   * The time limit is computed as the maximum runtime of the last TIME_WINDOW
+   * successful test runs times TIME_FACTOR, bounded by TIME_MIN from below and
+   * the initial time limit from above. Since the candidates get smaller while
+   * delta debugging, the time limit tightens as the trace shrinks.
+   *
+   * time: The runtime of the successful test run.
+   */
+  void update_time(double time);
+
+  /**
+   * Record given trace as the currently minimized trace.
+   *
+   * Writes the trace to d_tmp_trace_file_name and checkpoints the current
+   * state.
+   */
+  void save(const std::vector<std::vector<std::string>>& lines,
+            const std::vector<size_t>& included_lines);
+
+  /** Continue with the given pass and checkpoint the current state. */
+  void next_pass(Pass pass);
+
+  /**
+   * Write the current state to the checkpoint file.
+   *
+   * Only the state that changes while reducing is written here, the golden
+   * run is written once by write_checkpoint_gold(), the trace lines whenever
+   * they change by write_checkpoint_lines() and test outcomes are appended
+   * to the outcomes log as they are determined.
+   */
+  void write_checkpoint();
+  /** Write the golden run to the checkpoint gold file. */
+  void write_checkpoint_gold();
+  /**
+   * Write the current trace lines to a new version of the checkpoint lines
+   * file. The previous version is removed by write_checkpoint() once the
+   * checkpoint refers to the new version.
+   */
+  void write_checkpoint_lines();
+  /** Get the name of the checkpoint lines file of the given version. */
+  std::string get_checkpoint_lines_file_name(uint64_t version) const;
+
+  /** Restore the state from the checkpoint files. */
+  void read_checkpoint();
+  /** Restore the cache of test outcomes from the outcomes log. */
+  void read_checkpoint_outcomes();
+
+  /** The outcome of a test, cached by the digest of its trace. */
+  struct Outcome
+  {
+    /** The size of the trace. */
+    uint64_t size;
+    /** A second, independent digest of the trace to verify cache hits. */
+    uint64_t check;
+    /** True if the test was successful. */
+    bool success;
+  };
+
+  /**
+   * Get the string representation of the trace consisting of the lines at
+   * the indices given in 'indices'.
+   */
+  std::string lines_to_string(
+      const std::vector<std::vector<std::string>>& lines,
+      const std::vector<size_t>& indices) const;
+
   /**
    * Write trace lines to output file.
    *
@@ -108,6 +276,12 @@ class DD
   uint64_t d_seed;
   /** The time limit for one test run. */
   double d_time;
+  /** The upper bound for the time limit of one test run. */
+  double d_time_max = 0;
+  /** True if the golden run ran into a timeout. */
+  bool d_gold_timeout = false;
+  /** The runtimes of the last TIME_WINDOW successful test runs. */
+  std::deque<double> d_times;
 
   /** Number of tests performed while delta debugging. */
   uint64_t d_ntests = 0;
@@ -121,6 +295,46 @@ class DD
   std::string d_tmp_trace_file_name;
   /** The trace line configuring murxla options. */
   std::string d_options_line;
+  /** The exit status of the golden run. */
+  Result d_gold_exit = RESULT_UNKNOWN;
+  /** The size of the input trace file. */
+  std::uintmax_t d_size = 0;
+
+  /** The lines of the currently minimized trace. */
+  std::vector<std::vector<std::string>> d_lines;
+  /** The indices of the included lines of the currently minimized trace. */
+  std::vector<size_t> d_included_lines;
+
+  /** The current pass. */
+  Pass d_pass = Pass::MINIMIZE_LINES;
+  /** The current granularity (subset size) of minimize_lines(). */
+  size_t d_granularity = 0;
+  /** The number of included lines at the start of minimize_lines(). */
+  size_t d_n_lines = 0;
+  /** The number of iterations over all passes. */
+  uint64_t d_iterations = 0;
+  /** True if no pass was successful in the current iteration (so far). */
+  bool d_fixed_point = true;
+
+  /**
+   * Map digest of the trace of a test to the outcome of the test.
+   * Digests are stable across builds since they are persisted in the
+   * outcomes log of the checkpoint.
+   */
+  std::unordered_map<uint64_t, Outcome> d_outcomes;
+  /** Number of tests answered from d_outcomes rather than run. */
+  uint64_t d_ntests_cached = 0;
+
+  /** The name of the checkpoint file. */
+  std::string d_checkpoint_file_name;
+  /** The log of test outcomes, outcomes are appended as they are determined. */
+  std::ofstream d_checkpoint_outcomes_file;
+  /** Incremented whenever the trace lines of the checkpoint change. */
+  uint64_t d_lines_version = 0;
+  /** The version of the trace lines the checkpoint file refers to. */
+  uint64_t d_checkpoint_lines_version = 0;
+  /** The wall clock time of the last checkpoint. */
+  double d_checkpoint_time = 0;
 };
 
 }  // namespace murxla
@@ -0,0 +1,243 @@
+/***
+ * Murxla: A Model-Based API Fuzzer for SMT solvers.
+ *
+ * This file is part of Murxla.
+ *
+ * Copyright (C) 2019-2022 by the authors listed in the AUTHORS file.
+ *
+ * See LICENSE for more information on using this software.
+ */
+#include "error_db.hpp"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <nlohmann/json.hpp>
+#include <sstream>
+
+#include "except.hpp"
+#include "util.hpp"
+
+namespace murxla {
+
+/* -------------------------------------------------------------------------- */
+
+ErrorDatabase::Lock::Lock(ErrorDatabase* db) : d_db(db)
+{
+  if (d_db)
+  {
+    MURXLA_EXIT_ERROR(flock(d_db->d_fd, LOCK_EX) != 0)
+        << "unable to lock error database '" << d_db->d_file_name << "'";
+  }
+}
+
+ErrorDatabase::Lock::~Lock()
+{
+  if (d_db)
+  {
+    flock(d_db->d_fd, LOCK_UN);
+  }
+}
+
+/* -------------------------------------------------------------------------- */
+
+nlohmann::json
+ErrorDatabase::make_record(uint64_t id,
+                           const std::string& errmsg,
+                           const std::string& signature,
+                           uint64_t seed,
+                           const std::string& time)
+{
+  std::stringstream ss_seed;
+  ss_seed << std::hex << seed;
+  nlohmann::json j;
+  j["id"]        = id;
+  j["message"]   = errmsg;
+  j["signature"] = signature;
+  j["seed"]      = ss_seed.str();
+  j["time"]      = time;
+  return j;
+}
+
+std::string
+ErrorDatabase::get_unique_key(const ErrorMap& errors,
+                              const std::string& err_norm,
+                              const std::string& signature)
+{
+  std::string key = err_norm;
+  if (errors.find(key) != errors.end())
+  {
+    key += "\n" + signature;
+  }
+  while (errors.find(key) != errors.end())
+  {
+    key += "\n";
+  }
+  return key;
+}
+
+ErrorDatabase::ErrorDatabase(const std::string& file_name)
+    : d_file_name(file_name), d_flush_time(get_cur_wall_time())
+{
+  d_fd = open(file_name.c_str(),
+              O_CREAT | O_RDWR | O_APPEND,
+              S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+  MURXLA_EXIT_ERROR(d_fd < 0)
+      << "unable to open error database '" << file_name << "'";
+}
+
+ErrorDatabase::~ErrorDatabase()
+{
+  if (!d_pending.empty())
+  {
+    Lock lock(this);
+    flush();
+  }
+  close(d_fd);
+}
+
+std::vector<std::string>
+ErrorDatabase::update(ErrorMap& errors)
+{
+  std::vector<std::string> res;
+  /* The records are applied chunk by chunk, 'buf' only holds the incomplete
+   * record at the end of the chunks read so far. */
+  std::string buf;
+  char chunk[65536];
+  ssize_t n;
+  while ((n = pread(d_fd, chunk, sizeof(chunk), d_offset + buf.size())) > 0)
+  {
+    buf.append(chunk, n);
+
+    /* Only consume complete records. */
+    size_t begin = 0, end;
+    while ((end = buf.find('\n', begin)) != std::string::npos)
+    {
+      apply(buf.substr(begin, end - begin), errors, res);
+      begin = end + 1;
+    }
+    d_offset += begin;
+    buf.erase(0, begin);
+  }
+  return res;
+}
+
+void
+ErrorDatabase::apply(const std::string& record,
+                     ErrorMap& errors,
+                     std::vector<std::string>& added)
+{
+  if (record.empty()) return;
+
+  nlohmann::json j = nlohmann::json::parse(record, nullptr, false);
+  if (j.is_discarded() || !j.is_object() || !j["id"].is_number_unsigned()
+      || !j["key"].is_string()
+      || !(j["message"].is_string() || j["count"].is_number_unsigned()))
+  {
+    MURXLA_WARN(true) << "skipping invalid record in error database '"
+                      << d_file_name << "'";
+    return;
+  }
+
+  std::string key  = j["key"].get<std::string>();
+  std::string time = j.value("time", "");
+  auto it          = errors.find(key);
+
+  /* Aggregate records always follow the record of the first occurrence. */
+  if (j.contains("count"))
+  {
+    if (it == errors.end())
+    {
+      MURXLA_WARN(true) << "skipping record of unknown error in error "
+                        << "database '" << d_file_name << "'";
+      return;
+    }
+    it->second.num_recorded += j["count"].get<uint64_t>();
+    it->second.last_seen = time;
+    return;
+  }
+
+  if (it == errors.end())
+  {
+    it = errors
+             .emplace(key,
+                      ErrorInfo(j["id"].get<uint64_t>(),
+                                j["message"].get<std::string>(),
+                                {},
+                                j.value("signature", "")))
+             .first;
+    it->second.known      = true;
+    it->second.first_seen = time;
+    added.push_back(key);
+  }
+  it->second.num_recorded += 1;
+  it->second.last_seen = time;
+}
+
+void
+ErrorDatabase::add(const std::string& key, ErrorInfo& info, uint64_t seed)
+{
+  std::string time = get_cur_utc_time();
+
+  if (info.num_recorded == 0)
+  {
+    nlohmann::json j =
+        make_record(info.id, info.errmsg, info.signature, seed, time);
+    j["key"] = key;
+    write_records(dump_json(j) + "\n");
+    info.first_seen = time;
+  }
+  else
+  {
+    Pending& pending =
+        d_pending.emplace(key, Pending{info.id, 0, ""}).first->second;
+    pending.count += 1;
+    pending.last_seen = time;
+  }
+  info.num_recorded += 1;
+  info.last_seen = time;
+
+  if (get_cur_wall_time() - d_flush_time >= FLUSH_INTERVAL)
+  {
+    flush();
+  }
+}
+
+void
+ErrorDatabase::write_records(const std::string& records)
+{
+  ssize_t n = write(d_fd, records.c_str(), records.size());
+  MURXLA_EXIT_ERROR(n != static_cast<ssize_t>(records.size()))
+      << "unable to write to error database '" << d_file_name << "'";
+
+  /* The database is locked and was updated before, the records were thus
+   * appended at the current offset. */
+  d_offset += records.size();
+}
+
+void
+ErrorDatabase::flush()
+{
+  std::string records;
+  for (const auto& [key, pending] : d_pending)
+  {
+    nlohmann::json j;
+    j["id"]    = pending.id;
+    j["key"]   = key;
+    j["count"] = pending.count;
+    j["time"]  = pending.last_seen;
+    records += dump_json(j) + "\n";
+  }
+  if (!records.empty())
+  {
+    write_records(records);
+  }
+  d_pending.clear();
+  d_flush_time = get_cur_wall_time();
+}
+
+/* -------------------------------------------------------------------------- */
+
+}  // namespace murxla
@@ -0,0 +1,171 @@
+/***
+ * Murxla: A Model-Based API Fuzzer for SMT solvers.
+ *
+ * This file is part of Murxla.
+ *
+ * Copyright (C) 2019-2022 by the authors listed in the AUTHORS file.
+ *
+ * See LICENSE for more information on using this software.
+ */
+#ifndef __MURXLA__ERROR_DB_H
+#define __MURXLA__ERROR_DB_H
+
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace murxla {
+
+/* -------------------------------------------------------------------------- */
+
+struct ErrorInfo
+{
+  ErrorInfo(uint64_t id,
+            const std::string& errmsg,
+            const std::vector<uint64_t>& seeds,
+            const std::string& signature = "")
+      : id(id), errmsg(errmsg), seeds(seeds), signature(signature){};
+
+  uint64_t id;
+  std::string errmsg;
+  std::vector<uint64_t> seeds;
+  /** The signature of the error, see get_error_signature(). */
+  std::string signature;
+
+  /**
+   * True if the error was not found by this process but loaded from the error
+   * database (see ErrorDatabase).
+   */
+  bool known = false;
+  /** The number of occurrences of the error recorded in the error database. */
+  uint64_t num_recorded = 0;
+  /** The time of the first and last recorded occurrence of the error. */
+  std::string first_seen;
+  std::string last_seen;
+};
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * A persistent error database shared by subsequent and concurrent campaigns.
+ *
+ * The database is an append-only file in JSON Lines format with one record
+ * per error (id, key, message, signature, seed and time of its first
+ * occurrence), see add(). Further occurrences are counted in memory and
+ * recorded as aggregate records (id, key, count and time of the last
+ * occurrence) at most every FLUSH_INTERVAL seconds and when the database is
+ * closed, which keeps the file proportional to the number of distinct
+ * errors rather than to the number of occurrences.
+ *
+ * Records are read incrementally (see update()), i.e., at startup, all
+ * records are loaded, and afterwards only the records that were appended
+ * by concurrent campaigns since the last update.
+ *
+ * Concurrent campaigns synchronize on an exclusive lock of the database file
+ * (see Lock), which must be held while updating, looking up and adding errors
+ * in order to assign consistent error ids.
+ */
+class ErrorDatabase
+{
+ public:
+  using ErrorMap = std::unordered_map<std::string, ErrorInfo>;
+
+  /**
+   * The interval (in seconds) in which the occurrences of already recorded
+   * errors are recorded.
+   */
+  static constexpr double FLUSH_INTERVAL = 60;
+
+  /** Exclusive lock of the database for the lifetime of this object. */
+  class Lock
+  {
+   public:
+    /** Constructor, does nothing if 'db' is null. */
+    Lock(ErrorDatabase* db);
+    ~Lock();
+
+   private:
+    ErrorDatabase* d_db;
+  };
+
+  /**
+   * Create the record of an error found with given seed at given time, as
+   * added to the database and exported via --export-errors.
+   */
+  static nlohmann::json make_record(uint64_t id,
+                                    const std::string& errmsg,
+                                    const std::string& signature,
+                                    uint64_t seed,
+                                    const std::string& time);
+
+  /**
+   * Get a key for a new error with given normalized message and signature
+   * that is not used in 'errors' yet. The key is the normalized message,
+   * distinguished by signature (and newlines) if it is already in use.
+   */
+  static std::string get_unique_key(const ErrorMap& errors,
+                                    const std::string& err_norm,
+                                    const std::string& signature);
+
+  /** Constructor, opens (or creates) the database file 'file_name'. */
+  ErrorDatabase(const std::string& file_name);
+  /** Destructor, records pending occurrences and closes the database. */
+  ~ErrorDatabase();
+
+  /**
+   * Read the records appended to the database since the last update into
+   * 'errors'. Errors that are not in 'errors' yet are added as known errors.
+   * Returns the keys of the added errors.
+   */
+  std::vector<std::string> update(ErrorMap& errors);
+
+  /**
+   * Record an occurrence of given error. The first occurrence of an error is
+   * recorded immediately, further occurrences are aggregated (see flush()).
+   * key : The key of the error in the error map.
+   * info: The error, updated with the time of the occurrence.
+   * seed: The seed of the run that triggered the error.
+   */
+  void add(const std::string& key, ErrorInfo& info, uint64_t seed);
+
+ private:
+  /** The occurrences of an error that were not recorded yet. */
+  struct Pending
+  {
+    uint64_t id;
+    uint64_t count;
+    std::string last_seen;
+  };
+
+  /** Append given records to the database file. */
+  void write_records(const std::string& records);
+  /** Record the pending occurrences of errors as aggregate records. */
+  void flush();
+
+  /**
+   * Apply given record to 'errors'.
+   * added: The keys of the errors added to 'errors' so far.
+   */
+  void apply(const std::string& record,
+             ErrorMap& errors,
+             std::vector<std::string>& added);
+
+  /** The name of the database file. */
+  std::string d_file_name;
+  /** The file descriptor of the database file. */
+  int32_t d_fd = -1;
+  /** The offset up to which the database file was read. */
+  uint64_t d_offset = 0;
+  /** The occurrences of errors that were not recorded yet, by key. */
+  std::unordered_map<std::string, Pending> d_pending;
+  /** The wall clock time of the last flush(). */
+  double d_flush_time = 0;
+};
+
+/* -------------------------------------------------------------------------- */
+
+}  // namespace murxla
+
+#endif
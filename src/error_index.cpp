@@ -0,0 +1,395 @@
+/***
+ * Murxla: A Model-Based API Fuzzer for SMT solvers.
+ *
+ * This file is part of Murxla.
+ *
+ * Copyright (C) 2019-2022 by the authors listed in the AUTHORS file.
+ *
+ * See LICENSE for more information on using this software.
+ */
+#include "error_index.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+namespace murxla {
+
+/* -------------------------------------------------------------------------- */
+
+namespace {
+
+/** The maximum difference of errors classified as the same error. */
+constexpr double MAX_DIFF = 0.05;
+
+/** Return true if 'diff' characters of 'len' characters exceed MAX_DIFF. */
+bool
+exceeds(size_t diff, size_t len)
+{
+  return !(static_cast<double>(diff) / static_cast<double>(len) <= MAX_DIFF);
+}
+
+/** Return true if 's' is non-empty and only consists of digits. */
+bool
+is_number(const std::string& s)
+{
+  return !s.empty()
+         && std::all_of(s.begin(), s.end(), [](unsigned char c) {
+              return std::isdigit(c);
+            });
+}
+
+/**
+ * Get the source location 'file:line' of given location 'file:line[:col]'.
+ * Returns an empty string if 'loc' is not a source location.
+ */
+std::string
+get_source_location(const std::string& loc)
+{
+  size_t pos = loc.rfind(':');
+  if (pos == std::string::npos || pos == 0) return "";
+  if (!is_number(loc.substr(pos + 1))) return "";
+  size_t pos_line = loc.rfind(':', pos - 1);
+  if (pos_line != std::string::npos && pos_line > 0
+      && is_number(loc.substr(pos_line + 1, pos - pos_line - 1)))
+  {
+    /* file:line:col */
+    return loc.substr(0, pos);
+  }
+  return loc;
+}
+
+/**
+ * Get the kind of a sanitizer report from its header line, e.g.,
+ * "AddressSanitizer: heap-use-after-free" for line
+ * "==42==ERROR: AddressSanitizer: heap-use-after-free on address 0x...".
+ * Returns an empty string if 'line' is not the header of a sanitizer report.
+ */
+std::string
+get_sanitizer_kind(const std::string& line)
+{
+  size_t pos = line.find("Sanitizer: ");
+  if (pos == std::string::npos || line.find("SUMMARY: ") != std::string::npos)
+  {
+    return "";
+  }
+  size_t begin = line.find_last_of(" :=", pos);
+  begin        = begin == std::string::npos ? 0 : begin + 1;
+  size_t end   = line.find_first_of(" \t", pos + 11);
+  return line.substr(begin, end == std::string::npos ? end : end - begin);
+}
+
+/**
+ * Get the function (or the module if not symbolized) of a stack frame line of
+ * a sanitizer report, e.g., "foo" for "    #1 0x4f2a in foo src/foo.c:12:3"
+ * and "libfoo.so" for "    #1 0x4f2a  (/lib/libfoo.so+0x4f2a)".
+ * frame: Set to the frame number.
+ * Returns an empty string if 'line' is not a stack frame line.
+ */
+std::string
+get_stack_frame(const std::string& line, size_t& frame)
+{
+  std::stringstream ss(line);
+  std::string tok, addr, func;
+  if (!(ss >> tok) || tok.size() < 2 || tok[0] != '#'
+      || !is_number(tok.substr(1)))
+  {
+    return "";
+  }
+  frame = std::stoull(tok.substr(1));
+  if (!(ss >> addr) || addr.compare(0, 2, "0x") != 0 || !(ss >> tok))
+  {
+    return "";
+  }
+  if (tok == "in")
+  {
+    ss >> func;
+    return func;
+  }
+  /* Not symbolized, use module without offset. */
+  if (tok[0] != '(') return "";
+  size_t end = tok.find('+');
+  if (end == std::string::npos) end = tok.size() - 1;
+  func = tok.substr(1, end - 1);
+  return func.substr(func.rfind('/') + 1);
+}
+
+/**
+ * Get the source location of a failed assertion.
+ * Supports the formats of glibc ("prog: file:line: func: Assertion `e'
+ * failed."), BSD libc ("Assertion failed: (e), function f, file x, line n.")
+ * and fatal failures reported by cvc5 and Bitwuzla ("Fatal failure within f
+ * at file:line").
+ * Returns an empty string if 'line' does not report a failed assertion.
+ */
+std::string
+get_assertion_location(const std::string& line)
+{
+  size_t pos;
+  if ((pos = line.find(": Assertion `")) != std::string::npos)
+  {
+    /* Location is the second to last component of the prefix. */
+    std::string prefix = line.substr(0, pos);
+    size_t end         = prefix.rfind(": ");
+    if (end == std::string::npos) return "";
+    size_t begin = prefix.rfind(": ", end - 1);
+    begin        = begin == std::string::npos ? 0 : begin + 2;
+    return get_source_location(prefix.substr(begin, end - begin));
+  }
+  if ((pos = line.find("Assertion failed: ")) != std::string::npos)
+  {
+    size_t pos_file = line.find(", file ", pos);
+    size_t pos_line = line.find(", line ", pos);
+    if (pos_file == std::string::npos || pos_line == std::string::npos)
+    {
+      return "";
+    }
+    std::string num = line.substr(pos_line + 7);
+    num             = num.substr(0, num.find_first_not_of("0123456789"));
+    return line.substr(pos_file + 7, pos_line - pos_file - 7) + ":" + num;
+  }
+  if ((pos = line.find("Fatal failure within ")) != std::string::npos)
+  {
+    size_t begin = line.rfind(" at ");
+    if (begin == std::string::npos || begin < pos) return "";
+    std::string loc = line.substr(begin + 4);
+    return get_source_location(loc.substr(0, loc.find_first_of(" \t")));
+  }
+  return "";
+}
+
+}  // namespace
+
+/* -------------------------------------------------------------------------- */
+
+std::string
+get_error_signature(const std::string& err, int32_t signal, size_t num_frames)
+{
+  std::string kind, assertion;
+  std::vector<std::string> frames;
+  bool in_stack = false, frames_done = false;
+
+  std::stringstream ss(err);
+  std::string line;
+  while (std::getline(ss, line))
+  {
+    if (kind.empty())
+    {
+      kind = get_sanitizer_kind(line);
+      if (kind.empty())
+      {
+        size_t pos = line.find(": runtime error: ");
+        if (pos != std::string::npos)
+        {
+          std::string loc = get_source_location(line.substr(0, pos));
+          if (!loc.empty())
+          {
+            kind = "UndefinedBehaviorSanitizer: runtime error at " + loc;
+          }
+        }
+      }
+      if (!kind.empty()) continue;
+    }
+
+    if (assertion.empty())
+    {
+      assertion = get_assertion_location(line);
+      if (!assertion.empty()) continue;
+    }
+
+    /* Only consider the first stack trace. */
+    if (!frames_done)
+    {
+      size_t frame     = 0;
+      std::string func = get_stack_frame(line, frame);
+      if (!func.empty())
+      {
+        if (frame == 0 && in_stack)
+        {
+          frames_done = true;
+        }
+        /* Skip sanitizer runtime and libc internals. */
+        else if (func.compare(0, 2, "__") != 0)
+        {
+          frames.push_back(func);
+          frames_done = frames.size() >= num_frames;
+        }
+        in_stack = true;
+      }
+    }
+  }
+
+  if (kind.empty() && assertion.empty() && frames.empty())
+  {
+    return "";
+  }
+
+  std::stringstream res;
+  if (!kind.empty()) res << kind << "\n";
+  for (const auto& f : frames) res << "in " << f << "\n";
+  if (!assertion.empty()) res << "assertion at " << assertion << "\n";
+  if (signal) res << "signal " << signal << "\n";
+  return res.str();
+}
+
+/* -------------------------------------------------------------------------- */
+
+ErrorIndex::Error::Error(const std::string& err) : d_err(err)
+{
+  size_t n = err.size();
+  for (size_t i = 0; i < n;)
+  {
+    if (std::isspace(static_cast<unsigned char>(err[i])))
+    {
+      ++i;
+      continue;
+    }
+    size_t j            = i;
+    uint32_t non_digits = 0;
+    for (; j < n && !std::isspace(static_cast<unsigned char>(err[j])); ++j)
+    {
+      if (!std::isdigit(static_cast<unsigned char>(err[j]))) ++non_digits;
+    }
+    d_tokens.emplace_back(err, i, j - i);
+    d_non_digits.push_back(non_digits);
+    if (d_tokens.size() > 1)
+    {
+      d_signature += '\n';
+    }
+    /* Numbers are erased, tokens are never empty. */
+    if (non_digits > 0)
+    {
+      d_signature += d_tokens.back();
+    }
+    i = j;
+  }
+}
+
+/* -------------------------------------------------------------------------- */
+
+double
+ErrorIndex::diff(const std::string& e1, const std::string& e2)
+{
+  Error err1(e1), err2(e2);
+  const Error* t1 = &err1;
+  const Error* t2 = &err2;
+
+  if (t1->d_tokens.size() > t2->d_tokens.size())
+  {
+    std::swap(t1, t2);
+  }
+
+  size_t diff = t2->d_tokens.size() - t1->d_tokens.size();
+  for (size_t i = 0, n = t1->d_tokens.size(); i < n; ++i)
+  {
+    if (t1->d_tokens[i] != t2->d_tokens[i])
+    {
+      /* Ignore numbers for diff. */
+      diff += t1->d_non_digits[i];
+    }
+  }
+  size_t len = std::max(e1.size(), e2.size());
+  return static_cast<double>(diff) / static_cast<double>(len);
+}
+
+bool
+ErrorIndex::is_same(const Error& err, const Error& other)
+{
+  size_t len = std::max(err.d_err.size(), other.d_err.size());
+  if (len == 0)
+  {
+    return false;
+  }
+
+  const Error* t1 = &err;
+  const Error* t2 = &other;
+  if (t1->d_tokens.size() > t2->d_tokens.size())
+  {
+    std::swap(t1, t2);
+  }
+
+  size_t diff = t2->d_tokens.size() - t1->d_tokens.size();
+  if (exceeds(diff, len))
+  {
+    return false;
+  }
+  for (size_t i = 0, n = t1->d_tokens.size(); i < n; ++i)
+  {
+    if (t1->d_non_digits[i] > 0 && t1->d_tokens[i] != t2->d_tokens[i])
+    {
+      diff += t1->d_non_digits[i];
+      if (exceeds(diff, len))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void
+ErrorIndex::add(const std::string& err)
+{
+  size_t idx = d_errors.size();
+  d_errors.emplace_back(err);
+  const Error& e = d_errors.back();
+  d_signatures[e.d_signature].push_back(idx);
+  d_num_tokens[e.d_tokens.size()].push_back(idx);
+  d_max_len = std::max(d_max_len, err.size());
+}
+
+const std::string*
+ErrorIndex::find(const std::string& err) const
+{
+  Error e(err);
+
+  /* Errors with the same signature only differ in numbers. */
+  auto it = d_signatures.find(e.d_signature);
+  if (it != d_signatures.end())
+  {
+    for (size_t idx : it->second)
+    {
+      if (is_same(e, d_errors[idx]))
+      {
+        return &d_errors[idx].d_err;
+      }
+    }
+  }
+
+  /* The difference in the number of tokens is a lower bound for the
+   * difference of two errors, only errors with a number of tokens within
+   * MAX_DIFF of the longest error are candidates. */
+  size_t n       = e.d_tokens.size();
+  size_t max_len = std::max(d_max_len, err.size());
+  size_t delta   =
+      static_cast<size_t>(MAX_DIFF * static_cast<double>(max_len)) + 1;
+  auto end = d_num_tokens.upper_bound(n + delta);
+  for (auto iit = d_num_tokens.lower_bound(n > delta ? n - delta : 0);
+       iit != end;
+       ++iit)
+  {
+    for (size_t idx : iit->second)
+    {
+      if (is_same(e, d_errors[idx]))
+      {
+        return &d_errors[idx].d_err;
+      }
+    }
+  }
+  return nullptr;
+}
+
+void
+ErrorIndex::clear()
+{
+  d_errors.clear();
+  d_signatures.clear();
+  d_num_tokens.clear();
+  d_max_len = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+}  // namespace murxla
@@ -0,0 +1,116 @@
+/***
+ * Murxla: A Model-Based API Fuzzer for SMT solvers.
+ *
+ * This file is part of Murxla.
+ *
+ * Copyright (C) 2019-2022 by the authors listed in the AUTHORS file.
+ *
+ * See LICENSE for more information on using this software.
+ */
+#ifndef __MURXLA__ERROR_INDEX_H
+#define __MURXLA__ERROR_INDEX_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace murxla {
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Extract a signature of the error reported in given error output of a solver
+ * process that can be used to identify the error independently of incidental
+ * details of the error message.
+ *
+ * The signature consists of
+ * - the kind and the top 'num_frames' frames of the stack trace of the first
+ *   sanitizer report (ASAN, UBSAN, MSAN, TSAN, LSAN), or the source location
+ *   of an UBSAN runtime error,
+ * - the source location of a failed assertion, and
+ * - the signal that terminated the process, if any.
+ *
+ * err       : The error output of the solver process.
+ * signal    : The signal that terminated the process, 0 if none.
+ * num_frames: The maximum number of stack frames to consider.
+ * Returns an empty string if 'err' does not contain a sanitizer report or
+ * a failed assertion.
+ */
+std::string get_error_signature(const std::string& err,
+                                int32_t signal,
+                                size_t num_frames = 3);
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * An index of error messages for finding errors that are classified as the
+ * same error as a given error, i.e., that differ in at most 5% of characters
+ * (see diff()).
+ *
+ * Errors are tokenized once when they are added. Errors that are equal modulo
+ * numbers (the common case for duplicates) are found via a hash map of their
+ * signatures (their tokens with numbers erased). All other candidates are
+ * restricted to errors with a number of tokens close enough to the number of
+ * tokens of the given error to possibly be within 5%, and are compared with
+ * early termination.
+ */
+class ErrorIndex
+{
+ public:
+  /**
+   * Compute the difference of two error messages, i.e., the number of
+   * non-digit characters of the tokens they differ in (plus the difference in
+   * the number of tokens) relative to the length of the longer message.
+   */
+  static double diff(const std::string& e1, const std::string& e2);
+
+  /** Add error message 'err' to the index. */
+  void add(const std::string& err);
+  /**
+   * Find an error in the index that differs from 'err' in at most 5% of
+   * characters.
+   * Returns nullptr if there is no such error.
+   */
+  const std::string* find(const std::string& err) const;
+
+  /** Get the number of errors in the index. */
+  size_t size() const { return d_errors.size(); }
+  /** Remove all errors from the index. */
+  void clear();
+
+ private:
+  /** A tokenized error message. */
+  struct Error
+  {
+    Error(const std::string& err);
+
+    /** The error message. */
+    std::string d_err;
+    /** The tokens of the error message. */
+    std::vector<std::string> d_tokens;
+    /** The number of non-digit characters of each token. */
+    std::vector<uint32_t> d_non_digits;
+    /** The tokens with numbers erased, separated by newlines. */
+    std::string d_signature;
+  };
+
+  /** Return true if 'err' and 'other' differ in at most 5% of characters. */
+  static bool is_same(const Error& err, const Error& other);
+
+  /** The indexed errors. */
+  std::vector<Error> d_errors;
+  /** Map error signatures to the indices of the errors with that signature. */
+  std::unordered_map<std::string, std::vector<size_t>> d_signatures;
+  /** Map number of tokens to the indices of the errors with as many tokens. */
+  std::map<size_t, std::vector<size_t>> d_num_tokens;
+  /** The length of the longest indexed error. */
+  size_t d_max_len = 0;
+};
+
+/* -------------------------------------------------------------------------- */
+
+}  // namespace murxla
+
+#endif
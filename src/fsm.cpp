@@ -60,20 +60,27 @@ State::run(RNGenerator& rng)
   ActionTuple& atup = d_actions[idx];
 
   /* record state statistics */
-  ++d_mbt_stats->d_states[get_id()];
+  d_mbt_stats->inc_state(get_id());
 
   assert(f_precond == nullptr || f_precond());
 
-  /* record action statistics */
-  ++d_mbt_stats->d_actions[atup.d_action->get_id()];
+  /* record action and transition statistics */
+  d_mbt_stats->inc_action(atup.d_action->get_id());
+  d_mbt_stats->inc_transition(atup.d_id);
 
   /* run action */
   atup.d_action->seed_solver_rng();
-  if (atup.d_action->generate()
+  bool success;
+  {
+    auto timer = d_mbt_stats->time_action(atup.d_action->get_id());
+    success    = atup.d_action->generate();
+  }
+  if (success
       && (atup.d_next->f_precond == nullptr || atup.d_next->f_precond()))
   {
-    /* record action statistics */
-    ++d_mbt_stats->d_actions_ok[atup.d_action->get_id()];
+    /* record action and transition statistics */
+    d_mbt_stats->inc_action_ok(atup.d_action->get_id());
+    d_mbt_stats->inc_transition_ok(atup.d_id);
 
     return d_actions[idx].d_next;
   }
@@ -85,6 +92,7 @@ State::run(RNGenerator& rng)
   else if (atup.d_action->disabled())
   {
     d_weights[idx] = 0;
+    d_mbt_stats->inc_transition_disabled(atup.d_id);
   }
 
   return this;
@@ -212,19 +220,12 @@ FSM::new_state(const State::Kind& kind,
                bool is_final,
                State::ConfigKind config)
 {
-  uint64_t id = d_states.size();
-
-  MURXLA_CHECK_CONFIG(id < MURXLA_MAX_N_STATES)
-      << "maximum number of states exceeded, increase limit by adjusting "
-         "value of macro MURXLA_MAX_N_STATES in config.hpp";
-
   State* state;
   d_states.emplace_back(new State(kind, fun, ignore, is_final, config));
 
   state = d_states.back().get();
-  state->set_id(id);
+  state->set_id(d_mbt_stats->register_state(kind));
   state->d_mbt_stats = d_mbt_stats;
-  strncpy(d_mbt_stats->d_state_kinds[id], kind.c_str(), kind.size());
 
   return state;
 }
@@ -609,6 +610,32 @@ FSM::configure()
       i += 1;
     }
   }
+
+  /* --------------------------------------------------------------------- */
+  /* Register transitions with statistics                                  */
+  /* --------------------------------------------------------------------- */
+
+  for (const auto& s : d_states)
+  {
+    /* Transitions with the same action and next state are counted as one. */
+    std::unordered_map<std::string, uint32_t> weights;
+    for (size_t i = 0, n = s->d_actions.size(); i < n; ++i)
+    {
+      const ActionTuple& atup = s->d_actions[i];
+      weights[atup.d_action->get_kind() + "\n" + atup.d_next->get_kind()] +=
+          s->d_weights[i];
+    }
+    for (size_t i = 0, n = s->d_actions.size(); i < n; ++i)
+    {
+      ActionTuple& atup = s->d_actions[i];
+      atup.d_id         = d_mbt_stats->register_transition(
+          s->get_kind(),
+          atup.d_action->get_kind(),
+          atup.d_next->get_kind(),
+          weights.at(atup.d_action->get_kind() + "\n"
+                     + atup.d_next->get_kind()));
+    }
+  }
 }
 
 void
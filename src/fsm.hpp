@@ -33,7 +33,7 @@ namespace murxla {
 /* -------------------------------------------------------------------------- */
 
 namespace statistics {
-struct Statistics;
+class Statistics;
 }
 
 /**
@@ -211,10 +211,6 @@ class State
         d_ignore(ignore),
         f_precond(fun)
   {
-    MURXLA_CHECK_CONFIG(kind.size() <= MURXLA_MAX_KIND_LEN)
-        << "'" << kind
-        << "' exceeds maximum length for state kinds, increase limit by "
-           "adjusting value of macro MURXLA_MAX_KIND_LEN in config.hpp";
   }
 
   /**
@@ -644,20 +640,10 @@ FSM::new_action()
                 "expected class (derived from) Action");
   T* action               = new T(d_smgr);
   const Action::Kind& kind = action->get_kind();
-  assert(kind.size() <= MURXLA_MAX_KIND_LEN);
   if (d_actions.find(kind) == d_actions.end())
   {
-    uint64_t id = d_actions.size();
-    if (id >= MURXLA_MAX_N_ACTIONS)
-    {
-      delete action;
-      throw MurxlaConfigException(
-          "maximum number of actions exceeded, increase limit by adjusting "
-          "value of macro MURXLA_MAX_N_ACTIONS in config.hpp");
-    }
-    action->set_id(id);
+    action->set_id(d_mbt_stats->register_action(kind));
     d_actions[kind].reset(action);
-    strncpy(d_mbt_stats->d_action_kinds[id], kind.c_str(), kind.size());
   }
   else
   {
@@ -10,25 +10,29 @@
 #include <fcntl.h>
 #include <stdarg.h>
 #include <string.h>
-#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <ctime>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <nlohmann/json.hpp>
 #include <numeric>
 #include <regex>
 #include <sstream>
 
 #include "dd.hpp"
+#include "error_index.hpp"
 #include "except.hpp"
 #include "exit.hpp"
 #include "fs.hpp"
 #include "murxla.hpp"
 #include "options.hpp"
+#include "solver/solver_profile.hpp"
 #include "solver_option.hpp"
 #include "statistics.hpp"
 #include "util.hpp"
@@ -45,36 +49,14 @@ static std::string TMP_DIR = "";
 static Murxla::ErrorMap g_errors;
 static bool g_errors_print_csv = false;
 
-/* -------------------------------------------------------------------------- */
+/**
+ * The statistics of the current campaign and the file to write them to (for
+ * the result bundle of a shard, see --shard).
+ */
+static Statistics* g_stats = nullptr;
+static std::string g_stats_file_name;
 
-static Statistics*
-initialize_statistics()
-{
-  int fd;
-  std::stringstream ss;
-  std::string shmfilename;
-  Statistics* stats;
-
-  ss << "/tmp/murxla-shm-" << getpid();
-  shmfilename = ss.str();
-
-  MURXLA_EXIT_ERROR((fd = open(shmfilename.c_str(), O_RDWR | O_CREAT, S_IRWXU))
-                    < 0)
-      << "failed to create shared memory file for statistics";
-
-  stats = static_cast<Statistics*>(mmap(0,
-                                        sizeof(Statistics),
-                                        PROT_READ | PROT_WRITE,
-                                        MAP_ANONYMOUS | MAP_SHARED,
-                                        fd,
-                                        0));
-  memset(stats, 0, sizeof(Statistics));
-
-  MURXLA_EXIT_ERROR(close(fd))
-      << "failed to close shared memory file for statistics";
-  (void) unlink(shmfilename.c_str());
-  return stats;
-}
+/* -------------------------------------------------------------------------- */
 
 static bool
 path_is_dir(const std::string& path)
@@ -121,15 +103,22 @@ escape_csv(const std::string& str)
 void
 print_error_summary()
 {
-  if (g_errors.size())
+  /* Errors loaded from the error database that were not encountered in this
+   * campaign are not reported. */
+  size_t num_errors = std::count_if(
+      g_errors.begin(), g_errors.end(), [](const auto& p) {
+        return !p.second.seeds.empty();
+      });
+  if (num_errors)
   {
-    std::cout << "\nError statistics (" << g_errors.size() << " in total):\n"
+    std::cout << "\nError statistics (" << num_errors << " in total):\n"
               << std::endl;
 
     if (g_errors_print_csv)
     {
       for (const auto& [e_norm, e_info] : g_errors)
       {
+        if (e_info.seeds.empty()) continue;
         std::cout << "murxla:csv:" << e_info.seeds.size() << ",";
         std::cout << "\"" << escape_csv(e_info.errmsg) << "\",";
         for (auto seed : e_info.seeds)
@@ -144,6 +133,7 @@ print_error_summary()
       Terminal term;
       for (const auto& [e_norm, e_info] : g_errors)
       {
+        if (e_info.seeds.empty()) continue;
         std::cout << term.red() << e_info.seeds.size()
                   << " errors: " << term.defaultcolor();
         for (size_t i = 0; i < std::min<size_t>(e_info.seeds.size(), 10); ++i)
@@ -154,12 +144,224 @@ print_error_summary()
           }
           std::cout << std::hex << e_info.seeds[i] << std::dec;
         }
+        if (e_info.known)
+        {
+          std::cout << term.gray() << " (known, recorded "
+                    << e_info.num_recorded << " times since "
+                    << e_info.first_seen << ")" << term.defaultcolor();
+        }
         std::cout << "\n" << e_info.errmsg << "\n" << std::endl;
       }
     }
   }
 }
 
+/**
+ * Compact the JSON Lines error export given via --compact-errors into the
+ * 'errors.exclude' format of solver profiles, merged with the solver profile
+ * given via -p (if any), and print it to stdout.
+ */
+void
+compact_errors(const Options& options)
+{
+  const std::string& file_name = options.compact_errors_filename;
+  std::ifstream file           = open_input_file(file_name, false);
+  std::vector<std::string> errors;
+  std::unordered_set<std::string> cache;
+  std::string line;
+  size_t nline = 0;
+
+  while (std::getline(file, line))
+  {
+    nline += 1;
+    if (line.empty()) continue;
+    nlohmann::json j = nlohmann::json::parse(line, nullptr, false);
+    if (j.is_discarded() || !j.is_object() || !j.contains("message")
+        || !j["message"].is_string())
+    {
+      /* Skip an incomplete last record, which may still be being written. */
+      MURXLA_EXIT_ERROR(file.peek() != std::ifstream::traits_type::eof())
+          << "invalid error record in line " << nline << " of file '"
+          << file_name << "'";
+      break;
+    }
+    std::string errmsg = j["message"].get<std::string>();
+    if (cache.insert(errmsg).second)
+    {
+      errors.push_back(errmsg);
+    }
+  }
+
+  nlohmann::json j;
+  j["errors"]["exclude"] = errors;
+  std::string profile = dump_json(j);
+  if (!options.solver_profile_filename.empty())
+  {
+    std::ifstream ifs = open_input_file(options.solver_profile_filename, false);
+    std::stringstream buf;
+    buf << ifs.rdbuf();
+    profile = SolverProfile::merge(buf.str(), profile);
+  }
+  std::cout << std::setw(2) << nlohmann::json::parse(profile) << std::endl;
+}
+
+/**
+ * Read the seeds of the seeds file given via --seeds-file into
+ * 'options.seeds'. Seeds are given in hex and separated by whitespace,
+ * comments start with '#'.
+ */
+void
+read_seeds_file(const std::string& file_name, Options& options)
+{
+  std::ifstream file = open_input_file(file_name, false);
+  std::string line;
+  size_t nline = 0;
+
+  while (std::getline(file, line))
+  {
+    nline += 1;
+    std::stringstream ss(line.substr(0, line.find('#')));
+    std::string token;
+    while (ss >> token)
+    {
+      size_t pos = 0;
+      uint64_t seed;
+      try
+      {
+        seed = std::stoull(token, &pos, 16);
+      }
+      catch (std::exception& e)
+      {
+        pos = 0;
+      }
+      MURXLA_EXIT_ERROR(pos != token.size())
+          << "invalid seed '" << token << "' in line " << nline << " of file '"
+          << file_name << "'";
+      options.seeds.push_back(seed);
+    }
+  }
+  MURXLA_EXIT_ERROR(options.seeds.empty())
+      << "no seeds given in file '" << file_name << "'";
+}
+
+/**
+ * Write the statistics of the current campaign to the result bundle (if
+ * any). The file is replaced atomically.
+ */
+void
+write_stats_bundle()
+{
+  if (g_stats == nullptr || g_stats_file_name.empty()) return;
+
+  std::string tmp_file_name = g_stats_file_name + ".tmp";
+  {
+    std::ofstream out = open_output_file(tmp_file_name, false);
+    out << g_stats->to_json().dump() << std::endl;
+  }
+  std::rename(tmp_file_name.c_str(), g_stats_file_name.c_str());
+}
+
+/**
+ * Merge the result bundles of shards given via --merge into a single error
+ * summary (errors are deduplicated as in a single campaign, by signature or
+ * by similarity of their messages) and, if --stats is given, aggregated
+ * statistics.
+ */
+void
+merge_bundles(const Options& options)
+{
+  ErrorIndex index;
+  std::unordered_map<std::string, std::string> signatures;
+  std::vector<nlohmann::json> stats;
+
+  for (const auto& dir : options.merge_dirs)
+  {
+    MURXLA_EXIT_ERROR(!path_is_dir(dir))
+        << "given path is not a directory '" << dir << "'";
+
+    std::ifstream errors(prepend_path(dir, "errors.jsonl"));
+    std::string line;
+    while (std::getline(errors, line))
+    {
+      nlohmann::json j = nlohmann::json::parse(line, nullptr, false);
+      if (j.is_discarded() || !j.is_object() || !j["key"].is_string()
+          || !j["message"].is_string() || !j["seed"].is_string())
+      {
+        /* A shard that was killed may have left an incomplete record. */
+        continue;
+      }
+      /* The key of an error without signature is its normalized message. */
+      std::string key       = j["key"].get<std::string>();
+      std::string signature = j.value("signature", "");
+      uint64_t seed = std::stoull(j["seed"].get<std::string>(), nullptr, 16);
+
+      const std::string* e_norm = nullptr;
+      if (!signature.empty())
+      {
+        auto it = signatures.find(signature);
+        if (it != signatures.end())
+        {
+          e_norm = &it->second;
+        }
+      }
+      else
+      {
+        e_norm = index.find(key);
+      }
+
+      if (e_norm)
+      {
+        g_errors.at(*e_norm).seeds.push_back(seed);
+        continue;
+      }
+
+      if (g_errors.find(key) != g_errors.end())
+      {
+        key += "\n" + signature;
+      }
+      g_errors.emplace(key,
+                       ErrorInfo(g_errors.size() + 1,
+                                 j["message"].get<std::string>(),
+                                 {seed},
+                                 signature));
+      if (!signature.empty())
+      {
+        signatures.emplace(signature, key);
+      }
+      else
+      {
+        index.add(key);
+      }
+    }
+
+    std::ifstream stats_file(prepend_path(dir, "stats.json"));
+    if (stats_file.is_open())
+    {
+      nlohmann::json j = nlohmann::json::parse(stats_file, nullptr, false);
+      MURXLA_EXIT_ERROR(j.is_discarded() || !j.is_object())
+          << "invalid statistics in result bundle '" << dir << "'";
+      stats.push_back(j);
+    }
+  }
+
+  print_error_summary();
+
+  if (options.print_stats)
+  {
+    Statistics merged;
+    try
+    {
+      merged.load(stats);
+    }
+    catch (nlohmann::json::exception& e)
+    {
+      MURXLA_EXIT_ERROR(true) << "invalid statistics in result bundle: "
+                              << e.what();
+    }
+    merged.print();
+  }
+}
+
 /* -------------------------------------------------------------------------- */
 /* Signal handling                                                            */
 /* -------------------------------------------------------------------------- */
@@ -174,6 +376,7 @@ catch_signal_esummary(int32_t sig)
   if (!caught_signal)
   {
     print_error_summary();
+    write_stats_bundle();
     caught_signal = sig;
   }
   if (filesystem::exists(TMP_DIR))
@@ -208,6 +411,8 @@ set_sigint_handler_stats(void)
   "  -l, --smt-lib              generate SMT-LIB compliant traces only\n"      \
   "  -y, --random-symbols       use random symbol names\n"                     \
   "  --stats                    print statistics\n"                            \
+  "  --stats-timing             print statistics including latencies of\n"     \
+  "                             actions and term creation per operator\n"      \
   "  --print-fsm                print FSM configuration, may be combined\n"    \
   "                             with solver option to show config for \n"      \
   "\n"                                                                         \
@@ -215,7 +420,42 @@ set_sigint_handler_stats(void)
   "  -t, --time <double>        time limit per test run\n"                     \
   "  -m, --max-runs <int>       limit number of test runs\n"                   \
   "  --csv                      print error summary in csv format\n"           \
-  "  -e, --export-errors <out>  export found errors to JSON file <out>\n"      \
+  "  -e, --export-errors <out>  append found errors to JSON Lines <out>\n"     \
+  "  --compact-errors <file>    print errors exported to <file> as solver\n"   \
+  "                             profile (merged with -p profile)\n"            \
+  "  --error-db <file>          load and record errors in error database\n"    \
+  "                             <file>, shared with other campaigns\n"         \
+  "  --stats-export <file>      append statistics deltas to <file> every\n"    \
+  "                             interval (CSV if <file> ends in '.csv', else\n"\
+  "                             JSON Lines)\n"                                 \
+  "  --stats-textfile <file>    write statistics to node exporter text file\n" \
+  "                             <file> every interval\n"                       \
+  "  --stats-interval <double>  statistics export interval in seconds\n"       \
+  "                             (default: 60)\n"                               \
+  "  --shard <i>/<N>            test shard i of N disjoint shards of the\n"    \
+  "                             seed space, write a result bundle (error\n"    \
+  "                             database, statistics, traces) to -O <dir>\n"   \
+  "  --merge <dir>...           merge the result bundles of shards into a\n"   \
+  "                             single error summary (and statistics with\n"   \
+  "                             --stats)\n"                                    \
+  "  --coordinator <address>    coordinate a campaign distributed over\n"      \
+  "                             workers connecting to <address>, either\n"     \
+  "                             <host>:<port> or the path of a UNIX socket\n"  \
+  "                             (the seeds are a sequence selected by -s,\n"   \
+  "                             or a new sequence per campaign otherwise)\n"   \
+  "  --worker <address>         run the jobs of the coordinator at\n"          \
+  "                             <address>\n"                                   \
+  "  --checkpoint <double>      checkpoint the state of the campaign to\n"     \
+  "                             -O <dir> every <double> seconds\n"             \
+  "  --resume                   resume the campaign from its checkpoint in\n"  \
+  "                             -O <dir> (checkpoints every 60s if not\n"      \
+  "                             specified otherwise)\n"                        \
+  "  --seeds-file <file>        test the seeds (in hex) given in <file>\n"     \
+  "                             instead of random seeds (only the first <n>\n" \
+  "                             seeds if combined with -m <n>)\n"              \
+  "  --seeds-report <file>      write the result of each seed given via\n"     \
+  "                             --seeds-file to <file> in JSON Lines\n"        \
+  "                             format (default: seeds.jsonl in -O <dir>)\n"   \
   "\n"                                                                         \
   " One-shot mode options:\n"                                                  \
   "  -s, --seed <int>           seed for random number generator\n"            \
@@ -233,6 +473,7 @@ set_sigint_handler_stats(void)
   "  --dd-ignore-err            ignore stderr output when delta debugging\n"   \
   "  --dd-ignore-out            ignore stdout output when delta debugging\n"   \
   "  -D, --dd-trace <file>      delta debug API trace into <file>\n"           \
+  "  --dd-resume                resume delta debugging from checkpoint\n"      \
   "\n"                                                                         \
   " Solvers:\n"                                                                \
   "  --btor                     test Boolector\n"                              \
@@ -242,6 +483,14 @@ set_sigint_handler_stats(void)
   "  --smt2 [<binary>]          print SMT-LIB 2 (optionally to solver "        \
   "binary\n"                                                                   \
   "                             via stdout)\n"                                 \
+  "  --smt2-pipelined           pipeline commands to solver binary without\n"  \
+  "                             waiting for each 'success' response\n"         \
+  "  --smt2-fanout <binary>     also pass SMT-LIB 2 to solver <binary> and\n"  \
+  "                             compare results (may be given repeatedly)\n"   \
+  "  --smt2-share-terms         define shared subterms globally via\n"         \
+  "                             define-fun with --smt2\n"                      \
+  "  --smt2-reuse <K>           reuse solver binary process for up to <K>\n"   \
+  "                             runs, reset via '(reset)' after each run\n"    \
   "  -o name=value,...          solver options enabled by default\n"           \
   "  --fuzz-opts [wildcard,...] restrict options to be fuzzed with multiple\n" \
   "                             wildcards, which are matched against option\n" \
@@ -250,6 +499,13 @@ set_sigint_handler_stats(void)
   "  -c, --cross-check <solver> cross check with <solver> (SMT-LIB only)\n"    \
   "  --cross-check-opts name=value,...\n"                                      \
   "                             options for cross check solver\n"              \
+  "  --cross-check-threaded     run cross check solver concurrently on a\n"    \
+  "                             separate thread\n"                             \
+  "  --cross-check-lazy         defer calls into cross check solver until\n"   \
+  "                             results are compared\n"                        \
+  "  --cross-check-sample <perc>\n"                                            \
+  "                             cross check only <perc>% of check-sat calls\n" \
+  "                             (implies --cross-check-lazy)\n"                \
   "  -C, --check [<solver>]     check unsat cores/assumptions and \n"          \
   "                             model values with <solver>\n"                  \
   "\n"                                                                         \
@@ -445,6 +701,11 @@ parse_options(Options& options, int argc, char* argv[])
       check_next_arg(arg, i, size);
       options.dd_trace_file_name = args[i];
     }
+    else if (arg == "--dd-resume")
+    {
+      options.dd        = true;
+      options.dd_resume = true;
+    }
     else if (arg == "-u" || arg == "--untrace")
     {
       i += 1;
@@ -461,6 +722,31 @@ parse_options(Options& options, int argc, char* argv[])
       check_solver(solver);
       options.cross_check = solver;
     }
+    else if (arg == "--cross-check-threaded")
+    {
+      options.cross_check_threaded = true;
+    }
+    else if (arg == "--cross-check-lazy")
+    {
+      options.cross_check_lazy = true;
+    }
+    else if (arg == "--cross-check-sample")
+    {
+      i += 1;
+      check_next_arg(arg, i, size);
+      std::stringstream ss(args[i]);
+      int32_t perc = -1;
+      ss >> perc;
+      MURXLA_EXIT_ERROR(!std::isdigit(static_cast<unsigned char>(args[i][0]))
+                        || ss.fail() || !ss.eof() || perc > 100)
+          << "invalid argument " << args[i] << " to option '" << arg
+          << "', expected value between 0 and 100";
+      options.cross_check_sample = perc;
+      if (perc < 100)
+      {
+        options.cross_check_lazy = true;
+      }
+    }
     else if (arg == "-C" || arg == "--check")
     {
       record_args.push_back(arg);
@@ -532,6 +818,34 @@ parse_options(Options& options, int argc, char* argv[])
       }
       options.solver = SOLVER_SMT2;
     }
+    else if (arg == "--smt2-pipelined")
+    {
+      record_args.push_back(arg);
+      options.smt2_pipelined = true;
+    }
+    else if (arg == "--smt2-fanout")
+    {
+      i += 1;
+      check_next_arg(arg, i, size);
+      options.smt2_fanout.push_back(args[i]);
+      record_args.push_back(arg);
+      record_args.push_back(args[i]);
+    }
+    else if (arg == "--smt2-share-terms")
+    {
+      record_args.push_back(arg);
+      options.smt2_share_terms = true;
+    }
+    else if (arg == "--smt2-reuse")
+    {
+      i += 1;
+      check_next_arg(arg, i, size);
+      std::stringstream ss(args[i]);
+      ss >> options.smt2_reuse;
+      MURXLA_EXIT_ERROR(!std::isdigit(static_cast<unsigned char>(args[i][0]))
+                        || ss.fail() || !ss.eof() || options.smt2_reuse == 0)
+          << "invalid argument to option '" << arg << "': " << args[i];
+    }
     else if (arg == "-f" || arg == "--smt2-file")
     {
       i += 1;
@@ -562,6 +876,11 @@ parse_options(Options& options, int argc, char* argv[])
     {
       options.print_stats = true;
     }
+    else if (arg == "--stats-timing")
+    {
+      options.print_stats  = true;
+      options.stats_timing = true;
+    }
     else if (arg == "--print-fsm")
     {
       options.print_fsm = true;
@@ -576,6 +895,94 @@ parse_options(Options& options, int argc, char* argv[])
       check_next_arg(arg, i, size);
       options.export_errors_filename = args[i];
     }
+    else if (arg == "--error-db")
+    {
+      i += 1;
+      check_next_arg(arg, i, size);
+      options.error_db_filename = args[i];
+    }
+    else if (arg == "--stats-export")
+    {
+      i += 1;
+      check_next_arg(arg, i, size);
+      options.stats_export_filename = args[i];
+    }
+    else if (arg == "--stats-textfile")
+    {
+      i += 1;
+      check_next_arg(arg, i, size);
+      options.stats_textfile_filename = args[i];
+    }
+    else if (arg == "--stats-interval")
+    {
+      i += 1;
+      check_next_arg(arg, i, size);
+      options.stats_interval = std::atof(args[i].c_str());
+      MURXLA_EXIT_ERROR(options.stats_interval <= 0)
+          << "invalid argument to option '" << arg << "': " << args[i];
+    }
+    else if (arg == "--shard")
+    {
+      i += 1;
+      check_next_arg(arg, i, size);
+      std::stringstream ss(args[i]);
+      char sep = 0;
+      ss >> options.shard >> sep >> options.num_shards;
+      MURXLA_EXIT_ERROR(ss.fail() || !ss.eof() || sep != '/'
+                        || options.shard >= options.num_shards)
+          << "invalid argument to option '" << arg << "': " << args[i];
+    }
+    else if (arg == "--merge")
+    {
+      while (i + 1 < size && args[i + 1][0] != '-')
+      {
+        options.merge_dirs.push_back(args[++i]);
+      }
+      MURXLA_EXIT_ERROR(options.merge_dirs.empty())
+          << "missing argument to option '" << arg << "'";
+    }
+    else if (arg == "--coordinator")
+    {
+      i += 1;
+      check_next_arg(arg, i, size);
+      options.coordinator_address = args[i];
+    }
+    else if (arg == "--worker")
+    {
+      i += 1;
+      check_next_arg(arg, i, size);
+      options.worker_address = args[i];
+    }
+    else if (arg == "--checkpoint")
+    {
+      i += 1;
+      check_next_arg(arg, i, size);
+      options.checkpoint_interval = std::atof(args[i].c_str());
+      MURXLA_EXIT_ERROR(options.checkpoint_interval <= 0)
+          << "invalid argument to option '" << arg << "': " << args[i];
+    }
+    else if (arg == "--resume")
+    {
+      options.resume = true;
+    }
+    else if (arg == "--seeds-file")
+    {
+      i += 1;
+      check_next_arg(arg, i, size);
+      read_seeds_file(args[i], options);
+    }
+    else if (arg == "--seeds-report")
+    {
+      i += 1;
+      check_next_arg(arg, i, size);
+      options.seeds_report_filename = args[i];
+    }
+    else if (arg == "--compact-errors")
+    {
+      i += 1;
+      check_next_arg(arg, i, size);
+      options.compact_errors_filename = args[i];
+    }
     else if (arg == "--solver-trace")
     {
       options.solver_trace = true;
@@ -722,6 +1129,77 @@ parse_options(Options& options, int argc, char* argv[])
     options.solver = SOLVER_SMT2;
   }
 
+  MURXLA_EXIT_ERROR(!options.smt2_fanout.empty()
+                    && (options.solver != SOLVER_SMT2
+                        || options.solver_binary.empty()))
+      << "option --smt2-fanout requires --smt2 with a solver binary";
+
+  if (!options.coordinator_address.empty() || !options.worker_address.empty())
+  {
+    MURXLA_EXIT_ERROR(!options.coordinator_address.empty()
+                      && !options.worker_address.empty())
+        << "options --coordinator and --worker are incompatible";
+    MURXLA_EXIT_ERROR(!options.untrace_file_name.empty() || options.num_shards)
+        << "options --coordinator and --worker are incompatible with options "
+           "--untrace and --shard";
+    MURXLA_EXIT_ERROR(options.is_seeded && !options.worker_address.empty())
+        << "option --worker is incompatible with option --seed";
+  }
+
+  if (options.checkpoint_interval > 0 || options.resume)
+  {
+    MURXLA_EXIT_ERROR(options.out_dir.empty())
+        << "options --checkpoint and --resume require an output directory "
+           "(-O)";
+    MURXLA_EXIT_ERROR(options.is_seeded || !options.untrace_file_name.empty()
+                      || !options.coordinator_address.empty()
+                      || !options.worker_address.empty())
+        << "options --checkpoint and --resume are only supported for "
+           "continuous test runs";
+    filesystem::create_directories(options.out_dir);
+    if (options.checkpoint_interval == 0)
+    {
+      options.checkpoint_interval = 60;
+    }
+  }
+
+  /* The seeds given via --seeds-file are tested in continuous mode. */
+  if (!options.seeds.empty())
+  {
+    MURXLA_EXIT_ERROR(options.is_seeded || !options.untrace_file_name.empty()
+                      || options.num_shards || !options.worker_address.empty())
+        << "option --seeds-file is incompatible with options --seed, "
+           "--untrace, --shard and --worker";
+    if (options.max_runs == 0 || options.max_runs > options.seeds.size())
+    {
+      options.max_runs = static_cast<uint32_t>(options.seeds.size());
+    }
+    if (options.seeds_report_filename.empty())
+    {
+      if (!options.out_dir.empty())
+      {
+        filesystem::create_directories(options.out_dir);
+      }
+      options.seeds_report_filename =
+          prepend_path(options.out_dir, "seeds.jsonl");
+    }
+  }
+
+  /* The result bundle of a shard is its output directory. */
+  if (options.num_shards)
+  {
+    MURXLA_EXIT_ERROR(options.is_seeded || !options.untrace_file_name.empty())
+        << "option --shard is incompatible with options --seed and --untrace";
+    MURXLA_EXIT_ERROR(options.out_dir.empty())
+        << "option --shard requires an output directory (-O)";
+    filesystem::create_directories(options.out_dir);
+    if (options.error_db_filename.empty())
+    {
+      options.error_db_filename = prepend_path(options.out_dir, "errors.jsonl");
+    }
+    options.stats_bundle_filename = prepend_path(options.out_dir, "stats.json");
+  }
+
   if (options.solver == SOLVER_SMT2)
   {
     options.check_solver      = false;
@@ -750,14 +1228,29 @@ parse_options(Options& options, int argc, char* argv[])
 int
 main(int argc, char* argv[])
 {
-  statistics::Statistics* stats = initialize_statistics();
+  statistics::Statistics stats;
   SolverOptions solver_options;
   Options options;
 
   parse_options(options, argc, argv);
 
+  if (!options.compact_errors_filename.empty())
+  {
+    compact_errors(options);
+    return 0;
+  }
+
+  if (!options.merge_dirs.empty())
+  {
+    merge_bundles(options);
+    return 0;
+  }
+
   bool is_untrace    = !options.untrace_file_name.empty();
-  bool is_continuous = !options.is_seeded && !is_untrace;
+  /* With --coordinator, option --seed selects the seed sequence. */
+  bool is_continuous =
+      (!options.is_seeded || !options.coordinator_address.empty())
+      && !is_untrace;
   bool is_forked     = options.dd || is_continuous;
 
   create_tmp_directory(options.tmp_dir);
@@ -770,7 +1263,9 @@ main(int argc, char* argv[])
 
   try
   {
-    Murxla murxla(stats, options, &solver_options, &g_errors, TMP_DIR);
+    Murxla murxla(&stats, options, &solver_options, &g_errors, TMP_DIR);
+    g_stats           = &stats;
+    g_stats_file_name = options.stats_bundle_filename;
 
     if (options.print_fsm)
     {
@@ -781,7 +1276,18 @@ main(int argc, char* argv[])
     if (is_continuous)
     {
       set_sigint_handler_stats();
-      murxla.test();
+      if (!options.coordinator_address.empty())
+      {
+        murxla.coordinate();
+      }
+      else if (!options.worker_address.empty())
+      {
+        murxla.work();
+      }
+      else
+      {
+        murxla.test();
+      }
     }
     else
     {
@@ -847,15 +1353,13 @@ main(int argc, char* argv[])
   }
 
   print_error_summary();
+  write_stats_bundle();
 
   if (options.print_stats)
   {
-    stats->print();
+    stats.print();
   }
 
-  MURXLA_EXIT_ERROR(munmap(stats, sizeof(Statistics)))
-      << "failed to unmap shared memory for statistics";
-
   if (filesystem::exists(TMP_DIR))
   {
     filesystem::remove_all(TMP_DIR);
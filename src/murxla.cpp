@@ -10,15 +10,19 @@
 #include "murxla.hpp"
 
 #include <fcntl.h>
+#include <poll.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include <deque>
 #include <fstream>
 #include <iomanip>
+#include <list>
 #include <nlohmann/json.hpp>
 #include <regex>
 
+#include "connection.hpp"
 #include "dd.hpp"
 #include "except.hpp"
 #include "fs.hpp"
@@ -32,6 +36,7 @@
 #include "solver/solver_profile.hpp"
 #include "solver/yices/yices_solver.hpp"
 #include "statistics.hpp"
+#include "stats_exporter.hpp"
 #include "util.hpp"
 
 namespace murxla {
@@ -63,80 +68,155 @@ handle_abort(int sig)
 namespace {
 
 /**
- * Removes memory addresses and ==...== from ASAN messages.
+ * Removes memory addresses (0x[0-9a-fA-F]+) and ==[0-9]+== from ASAN messages.
+ *
+ * Hand-written equivalent of two passes of std::regex_replace, which is called
+ * for every error and thus on the critical path of the supervisor.
  */
 std::string
 normalize_asan_error(const std::string& s)
 {
-  std::vector<std::string> regex = {"0x[0-9a-fA-F]+", "==[0-9]+=="};
-
-  std::string res, cur_s(s);
-  for (const auto& re : regex)
+  std::string tmp;
+  tmp.reserve(s.size());
+  for (size_t i = 0, n = s.size(); i < n;)
   {
-    res.clear();
-    std::regex_replace(std::back_inserter(res),
-                       cur_s.begin(),
-                       cur_s.end(),
-                       std::regex(re),
-                       "");
-    cur_s = res;
+    if (s[i] == '0' && i + 2 < n && s[i + 1] == 'x'
+        && std::isxdigit(static_cast<unsigned char>(s[i + 2])))
+    {
+      for (i += 2; i < n && std::isxdigit(static_cast<unsigned char>(s[i]));
+           ++i)
+        ;
+      continue;
+    }
+    tmp += s[i++];
   }
 
+  std::string res;
+  res.reserve(tmp.size());
+  for (size_t i = 0, n = tmp.size(); i < n;)
+  {
+    if (tmp[i] == '=' && i + 2 < n && tmp[i + 1] == '='
+        && std::isdigit(static_cast<unsigned char>(tmp[i + 2])))
+    {
+      size_t j = i + 2;
+      for (; j < n && std::isdigit(static_cast<unsigned char>(tmp[j])); ++j)
+        ;
+      if (j + 1 < n && tmp[j] == '=' && tmp[j + 1] == '=')
+      {
+        i = j + 2;
+        continue;
+      }
+    }
+    res += tmp[i++];
+  }
   return res;
 }
 
 /**
- * Split string into tokens.
+ * Get the literal prefix of given regex, i.e., the prefix that every match of
+ * the regex starts with. Sets 'is_literal' to true if the regex does not
+ * contain any special characters.
  */
-std::vector<std::string>
-str_tokenize(const std::string& s)
-{
-  std::istringstream buf(s);
-  std::vector<std::string> ret{std::istream_iterator<std::string>(buf),
-                               std::istream_iterator<std::string>()};
-  return ret;
-}
-
-/**
- * Count the number of non-digit characters two strings differ in.
- */
-size_t
-str_diff(const std::string& s1, const std::string& s2)
+std::string
+get_regex_literal_prefix(const std::string& pattern, bool& is_literal)
 {
-  size_t diff;
-  auto t1 = str_tokenize(s1);
-  auto t2 = str_tokenize(s2);
+  static const std::string special = "^$\\.*+?()[]{}|";
+  static const std::string quantifiers = "*+?{";
 
-  if (t1.size() > t2.size())
+  is_literal = false;
+  if (pattern.find('|') != std::string::npos)
   {
-    std::swap(t1, t2);
+    /* Alternatives may not share a prefix. */
+    return "";
   }
 
-  diff = t2.size() - t1.size();
-  for (size_t i = 0; i < t1.size(); ++i)
+  std::string res;
+  for (size_t i = 0, n = pattern.size(); i < n;)
   {
-    if (t1[i] != t2[i])
+    char c;
+    size_t next;
+    if (pattern[i] == '\\')
     {
-      /* Ignore numbers for diff. */
-      for (size_t j = 0; j < t1[i].size(); ++j)
+      /* Escaped special characters are literals, escaped letters and digits
+       * are character classes or back references. */
+      if (i + 1 >= n || special.find(pattern[i + 1]) == std::string::npos
+          || pattern[i + 1] == '|')
       {
-        if (std::isdigit(t1[i][j])) continue;
-        ++diff;
+        return res;
       }
+      c    = pattern[i + 1];
+      next = i + 2;
+    }
+    else if (special.find(pattern[i]) != std::string::npos)
+    {
+      return res;
     }
+    else
+    {
+      c    = pattern[i];
+      next = i + 1;
+    }
+    if (next < n && quantifiers.find(pattern[next]) != std::string::npos)
+    {
+      /* Quantified character may not be part of the match. */
+      return res;
+    }
+    res += c;
+    i = next;
   }
-  return diff;
+  is_literal = true;
+  return res;
 }
 
-double
-error_diff(const std::string& e1, const std::string& e2)
+}  // namespace
+
+/* -------------------------------------------------------------------------- */
+
+ErrorFilter::ErrorFilter(const std::string& pattern)
 {
-  size_t len  = std::max(e1.size(), e2.size());
-  size_t diff = str_diff(e1, e2);
-  return static_cast<double>(diff) / static_cast<double>(len);
+  d_prefix = get_regex_literal_prefix(pattern, d_is_literal);
+  if (!d_is_literal)
+  {
+    try
+    {
+      d_regex = std::regex(pattern);
+    }
+    catch (std::regex_error& e)
+    {
+      MURXLA_EXIT_ERROR(true)
+          << "invalid error filter '" << pattern << "' in solver profile";
+    }
+  }
 }
 
-}  // namespace
+bool
+ErrorFilter::match(const std::string& err, std::string& match) const
+{
+  size_t pos = err.find(d_prefix);
+  if (pos == std::string::npos)
+  {
+    return false;
+  }
+  if (d_is_literal)
+  {
+    match = d_prefix;
+    return true;
+  }
+  /* A match can not start before the first occurrence of the prefix. */
+  std::smatch sm;
+  std::regex_search(err.begin() + pos,
+                    err.end(),
+                    sm,
+                    d_regex,
+                    pos > 0 ? std::regex_constants::match_prev_avail
+                            : std::regex_constants::match_default);
+  if (sm.size() == 1)
+  {
+    match = sm[0];
+    return true;
+  }
+  return false;
+}
 
 /* -------------------------------------------------------------------------- */
 
@@ -154,12 +234,17 @@ Murxla::Murxla(statistics::Statistics* stats,
   assert(stats);
   assert(solver_options);
   load_solver_profile();
+  initialize_statistics();
 
-  if (!d_options.export_errors_filename.empty())
+  if (!d_options.error_db_filename.empty())
   {
-    d_export_errors.insert(d_export_errors.end(),
-                           d_exclude_errors.begin(),
-                           d_exclude_errors.end());
+    d_error_db.reset(new ErrorDatabase(d_options.error_db_filename));
+    ErrorDatabase::Lock lock(d_error_db.get());
+    for (const auto& key : d_error_db->update(*d_errors))
+    {
+      index_error(key, d_errors->at(key));
+      d_num_indexed_errors += 1;
+    }
   }
 }
 
@@ -264,23 +349,51 @@ Murxla::test()
 {
   uint64_t num_timeouts = 0, num_printed_lines = 0;
   uint64_t error_id = 0, error_nduplicates = 0;
-  uint32_t num_runs         = 0;
+  uint64_t num_runs         = 0;
   double start_time         = get_cur_wall_time();
   std::string out_file_name = DEVNULL;
   SeedGenerator sg;
-  if (d_options.is_seeded)
+  if (d_options.num_shards)
+  {
+    sg = SeedGenerator(d_options.shard, d_options.num_shards);
+  }
+  else if (d_options.is_seeded)
   {
     sg.set_seed(d_options.seed);
   }
 
+  std::unique_ptr<std::ofstream> seeds_report = open_seeds_report();
+
+  double last_checkpoint = start_time;
+  if (d_options.resume)
+  {
+    double time = 0;
+    if (read_checkpoint(sg, num_runs, num_timeouts, time))
+    {
+      start_time -= time;
+    }
+  }
+
   std::string err_file_name = get_tmp_file_path("tmp.err", d_tmp_dir);
   Terminal term;
 
-  do
+  std::unique_ptr<statistics::Exporter> exporter;
+  if (!d_options.stats_export_filename.empty()
+      || !d_options.stats_textfile_filename.empty())
+  {
+    exporter.reset(new statistics::Exporter(d_stats,
+                                            d_options.stats_export_filename,
+                                            d_options.stats_textfile_filename,
+                                            d_options.stats_interval));
+  }
+
+  /* A campaign resumed from its checkpoint may already be done. */
+  while (d_options.max_runs == 0 || num_runs < d_options.max_runs)
   {
     double cur_time = get_cur_wall_time();
 
-    uint64_t seed = sg.next();
+    uint64_t seed =
+        d_options.seeds.empty() ? sg.next() : d_options.seeds[num_runs];
 
     if (num_printed_lines % 100 == 0)
     {
@@ -300,14 +413,15 @@ Murxla::test()
     std::cout << std::setw(16) << std::hex << seed << std::dec;
     std::cout << " " << std::setw(5) << num_runs;
     std::cout << " " << std::setw(8) << std::setprecision(2) << std::fixed;
-    std::cout << num_runs / (cur_time - start_time);
-    std::cout << " " << std::setw(5) << d_stats->d_results[Solver::Result::SAT];
+    std::cout << static_cast<double>(num_runs) / (cur_time - start_time);
+    std::cout << " " << std::setw(5)
+              << d_stats->get_num_results(Solver::Result::SAT);
     std::cout << " " << std::setw(5)
-              << d_stats->d_results[Solver::Result::UNSAT];
+              << d_stats->get_num_results(Solver::Result::UNSAT);
     std::cout << " " << std::setw(5)
-              << d_stats->d_results[Solver::Result::UNKNOWN];
+              << d_stats->get_num_results(Solver::Result::UNKNOWN);
     std::cout << " " << std::setw(5) << num_timeouts;
-    std::cout << " " << std::setw(5) << d_errors->size();
+    std::cout << " " << std::setw(5) << d_num_found_errors;
     std::cout << std::flush;
     num_runs++;
 
@@ -335,6 +449,10 @@ Murxla::test()
             true,
             // for the SMT2 offline mode we want to store all SMT2 files
             smt2_offline ? TO_FILE : NONE);
+    if (exporter)
+    {
+      exporter->inc_runs();
+    }
 
     std::string errmsg, errmsg_filtered;
     ErrorKind errkind = ErrorKind::ERROR;
@@ -392,24 +510,37 @@ Murxla::test()
           else if (errkind == ErrorKind::ERROR)
           {
             info << term.red() << "error:" << error_id;
+            if (exporter)
+            {
+              exporter->inc_errors();
+            }
           }
           else if (errkind == ErrorKind::FILTER)
           {
             info << term.gray() << "filtered";
           }
+          else if (errkind == ErrorKind::KNOWN)
+          {
+            info << term.gray() << "known:" << error_id;
+          }
           break;
         case RESULT_ERROR_CONFIG: info << term.red() << "config error"; break;
         case RESULT_ERROR_UNTRACE: info << term.red() << "untrace error"; break;
         case RESULT_TIMEOUT:
           info << term.blue() << "timeout";
           ++num_timeouts;
+          if (exporter)
+          {
+            exporter->inc_timeouts();
+          }
           break;
         default: assert(res == RESULT_UNKNOWN); info << "unknown";
       }
       info << term.defaultcolor() << "]";
 
       std::cout << info.str() << std::flush;
-      if (res == RESULT_ERROR && errkind != ErrorKind::FILTER)
+      if (res == RESULT_ERROR && errkind != ErrorKind::FILTER
+          && errkind != ErrorKind::KNOWN)
       {
         std::cout << " ";
       }
@@ -423,8 +554,11 @@ Murxla::test()
        *
        * If SMT2 solver with online solver configured, dump smt2 on replay.
        * If SMT2 solver configured without an online solver, we'll never enter
-       * here (the SMT2 solver should never return an error result). */
-      if (res != RESULT_TIMEOUT && errkind != ErrorKind::FILTER)
+       * here (the SMT2 solver should never return an error result).
+       *
+       * Errors known from the error database are not replayed. */
+      if (res != RESULT_TIMEOUT && errkind != ErrorKind::FILTER
+          && errkind != ErrorKind::KNOWN)
       {
         // No need to replay SMT2 since we already have the SMT2 problem.
         if (smt2_offline)
@@ -468,7 +602,31 @@ Murxla::test()
         os << errmsg_filtered << "\n";
       }
     }
-  } while (d_options.max_runs == 0 || num_runs < d_options.max_runs);
+
+    if (seeds_report)
+    {
+      report_seed(*seeds_report, seed, res, errkind, error_id);
+    }
+
+    /* New errors are checkpointed immediately to not be rediscovered when
+     * resuming. */
+    if (d_options.checkpoint_interval > 0)
+    {
+      double time = get_cur_wall_time();
+      if ((res == RESULT_ERROR && errkind == ErrorKind::ERROR)
+          || time - last_checkpoint >= d_options.checkpoint_interval)
+      {
+        write_checkpoint(sg, num_runs, num_timeouts, time - start_time);
+        last_checkpoint = time;
+      }
+    }
+  }
+
+  if (d_options.checkpoint_interval > 0)
+  {
+    write_checkpoint(
+        sg, num_runs, num_timeouts, get_cur_wall_time() - start_time);
+  }
 }
 
 Result
@@ -495,6 +653,401 @@ Murxla::replay(uint64_t seed,
   return res;
 }
 
+void
+Murxla::coordinate()
+{
+  /* A connected worker. */
+  struct Worker
+  {
+    std::unique_ptr<Connection> d_conn;
+    /** The job assigned to the worker, null if the worker is idle. */
+    nlohmann::json d_job;
+    /** The number of results received for the current seeds job. */
+    uint64_t d_num_results = 0;
+    /** True if the worker requested a job and none was available. */
+    bool d_waiting = false;
+  };
+
+  bool smt2_offline =
+      (d_options.solver == SOLVER_SMT2 && d_options.solver_binary.empty());
+  uint64_t max_runs = d_options.max_runs;
+  /* The seed sequence is keyed by the seed given via -s, and by a new key for
+   * each campaign otherwise, to not rerun the seeds of previous campaigns. */
+  uint64_t key = d_options.is_seeded ? d_options.seed : SeedGenerator().next();
+  /* The index of the next seed of the seed sequence to hand out. */
+  uint64_t next_seed = 0;
+  /* The seed ranges of the jobs of lost workers that were not run yet. */
+  std::deque<std::pair<uint64_t, uint64_t>> ranges;
+  /* The replays of new errors that were not assigned yet. */
+  std::deque<nlohmann::json> replays;
+  std::list<Worker> workers;
+  Terminal term;
+
+  std::unique_ptr<std::ofstream> seeds_report = open_seeds_report();
+
+  std::unique_ptr<statistics::Exporter> exporter;
+  if (!d_options.stats_export_filename.empty()
+      || !d_options.stats_textfile_filename.empty())
+  {
+    exporter.reset(new statistics::Exporter(d_stats,
+                                            d_options.stats_export_filename,
+                                            d_options.stats_textfile_filename,
+                                            d_options.stats_interval));
+  }
+
+  /* Replays are assigned first to idle workers, then seed ranges. The seeds
+   * given via --seeds-file are handed out explicitly. */
+  auto assign = [&](Worker& w) {
+    w.d_job         = nullptr;
+    w.d_num_results = 0;
+    w.d_waiting     = false;
+    if (!replays.empty())
+    {
+      w.d_job = replays.front();
+      replays.pop_front();
+    }
+    else if (!ranges.empty())
+    {
+      w.d_job = {{"type", "seeds"},
+                 {"key", key},
+                 {"start", ranges.front().first},
+                 {"count", ranges.front().second}};
+      ranges.pop_front();
+    }
+    else if (max_runs == 0 || next_seed < max_runs)
+    {
+      uint64_t count = NUM_SEEDS_PER_JOB;
+      if (max_runs > 0)
+      {
+        count = std::min(count, max_runs - next_seed);
+      }
+      w.d_job = {{"type", "seeds"},
+                 {"key", key},
+                 {"start", next_seed},
+                 {"count", count}};
+      next_seed += count;
+    }
+    else
+    {
+      w.d_waiting = true;
+      return;
+    }
+    if (w.d_job["type"] == "seeds" && !d_options.seeds.empty())
+    {
+      uint64_t start = w.d_job["start"], count = w.d_job["count"];
+      w.d_job["seeds"] =
+          std::vector<uint64_t>(d_options.seeds.begin() + start,
+                                d_options.seeds.begin() + start + count);
+    }
+    w.d_conn->send(w.d_job);
+  };
+
+  /* The unfinished part of the job of a lost worker is reassigned. */
+  auto release = [&](Worker& w) {
+    if (w.d_job.is_null()) return;
+    if (w.d_job["type"] == "replay")
+    {
+      replays.push_front(w.d_job);
+    }
+    else
+    {
+      uint64_t start = w.d_job["start"], count = w.d_job["count"];
+      if (w.d_num_results < count)
+      {
+        ranges.emplace_back(start + w.d_num_results, count - w.d_num_results);
+      }
+    }
+  };
+
+  /* Messages from workers are validated, a malformed message is ignored
+   * rather than taking down the coordinator. */
+  auto is_valid = [](const nlohmann::json& msg) {
+    const std::string& type = msg["type"];
+    if (type == "request")
+    {
+      return true;
+    }
+    if (!msg.contains("seed") || !msg["seed"].is_number_unsigned()
+        || !msg.contains("result") || !msg["result"].is_number_integer())
+    {
+      return false;
+    }
+    if (type == "replayed")
+    {
+      return msg.contains("trace") && msg["trace"].is_string();
+    }
+    if (type != "result" || !msg.contains("stats")
+        || !msg["stats"].is_object())
+    {
+      return false;
+    }
+    Result res = msg["result"];
+    if (res == RESULT_ERROR || res == RESULT_ERROR_CONFIG
+        || res == RESULT_ERROR_UNTRACE)
+    {
+      return msg.contains("error") && msg["error"].is_string()
+             && msg.contains("signal") && msg["signal"].is_number_integer();
+    }
+    return true;
+  };
+
+  auto handle = [&](Worker& w, const nlohmann::json& msg) {
+    if (!is_valid(msg))
+    {
+      MURXLA_WARN(true) << "ignoring invalid message '" << dump_json(msg)
+                        << "'";
+      return;
+    }
+    const std::string& type = msg["type"];
+    if (type == "request")
+    {
+      assign(w);
+    }
+    else if (type == "result")
+    {
+      uint64_t seed = msg["seed"];
+      Result res    = msg["result"];
+      w.d_num_results += 1;
+      try
+      {
+        d_stats->add(msg["stats"]);
+      }
+      catch (const nlohmann::json::exception& e)
+      {
+        MURXLA_WARN(true) << "ignoring invalid statistics of seed " << std::hex
+                          << seed << std::dec << ": " << e.what();
+      }
+      if (exporter)
+      {
+        exporter->inc_runs();
+      }
+      if (res == RESULT_TIMEOUT && exporter)
+      {
+        exporter->inc_timeouts();
+      }
+      if (res == RESULT_ERROR_CONFIG || res == RESULT_ERROR_UNTRACE)
+      {
+        MURXLA_CHECK_CONFIG(false) << msg["error"].get<std::string>();
+      }
+      if (res != RESULT_ERROR)
+      {
+        if (seeds_report)
+        {
+          report_seed(*seeds_report, seed, res, ErrorKind::ERROR, 0);
+        }
+        return;
+      }
+
+      ErrorKind errkind;
+      std::string errmsg;
+      uint64_t error_id, error_nduplicates;
+      d_error_signal = msg["signal"];
+      std::tie(errkind, errmsg, error_id, error_nduplicates) =
+          add_error(msg["error"], seed);
+      if (seeds_report)
+      {
+        report_seed(*seeds_report, seed, res, errkind, error_id);
+      }
+      std::cout << std::setw(16) << std::hex << seed << std::dec << " [";
+      switch (errkind)
+      {
+        case ErrorKind::DUPLICATE:
+          std::cout << term.green() << "duplicate:" << error_id;
+          break;
+        case ErrorKind::ERROR:
+          std::cout << term.red() << "error:" << error_id;
+          break;
+        case ErrorKind::FILTER: std::cout << term.gray() << "filtered"; break;
+        default:
+          assert(errkind == ErrorKind::KNOWN);
+          std::cout << term.gray() << "known:" << error_id;
+      }
+      std::cout << term.defaultcolor() << "]" << std::endl;
+
+      if (errkind == ErrorKind::ERROR)
+      {
+        std::cout << "\n" << rstrip(errmsg) << "\n" << std::endl;
+        if (exporter)
+        {
+          exporter->inc_errors();
+        }
+        /* Only new errors are replayed, on the next idle worker. */
+        if (!smt2_offline)
+        {
+          replays.push_back(
+              {{"type", "replay"}, {"seed", seed}, {"error_id", error_id}});
+        }
+      }
+    }
+    else if (type == "replayed")
+    {
+      uint64_t seed = msg["seed"];
+      std::cout << std::setw(16) << std::hex << seed << std::dec << " "
+                << msg["trace"].get<std::string>() << std::endl;
+      MURXLA_WARN(msg["result"] != RESULT_ERROR)
+          << "Replay of seed " << std::hex << seed << std::dec
+          << " did not return an error.";
+    }
+  };
+
+  int32_t listen_fd = Connection::listen(d_options.coordinator_address);
+  MURXLA_MESSAGE << "coordinator listening on '"
+                 << d_options.coordinator_address << "' (seed sequence "
+                 << std::hex << key << std::dec << ")";
+
+  while (true)
+  {
+    /* Done when all seeds were run and all new errors were replayed. */
+    if (max_runs > 0 && next_seed >= max_runs && ranges.empty()
+        && replays.empty()
+        && std::all_of(workers.begin(), workers.end(), [](const Worker& w) {
+             return w.d_job.is_null();
+           }))
+    {
+      break;
+    }
+
+    std::vector<pollfd> fds = {{listen_fd, POLLIN, 0}};
+    for (const auto& w : workers)
+    {
+      fds.push_back({w.d_conn->get_fd(), POLLIN, 0});
+    }
+    if (poll(fds.data(), fds.size(), -1) < 0)
+    {
+      MURXLA_EXIT_ERROR(errno != EINTR)
+          << "coordinator failed to poll: " << strerror(errno);
+      continue;
+    }
+
+    size_t i = 1;
+    for (auto it = workers.begin(); it != workers.end(); ++i)
+    {
+      if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+      {
+        ++it;
+        continue;
+      }
+      bool connected = it->d_conn->read();
+      nlohmann::json msg;
+      while (it->d_conn->next(msg))
+      {
+        handle(*it, msg);
+      }
+      if (connected)
+      {
+        ++it;
+        continue;
+      }
+      release(*it);
+      it = workers.erase(it);
+      MURXLA_MESSAGE << "lost worker (" << workers.size() << " connected)";
+    }
+
+    if (fds[0].revents & POLLIN)
+    {
+      std::unique_ptr<Connection> conn = Connection::accept(listen_fd);
+      if (conn)
+      {
+        workers.push_back({std::move(conn)});
+        MURXLA_MESSAGE << "new worker (" << workers.size() << " connected)";
+      }
+    }
+
+    for (auto& w : workers)
+    {
+      if (w.d_waiting)
+      {
+        assign(w);
+      }
+    }
+  }
+
+  for (auto& w : workers)
+  {
+    w.d_conn->send({{"type", "stop"}});
+  }
+  close(listen_fd);
+}
+
+void
+Murxla::work()
+{
+  std::unique_ptr<Connection> conn =
+      Connection::connect(d_options.worker_address);
+  std::string out_file_name = DEVNULL;
+  std::string err_file_name = get_tmp_file_path("tmp.err", d_tmp_dir);
+  bool smt2_offline =
+      (d_options.solver == SOLVER_SMT2 && d_options.solver_binary.empty());
+  nlohmann::json msg;
+  while (conn->send({{"type", "request"}}) && conn->receive(msg))
+  {
+    const std::string& type = msg["type"];
+    if (type == "stop")
+    {
+      return;
+    }
+
+    if (type == "seeds")
+    {
+      SeedGenerator sg(0, 1, msg["key"]);
+      sg.set_num_seeds(msg["start"]);
+      for (uint64_t i = 0, n = msg["count"]; i < n; ++i)
+      {
+        uint64_t seed = msg.contains("seeds") ? msg["seeds"][i].get<uint64_t>()
+                                              : sg.next();
+        std::string api_trace_file_name = get_api_trace_file_name(seed);
+        Result res = run(seed,
+                         d_options.time,
+                         out_file_name,
+                         err_file_name,
+                         api_trace_file_name,
+                         d_options.untrace_file_name,
+                         true,
+                         true,
+                         smt2_offline ? TO_FILE : NONE);
+
+        /* The statistics are sent as deltas since the last run. */
+        nlohmann::json result = {{"type", "result"},
+                                 {"seed", seed},
+                                 {"result", res},
+                                 {"stats", d_stats->to_json(true)}};
+        d_stats->reset();
+        if (res == RESULT_ERROR || res == RESULT_ERROR_CONFIG
+            || res == RESULT_ERROR_UNTRACE)
+        {
+          std::ifstream errs = open_input_file(err_file_name, false);
+          std::stringstream ss;
+          ss << errs.rdbuf();
+          result["error"]  = ss.str();
+          result["signal"] = d_error_signal;
+          if (res != RESULT_ERROR)
+          {
+            result["error"] = ss.str() + " " + d_error_msg;
+          }
+        }
+        conn->send(result);
+      }
+    }
+    else if (type == "replay")
+    {
+      uint64_t seed = msg["seed"];
+      std::string api_trace_file_name =
+          get_api_trace_file_name(seed, msg["error_id"]);
+      Result res = replay(seed,
+                          out_file_name,
+                          err_file_name,
+                          api_trace_file_name,
+                          d_options.untrace_file_name);
+      conn->send({{"type", "replayed"},
+                  {"seed", seed},
+                  {"result", res},
+                  {"trace", api_trace_file_name}});
+    }
+  }
+
+  MURXLA_WARN(true) << "lost connection to coordinator";
+}
+
 Solver*
 Murxla::new_solver(SolverSeedGenerator& sng,
                    const SolverKind& solver_kind,
@@ -526,7 +1079,17 @@ Murxla::new_solver(SolverSeedGenerator& sng,
   }
   else if (solver_kind == SOLVER_SMT2)
   {
-    return new smt2::Smt2Solver(sng, smt2_out, d_options.solver_binary);
+    std::vector<smt2::Smt2Process*> processes;
+    for (const auto& process : d_smt2_processes)
+    {
+      processes.push_back(process.get());
+    }
+    return new smt2::Smt2Solver(sng,
+                                smt2_out,
+                                get_smt2_solver_binaries(),
+                                d_options.smt2_pipelined,
+                                d_options.smt2_share_terms,
+                                processes);
   }
   MURXLA_CHECK(true) << "no solver created";
   return nullptr;
@@ -547,7 +1110,13 @@ Murxla::create_solver(SolverSeedGenerator& sng, std::ostream& smt2_out) const
   if (!d_options.cross_check.empty())
   {
     Solver* reference_solver = new_solver(sng, d_options.cross_check);
-    solver = new shadow::ShadowSolver(sng, solver, reference_solver);
+    /* Probabilities are in 1/10 of a percent (see MURXLA_PROB_MAX). */
+    solver = new shadow::ShadowSolver(sng,
+                                      solver,
+                                      reference_solver,
+                                      d_options.cross_check_threaded,
+                                      d_options.cross_check_lazy,
+                                      d_options.cross_check_sample * 10);
   }
 
   return solver;
@@ -562,8 +1131,9 @@ Murxla::create_fsm(RNGenerator& rng,
                    bool in_untrace_replay_mode) const
 {
   /* Dummy statistics object for the cases were we don't want to record
-   * statistics (replay, dd). */
-  statistics::Statistics dummy_stats;
+   * statistics (replay, dd). It is never allocated and thus does not count
+   * anything, but must outlive the FSM. */
+  static statistics::Statistics dummy_stats;
 
   if (!d_options.cmd_line_trace.empty())
   {
@@ -601,6 +1171,37 @@ Murxla::print_fsm() const
   fsm.print();
 }
 
+void
+Murxla::initialize_statistics()
+{
+  RNGenerator rng(0);
+  SolverSeedGenerator sng(0);
+  std::ofstream file_out = open_output_file(DEVNULL, false);
+  std::ostream out(file_out.rdbuf());
+  /* Configure as in untrace replay mode, i.e., without randomly disabling
+   * theories, to register the transitions that depend on enabled theories. */
+  FSM fsm = create_fsm(rng, sng, out, out, true, true);
+  fsm.configure();
+
+  TheorySet theories;
+  for (int32_t t = 0; t < THEORY_ALL; ++t)
+  {
+    theories.insert(static_cast<Theory>(t));
+  }
+  OpKindManager opmgr(theories,
+                      SolverManager::get_sort_kind_data(theories),
+                      {},
+                      {},
+                      false,
+                      d_stats);
+  if (!d_options.smtlib_compliant)
+  {
+    fsm.get_smgr().get_solver().configure_opmgr(&opmgr);
+  }
+
+  d_stats->allocate(d_options.stats_timing);
+}
+
 Result
 Murxla::run_aux(uint64_t seed,
                 double time,
@@ -669,7 +1270,41 @@ Murxla::run_aux(uint64_t seed,
    * seed the random generator of the solver. */
   SolverSeedGenerator sng(seed);
 
-  result = RESULT_UNKNOWN;
+  result         = RESULT_UNKNOWN;
+  d_error_signal = 0;
+
+  /* Start or replace the reused external solver processes. The run process
+   * inherits the pipes to the external solvers. */
+  if (d_options.smt2_reuse > 0 && d_options.solver == SOLVER_SMT2
+      && !d_options.solver_binary.empty())
+  {
+    if (d_smt2_processes.empty())
+    {
+      for (const auto& binary : get_smt2_solver_binaries())
+      {
+        d_smt2_processes.emplace_back(new smt2::Smt2Process(binary));
+      }
+    }
+    for (auto& process : d_smt2_processes)
+    {
+      if (process->is_running())
+      {
+        if (waitpid(process->get_pid(), nullptr, WNOHANG) != 0)
+        {
+          process->terminated();
+        }
+        else if (process->get_num_uses() >= d_options.smt2_reuse)
+        {
+          process->kill();
+        }
+      }
+      if (!process->is_running())
+      {
+        process->start();
+      }
+      process->inc_num_uses();
+    }
+  }
 
   /* If seeded, run in main process. */
   if (run_forked)
@@ -699,7 +1334,20 @@ Murxla::run_aux(uint64_t seed,
     }
 
     /* Wait for the first process to finish (pid_solver or pid_timeout). */
-    pid_t exited_pid = wait(&status);
+    pid_t exited_pid;
+    do
+    {
+      exited_pid = wait(&status);
+      /* A reused external solver process terminated. */
+      for (auto& process : d_smt2_processes)
+      {
+        if (exited_pid == process->get_pid())
+        {
+          process->terminated();
+        }
+      }
+    } while (exited_pid > 0 && exited_pid != pid_solver
+             && exited_pid != pid_timeout);
 
     if (exited_pid == pid_solver)
     {
@@ -723,7 +1371,8 @@ Murxla::run_aux(uint64_t seed,
       }
       else if (WIFSIGNALED(status))
       {
-        result = RESULT_ERROR;
+        result         = RESULT_ERROR;
+        d_error_signal = WTERMSIG(status);
       }
       if (result == RESULT_ERROR_CONFIG || result == RESULT_ERROR_UNTRACE)
       {
@@ -757,12 +1406,17 @@ Murxla::run_aux(uint64_t seed,
   else
   {
     signal(SIGINT, SIG_DFL);  // reset stats signal handler
+    /* Do not die on writes to online solvers that terminated, this is
+     * reported when reading their responses. */
+    signal(SIGPIPE, SIG_IGN);
 #ifdef MURXLA_COVERAGE
     signal(SIGABRT, handle_abort);
 #endif
 
     if (run_forked)
     {
+      statistics::Statistics::set_shard(getpid() % MURXLA_STATS_N_SHARDS);
+
       /* Redirect stdout and stderr of child process into given files. */
       fd = open(
           file_out.c_str(), O_CREAT | O_WRONLY | O_TRUNC, S_IRUSR | S_IWUSR);
@@ -826,6 +1480,19 @@ Murxla::run_aux(uint64_t seed,
     }
   }
 
+  /* Do not reuse the external solver processes after an error or timeout,
+   * their state is unknown. */
+  if (result != RESULT_OK)
+  {
+    for (auto& process : d_smt2_processes)
+    {
+      if (process->is_running())
+      {
+        process->kill();
+      }
+    }
+  }
+
   return result;
 }
 
@@ -833,19 +1500,29 @@ std::string
 Murxla::filter_error(const std::string& err)
 {
   std::string res;
-  for (const auto& re : d_error_filters)
+  for (const auto& filter : d_error_filters)
   {
-    std::smatch sm;
-    std::regex_search(err, sm, std::regex(re));
-    if (sm.size() == 1)
+    if (filter.match(err, res))
     {
-      res = sm[0];
       break;
     }
   }
   return res.empty() ? err : res;
 }
 
+void
+Murxla::index_error(const std::string& key, const ErrorInfo& info)
+{
+  if (info.signature.empty())
+  {
+    d_errors_index.add(key);
+  }
+  else
+  {
+    d_error_signatures.emplace(info.signature, key);
+  }
+}
+
 std::tuple<Murxla::ErrorKind, const std::string, uint64_t, uint64_t>
 Murxla::add_error(const std::string& err, uint64_t seed)
 {
@@ -859,44 +1536,125 @@ Murxla::add_error(const std::string& err, uint64_t seed)
     {
       return std::make_tuple(ErrorKind::FILTER, filtered_err, 0, 0);
     }
+  }
+
+  /* Errors are classified as the same error if they differ in at most 5% of
+   * characters. */
+  if (d_exclude_errors_index.find(err_norm))
+  {
+    return std::make_tuple(ErrorKind::FILTER, filtered_err, 0, 0);
+  }
 
-    /* Errors are classified as the same error if they differ in at most 5% of
-     * characters. */
-    if (error_diff(err_norm, e) <= 0.05)
+  /* Errors that were added to the error database by concurrent campaigns
+   * are added to d_errors. The database is locked until the error is
+   * recorded. */
+  ErrorDatabase::Lock lock(d_error_db.get());
+  if (d_error_db)
+  {
+    for (const auto& key : d_error_db->update(*d_errors))
     {
-      return std::make_tuple(ErrorKind::FILTER, filtered_err, 0, 0);
+      index_error(key, d_errors->at(key));
+      d_num_indexed_errors += 1;
     }
   }
 
-  for (auto& p : *d_errors)
+  /* Errors may have been added to d_errors externally. */
+  if (d_num_indexed_errors != d_errors->size())
   {
-    const auto& e_norm = p.first;
-    auto& e_info       = p.second;
+    d_errors_index.clear();
+    d_error_signatures.clear();
+    for (const auto& [e_norm, e_info] : *d_errors)
+    {
+      index_error(e_norm, e_info);
+    }
+    d_num_indexed_errors = d_errors->size();
+  }
 
-    /* Errors are classified as the same error if they differ in at most 5% of
-     * characters. */
-    if (error_diff(err_norm, e_norm) <= 0.05)
+  /* Errors with a signature (e.g., sanitizer reports and failed assertions)
+   * are classified as the same error if they have the same signature, all
+   * other errors if their messages differ in at most 5% of characters. */
+  std::string signature = get_error_signature(err, d_error_signal);
+  const std::string* e_norm = nullptr;
+  if (!signature.empty())
+  {
+    auto it = d_error_signatures.find(signature);
+    if (it != d_error_signatures.end())
     {
-      e_info.seeds.push_back(seed);
-      return std::make_tuple(
-          ErrorKind::DUPLICATE, filtered_err, e_info.id, e_info.seeds.size());
+      e_norm = &it->second;
     }
   }
+  else
+  {
+    e_norm = d_errors_index.find(err_norm);
+  }
 
-  d_errors->emplace(err_norm,
-                    ErrorInfo(d_errors->size() + 1, filtered_err, {seed}));
+  if (e_norm)
+  {
+    auto& e_info = d_errors->at(*e_norm);
+    e_info.seeds.push_back(seed);
+    if (e_info.known && e_info.seeds.size() == 1)
+    {
+      d_num_found_errors += 1;
+    }
+    if (d_error_db)
+    {
+      d_error_db->add(*e_norm, e_info, seed);
+    }
+    return std::make_tuple(
+        e_info.known ? ErrorKind::KNOWN : ErrorKind::DUPLICATE,
+        filtered_err,
+        e_info.id,
+        e_info.seeds.size());
+  }
+
+  /* Distinct errors with the same message are distinguished by signature.
+   * Errors with a signature are not in the text index, an error without
+   * signature may thus also have the same message as a known error. */
+  std::string key =
+      ErrorDatabase::get_unique_key(*d_errors, err_norm, signature);
+  uint64_t id         = d_errors->size() + 1;
+  auto [it, inserted] = d_errors->emplace(
+      key, ErrorInfo(id, filtered_err, {seed}, signature));
+  assert(inserted);
+  d_num_found_errors += 1;
+  index_error(key, it->second);
+  if (d_error_db)
+  {
+    d_error_db->add(key, it->second, seed);
+  }
+  d_num_indexed_errors = d_errors->size();
 
-  // Export errors to JSON file.
   if (!d_options.export_errors_filename.empty())
   {
-    d_export_errors.push_back(filtered_err);
-    nlohmann::json j;
-    j["errors"]["exclude"] = d_export_errors;
-    std::ofstream o(d_options.export_errors_filename);
-    o << std::setw(2) << j << std::endl;
+    export_error(id, filtered_err, signature, seed);
   }
 
-  return std::make_tuple(ErrorKind::ERROR, filtered_err, d_errors->size(), 1);
+  return std::make_tuple(ErrorKind::ERROR, filtered_err, id, 1);
+}
+
+void
+Murxla::export_error(uint64_t id,
+                     const std::string& errmsg,
+                     const std::string& signature,
+                     uint64_t seed) const
+{
+  nlohmann::json j = ErrorDatabase::make_record(
+      id, errmsg, signature, seed, get_cur_utc_time());
+
+  std::string record = dump_json(j) + "\n";
+
+  /* Records are appended with a single write to a file opened in append mode,
+   * which is atomic with respect to concurrent writers and readers. */
+  int32_t fd = open(d_options.export_errors_filename.c_str(),
+                    O_CREAT | O_WRONLY | O_APPEND,
+                    S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+  MURXLA_EXIT_ERROR(fd < 0) << "unable to open file '"
+                            << d_options.export_errors_filename << "'";
+  ssize_t n = write(fd, record.c_str(), record.size());
+  close(fd);
+  MURXLA_EXIT_ERROR(n != static_cast<ssize_t>(record.size()))
+      << "unable to write to file '" << d_options.export_errors_filename
+      << "'";
 }
 
 void
@@ -920,9 +1678,28 @@ Murxla::load_solver_profile()
   d_solver_profile.reset(new SolverProfile(profile));
   auto errors = d_solver_profile->get_excluded_errors();
   d_exclude_errors.insert(errors.begin(), errors.end());
-  auto error_filters = d_solver_profile->get_error_filters();
-  d_error_filters.insert(
-      d_error_filters.end(), error_filters.begin(), error_filters.end());
+  d_exclude_errors_index.clear();
+  for (const auto& e : d_exclude_errors)
+  {
+    d_exclude_errors_index.add(e);
+  }
+  for (const auto& filter : d_solver_profile->get_error_filters())
+  {
+    d_error_filters.emplace_back(filter);
+  }
+}
+
+std::vector<std::string>
+Murxla::get_smt2_solver_binaries() const
+{
+  std::vector<std::string> res;
+  if (!d_options.solver_binary.empty())
+  {
+    res.push_back(d_options.solver_binary);
+    res.insert(
+        res.end(), d_options.smt2_fanout.begin(), d_options.smt2_fanout.end());
+  }
+  return res;
 }
 
 std::string
@@ -988,6 +1765,159 @@ Murxla::get_api_trace_file_name(uint64_t seed, uint64_t error_id) const
   return api_trace_file_name;
 }
 
+std::unique_ptr<std::ofstream>
+Murxla::open_seeds_report() const
+{
+  if (d_options.seeds_report_filename.empty())
+  {
+    return nullptr;
+  }
+  auto res = std::make_unique<std::ofstream>(
+      d_options.seeds_report_filename,
+      d_options.resume ? std::ofstream::app : std::ofstream::trunc);
+  MURXLA_EXIT_ERROR(!res->is_open())
+      << "unable to open output file '" << d_options.seeds_report_filename
+      << "'";
+  return res;
+}
+
+void
+Murxla::report_seed(std::ostream& report,
+                    uint64_t seed,
+                    Result res,
+                    ErrorKind errkind,
+                    uint64_t error_id)
+{
+  std::stringstream ss_seed, ss_res;
+  ss_seed << std::hex << seed;
+  ss_res << res;
+
+  nlohmann::json j;
+  j["seed"]   = ss_seed.str();
+  j["result"] = ss_res.str();
+  if (res == RESULT_ERROR)
+  {
+    switch (errkind)
+    {
+      case ErrorKind::DUPLICATE: j["error"] = "duplicate"; break;
+      case ErrorKind::ERROR: j["error"] = "new"; break;
+      case ErrorKind::FILTER: j["error"] = "filtered"; break;
+      default: assert(errkind == ErrorKind::KNOWN); j["error"] = "known";
+    }
+    if (errkind != ErrorKind::FILTER)
+    {
+      j["error_id"] = error_id;
+    }
+  }
+  report << j.dump() << std::endl;
+}
+
+void
+Murxla::write_checkpoint(const SeedGenerator& sg,
+                         uint64_t num_runs,
+                         uint64_t num_timeouts,
+                         double time) const
+{
+  nlohmann::json j;
+  j["shard"]     = {d_options.shard, d_options.num_shards};
+  j["seed"]      = sg.get_seed();
+  j["num_seeds"] = sg.get_num_seeds();
+  j["runs"]      = num_runs;
+  j["timeouts"]  = num_timeouts;
+  j["time"]      = time;
+  j["errors"]    = nlohmann::json::array();
+  for (const auto& [key, info] : *d_errors)
+  {
+    j["errors"].push_back({{"key", key},
+                           {"id", info.id},
+                           {"message", info.errmsg},
+                           {"signature", info.signature},
+                           {"seeds", info.seeds},
+                           {"known", info.known},
+                           {"num_recorded", info.num_recorded},
+                           {"first_seen", info.first_seen},
+                           {"last_seen", info.last_seen}});
+  }
+  j["stats"] = d_stats->to_json();
+
+  std::string file_name = prepend_path(d_options.out_dir, CHECKPOINT_FILE);
+
+  std::string tmp_file_name = file_name + ".tmp";
+  {
+    std::ofstream out = open_output_file(tmp_file_name, false);
+    out << dump_json(j) << std::endl;
+  }
+  std::rename(tmp_file_name.c_str(), file_name.c_str());
+}
+
+bool
+Murxla::read_checkpoint(SeedGenerator& sg,
+                        uint64_t& num_runs,
+                        uint64_t& num_timeouts,
+                        double& time)
+{
+  std::string file_name = prepend_path(d_options.out_dir, CHECKPOINT_FILE);
+  std::ifstream file(file_name);
+  if (!file.is_open())
+  {
+    MURXLA_WARN(true) << "no checkpoint found in '" << d_options.out_dir
+                      << "', starting a new campaign";
+    return false;
+  }
+
+  try
+  {
+    nlohmann::json j = nlohmann::json::parse(file);
+    MURXLA_EXIT_ERROR(j.at("shard").at(0) != d_options.shard
+                      || j.at("shard").at(1) != d_options.num_shards)
+        << "checkpoint '" << file_name
+        << "' was written for a different shard";
+
+    if (d_options.num_shards)
+    {
+      sg.set_num_seeds(j.at("num_seeds"));
+    }
+    else
+    {
+      sg.set_seed(j.at("seed"));
+    }
+    num_runs     = j.at("runs");
+    num_timeouts = j.at("timeouts");
+    time         = j.at("time");
+
+    for (const auto& e : j.at("errors"))
+    {
+      /* Errors loaded from the error database are merged. */
+      auto [it, inserted] = d_errors->emplace(
+          e.at("key"),
+          ErrorInfo(e.at("id"), e.at("message"), {}, e.at("signature")));
+      ErrorInfo& info = it->second;
+      info.seeds      = e.at("seeds").get<std::vector<uint64_t>>();
+      if (inserted)
+      {
+        info.known        = e.at("known");
+        info.num_recorded = e.at("num_recorded");
+        info.first_seen   = e.at("first_seen");
+        info.last_seen    = e.at("last_seen");
+      }
+      if (!info.seeds.empty())
+      {
+        d_num_found_errors += 1;
+      }
+    }
+    d_stats->add(j.at("stats"));
+  }
+  catch (nlohmann::json::exception& e)
+  {
+    MURXLA_EXIT_ERROR(true) << "invalid checkpoint '" << file_name
+                            << "': " << e.what();
+  }
+
+  MURXLA_MESSAGE << "resuming campaign after " << num_runs << " runs with "
+                 << d_num_found_errors << " errors";
+  return true;
+}
+
 /* -------------------------------------------------------------------------- */
 
 }  // namespace murxla
@@ -11,11 +11,16 @@
 #define __MURXLA__MURXLA_H
 
 #include <cstdint>
+#include <fstream>
+#include <regex>
 #include <string>
 
 #include "action.hpp"
+#include "error_db.hpp"
+#include "error_index.hpp"
 #include "options.hpp"
 #include "result.hpp"
+#include "solver/smt2/smt2_process.hpp"
 #include "solver/solver_profile.hpp"
 #include "solver_option.hpp"
 #include "theory.hpp"
@@ -25,28 +30,48 @@ namespace murxla {
 /* -------------------------------------------------------------------------- */
 
 namespace statistics {
-struct Statistics;
+class Statistics;
 };
 class Solver;
 
 /* -------------------------------------------------------------------------- */
 
-struct ErrorInfo
+/**
+ * An error filter regex of the solver profile (see
+ * SolverProfile::get_error_filters()), compiled once when the solver profile
+ * is loaded.
+ *
+ * The regex is only searched for if the error message contains the literal
+ * prefix of the filter (e.g., "Fatal failure within " for filter
+ * "Fatal failure within [\S\s]+"), and not at all for filters without
+ * special characters.
+ */
+class ErrorFilter
 {
-  ErrorInfo(uint64_t id,
-            const std::string& errmsg,
-            const std::vector<uint64_t>& seeds)
-      : id(id), errmsg(errmsg), seeds(seeds){};
-
-  uint64_t id;
-  std::string errmsg;
-  std::vector<uint64_t> seeds;
+ public:
+  /** Constructor, exits with an error if 'pattern' is not a valid regex. */
+  ErrorFilter(const std::string& pattern);
+  /**
+   * Match filter against given error message.
+   * err  : The error message.
+   * match: Set to the part of 'err' that matches the filter on success.
+   * Returns true if the filter matches.
+   */
+  bool match(const std::string& err, std::string& match) const;
+
+ private:
+  /** The literal prefix of the filter. */
+  std::string d_prefix;
+  /** True if the filter does not contain any special characters. */
+  bool d_is_literal = false;
+  /** The compiled filter, if not literal. */
+  std::regex d_regex;
 };
 
 class Murxla
 {
  public:
-  using ErrorMap = std::unordered_map<std::string, ErrorInfo>;
+  using ErrorMap = ErrorDatabase::ErrorMap;
 
   enum TraceMode
   {
@@ -57,6 +82,9 @@ class Murxla
 
   inline static const std::string API_TRACE = "tmp-api.trace";
   inline static const std::string SMT2_FILE = "tmp-smt2.smt2";
+  inline static const std::string CHECKPOINT_FILE = "checkpoint.json";
+  /** The number of seeds handed out to a worker at once, see coordinate(). */
+  inline static const uint64_t NUM_SEEDS_PER_JOB = 16;
 
   /** Constructor. */
   Murxla(statistics::Statistics* stats,
@@ -99,6 +127,26 @@ class Murxla
   /** Continuous test run. */
   void test();
 
+  /**
+   * Coordinate a continuous test run that is distributed over workers (see
+   * work()) connecting to d_options.coordinator_address.
+   *
+   * The coordinator hands out ranges of the seed sequence of a single shard
+   * (see SeedGenerator) to workers that request a job, deduplicates the
+   * errors reported by the workers globally (see add_error()) and assigns
+   * the replay (and delta debugging, if enabled) of each new error to the
+   * next idle worker. The jobs of lost workers are reassigned.
+   * With a limit on the number of runs, stops when all runs are done and all
+   * new errors are replayed.
+   */
+  void coordinate();
+  /**
+   * Work on the jobs handed out by the coordinator at
+   * d_options.worker_address (see coordinate()) until it stops.
+   * Reports the result and the statistics of each run.
+   */
+  void work();
+
   /** Print the current configuration of the FSM to stdout. */
   void print_fsm() const;
 
@@ -125,6 +173,11 @@ class Murxla
    * forked.
    */
   std::string d_error_msg;
+  /**
+   * The signal that terminated the solver process of the last run, 0 if it
+   * was not terminated by a signal.
+   */
+  int32_t d_error_signal = 0;
 
  private:
   enum class ErrorKind
@@ -132,6 +185,7 @@ class Murxla
     DUPLICATE, /* Error message is a duplicate since it was already reported. */
     ERROR,     /* Error message is new. */
     FILTER,    /* Error message filtered out. */
+    KNOWN,     /* Error message is known from the error database. */
   };
 
   /**
@@ -217,13 +271,86 @@ class Murxla
   /** Filter error messages based on filter regex provided in solver profile. */
   std::string filter_error(const std::string& err);
 
+  /**
+   * Append a record of a new error to the JSON Lines file given via
+   * --export-errors.
+   * id       : The id of the error.
+   * errmsg   : The (filtered) error message.
+   * signature: The signature of the error, see get_error_signature().
+   * seed     : The seed of the run that triggered the error.
+   */
+  void export_error(uint64_t id,
+                    const std::string& errmsg,
+                    const std::string& signature,
+                    uint64_t seed) const;
+
+  /** Add error with given key to the indices of d_errors. */
+  void index_error(const std::string& key, const ErrorInfo& info);
+
   /** Register error to d_errors. */
   std::tuple<Murxla::ErrorKind, const std::string, uint64_t, uint64_t>
   add_error(const std::string& err, uint64_t seed);
 
+  /**
+   * Write a checkpoint of the state of a continuous test run to
+   * CHECKPOINT_FILE in the output directory, replacing the previous one.
+   * The state consists of the errors (with their seeds), the statistics,
+   * the position of the seed generator, the number of runs and timeouts, and
+   * the elapsed time.
+   * sg          : The seed generator of the test run.
+   * num_runs    : The number of runs.
+   * num_timeouts: The number of runs that timed out.
+   * time        : The elapsed time in seconds.
+   */
+  void write_checkpoint(const SeedGenerator& sg,
+                        uint64_t num_runs,
+                        uint64_t num_timeouts,
+                        double time) const;
+  /**
+   * Restore the state of a continuous test run from the checkpoint in the
+   * output directory, see write_checkpoint(). Errors and statistics are
+   * restored into d_errors and d_stats.
+   * Returns false if there is no checkpoint.
+   */
+  bool read_checkpoint(SeedGenerator& sg,
+                       uint64_t& num_runs,
+                       uint64_t& num_timeouts,
+                       double& time);
+
+  /**
+   * Open the report of the results of the seeds given via --seeds-file, if
+   * enabled. The report is appended to when resuming.
+   */
+  std::unique_ptr<std::ofstream> open_seeds_report() const;
+  /**
+   * Append the result of the run with given seed to given report of the
+   * seeds given via --seeds-file, in JSON Lines format.
+   * errkind : The kind of the error if 'res' is RESULT_ERROR.
+   * error_id: The id of the error if 'res' is RESULT_ERROR.
+   */
+  static void report_seed(std::ostream& report,
+                          uint64_t seed,
+                          Result res,
+                          ErrorKind errkind,
+                          uint64_t error_id);
+
   /** Load solver profile of currently configured solver. */
   void load_solver_profile();
 
+  /**
+   * Register the kinds of all states, actions, transitions and operators of
+   * the currently configured solver with d_stats and allocate its counters.
+   * Test runs may enable a random subset of theories, operators are thus
+   * registered for all theories.
+   */
+  void initialize_statistics();
+
+  /**
+   * Get the solver binaries to pass the SMT-LIB output to when --smt2 is
+   * enabled: the solver binary and the binaries given via --smt2-fanout.
+   */
+  std::vector<std::string> get_smt2_solver_binaries() const;
+
   std::string get_smt2_file_name(uint64_t seed,
                                  const std::string& untrace_file_name) const;
 
@@ -235,13 +362,36 @@ class Murxla
   /** Map normalized error message to pair (original error message, seeds). */
   ErrorMap* d_errors;
 
+  /**
+   * Index of the normalized error messages of the errors in d_errors that do
+   * not have a signature.
+   */
+  ErrorIndex d_errors_index;
+  /** Map error signatures to the errors in d_errors with that signature. */
+  std::unordered_map<std::string, std::string> d_error_signatures;
+  /** The number of errors in d_errors that are indexed. */
+  size_t d_num_indexed_errors = 0;
+  /**
+   * The number of errors in d_errors that were encountered by this process,
+   * i.e., excluding the errors that were only loaded from the error database.
+   */
+  size_t d_num_found_errors = 0;
+  /** The error database, if enabled via --error-db. */
+  std::unique_ptr<ErrorDatabase> d_error_db;
+
   std::unordered_set<std::string> d_exclude_errors;
-  std::vector<std::string> d_error_filters;
+  /** Index of the errors in d_exclude_errors. */
+  ErrorIndex d_exclude_errors_index;
+  std::vector<ErrorFilter> d_error_filters;
 
   std::unique_ptr<SolverProfile> d_solver_profile;
 
-  /** Stores error messages to be exported when --export-errors is enabled. */
-  std::vector<std::string> d_export_errors;
+  /**
+   * The external solver processes (one per solver binary) that are reused
+   * across runs when --smt2-reuse is enabled. Started and collected by this
+   * (the supervisor) process, and inherited by the run processes.
+   */
+  std::vector<std::unique_ptr<smt2::Smt2Process>> d_smt2_processes;
 };
 
 /* -------------------------------------------------------------------------- */
@@ -36,10 +36,6 @@ Op::Op(uint64_t id,
       d_theory(theory),
       d_sort_kinds_args(sort_kinds_args)
 {
-  MURXLA_CHECK_CONFIG(kind.size() <= MURXLA_MAX_KIND_LEN)
-      << "'" << kind
-      << "' exceeds maximum length for operator kinds, increase limit by "
-         "adjusting value of macro MURXLA_MAX_KIND_LEN in config.hpp";
 }
 
 bool
@@ -457,13 +453,7 @@ OpKindManager::add_op_kind(const Op::Kind& kind,
     return;
   }
 
-  uint64_t id = d_op_kinds.size();
-  if (id >= MURXLA_MAX_N_OPS)
-  {
-    throw MurxlaException(
-        "maximum number of operators exceeded, increase limit by adjusting "
-        "value of macro MURXLA_MAX_N_OPS in config.hpp");
-  }
+  uint64_t id = d_stats->register_op(kind);
 
   SortKindSet exclude_sort_kinds;
   const auto& it = d_unsupported_op_kind_sorts.find(kind);
@@ -497,7 +487,6 @@ OpKindManager::add_op_kind(const Op::Kind& kind,
   }
   d_op_kinds.emplace(
       kind, Op(id, kind, arity, nidxs, sort_kinds, sort_kinds_args, theory));
-  strncpy(d_stats->d_op_kinds[id], kind.c_str(), kind.size());
 }
 
 /* -------------------------------------------------------------------------- */
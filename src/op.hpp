@@ -20,7 +20,7 @@
 namespace murxla {
 
 namespace statistics {
-struct Statistics;
+class Statistics;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -3278,7 +3278,10 @@ struct Op
    */
   SortKindSet get_arg_sort_kind(size_t i) const;
 
-  /** The operator id, assigned in the order operators have been created. */
+  /**
+   * The operator id, assigned in the order operator kinds have been
+   * registered with the statistics (see statistics::Statistics::register_op()).
+   */
   uint64_t d_id = 0u;
   /** The operator kind. */
   const Kind& d_kind = UNDEFINED;
@@ -13,6 +13,7 @@
 #include <cstdint>
 #include <nlohmann/json.hpp>
 #include <string>
+#include <vector>
 
 #include "theory.hpp"
 
@@ -44,6 +45,8 @@ struct Options
   bool smtlib_compliant = false;
   /** True to print statistics. */
   bool print_stats = false;
+  /** True to record (and print) latency histograms of actions and ops. */
+  bool stats_timing = false;
   /** True to print FSM configuration. */
   bool print_fsm = false;
   /** Restrict arithmetic operators to linear fragment. */
@@ -61,6 +64,30 @@ struct Options
   SolverKind solver;
   /** The path to the solver binary to test when --smt2 is enabled. */
   std::string solver_binary;
+  /**
+   * True if commands should be pipelined to the solver binary when --smt2 is
+   * enabled, i.e., 'success' responses are only checked on commands with
+   * other responses (check-sat, get-value, ...).
+   */
+  bool smt2_pipelined = false;
+  /**
+   * Additional solver binaries to pass the SMT-LIB output to when --smt2 is
+   * enabled with a solver binary (fan-out mode). Their responses are compared
+   * against each other.
+   */
+  std::vector<std::string> smt2_fanout;
+  /**
+   * True if shared subterms should be defined globally via define-fun when
+   * --smt2 is enabled, instead of being printed again for each command.
+   */
+  bool smt2_share_terms = false;
+  /**
+   * The maximum number of runs an external solver process is reused for
+   * when --smt2 is enabled with a solver binary, 0 to start a new process
+   * for each run. A reused process is cleaned up via '(reset)' after each run
+   * and replaced after an error or timeout.
+   */
+  uint32_t smt2_reuse = 0;
   /** The file to trace the API call sequence to. */
   std::string api_trace_file_name;
   /** The API trace file to replay. */
@@ -92,9 +119,29 @@ struct Options
   std::string dd_match_err;
   /** The file to write the reduced API trace to. */
   std::string dd_trace_file_name;
+  /**
+   * True if delta debugging should be resumed from the checkpoint of a
+   * previous (interrupted) delta debugging session.
+   */
+  bool dd_resume = false;
 
   /** The name of the solver to cross-check given solver with. */
   std::string cross_check;
+  /**
+   * True if the cross-check solver should be run on a separate thread,
+   * concurrently to the solver under test.
+   */
+  bool cross_check_threaded = false;
+  /**
+   * True if calls into the cross-check solver should be recorded and only be
+   * executed when the results of the two solvers are compared.
+   */
+  bool cross_check_lazy = false;
+  /**
+   * The percentage of check-sat calls to cross-check. Implies
+   * cross_check_lazy if less than 100.
+   */
+  uint32_t cross_check_sample = 100;
 
   /** The name of the solver to use for checking. */
   std::string check_solver_name;
@@ -115,8 +162,50 @@ struct Options
   /** Solver profile filename. */
   std::string solver_profile_filename;
 
-  /** Output file for exporting errors in JSON format. */
+  /** Output file for exporting errors in JSON Lines format. */
   std::string export_errors_filename = "";
+  /** The error database shared by campaigns. */
+  std::string error_db_filename = "";
+  /** JSON Lines error export to compact into solver profile format. */
+  std::string compact_errors_filename = "";
+
+  /** Output file for periodically exporting statistics. */
+  std::string stats_export_filename = "";
+  /** Node exporter text file for periodically exporting statistics. */
+  std::string stats_textfile_filename = "";
+  /** The interval between statistics exports in seconds. */
+  double stats_interval = 60;
+
+  /**
+   * The shard of the seed space to test and the number of shards, 0 if the
+   * seed space is not sharded.
+   */
+  uint32_t shard      = 0;
+  uint32_t num_shards = 0;
+  /** Output file for the statistics of the result bundle of a shard. */
+  std::string stats_bundle_filename = "";
+  /** The result bundle directories of shards to merge. */
+  std::vector<std::string> merge_dirs;
+
+  /**
+   * The address to listen on as the coordinator and to connect to as a
+   * worker of a distributed campaign, respectively.
+   */
+  std::string coordinator_address = "";
+  std::string worker_address      = "";
+
+  /**
+   * The interval between checkpoints of the state of a continuous test run
+   * in seconds, 0 if disabled.
+   */
+  double checkpoint_interval = 0;
+  /** Resume a continuous test run from its last checkpoint. */
+  bool resume = false;
+
+  /** The seeds to test instead of random seeds (see --seeds-file). */
+  std::vector<uint64_t> seeds;
+  /** Output file for the results of the seeds given via --seeds-file. */
+  std::string seeds_report_filename = "";
 
   /** Print native solver API trace. */
   bool solver_trace = false;
@@ -21,13 +21,28 @@
 
 /* -------------------------------------------------------------------------- */
 
-#define MURXLA_PROB_MAX 1000 /* Maximum probability 100% = 1000. */
+namespace murxla {
 
 /* -------------------------------------------------------------------------- */
 
-namespace murxla {
+namespace {
 
-/* -------------------------------------------------------------------------- */
+/** The finalizer of splitmix64, a bijection on 64-bit integers. */
+uint64_t
+mix64(uint64_t z)
+{
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+}  // namespace
+
+SeedGenerator::SeedGenerator(uint32_t shard, uint32_t num_shards, uint64_t key)
+    : d_shard(shard), d_num_shards(num_shards), d_key(mix64(key))
+{
+  assert(shard < num_shards);
+}
 
 void
 SeedGenerator::set_seed(uint64_t s)
@@ -38,6 +53,14 @@ SeedGenerator::set_seed(uint64_t s)
 uint64_t
 SeedGenerator::next()
 {
+  if (d_num_shards)
+  {
+    /* The n-th output of splitmix64, a bijection on 64-bit integers. The
+     * hashed key (0 for key 0) selects a sequence. */
+    uint64_t n = (d_num_seeds++ * d_num_shards + d_shard) ^ d_key;
+    return mix64((n + 1) * 0x9e3779b97f4a7c15);
+  }
+
   uint64_t cur_seed;
   cur_seed = d_seed;
   d_seed   = getpid();
@@ -16,6 +16,12 @@
 #include <unordered_map>
 #include <vector>
 
+/* -------------------------------------------------------------------------- */
+
+#define MURXLA_PROB_MAX 1000 /* Maximum probability 100% = 1000. */
+
+/* -------------------------------------------------------------------------- */
+
 namespace murxla {
 
 /* -------------------------------------------------------------------------- */
@@ -27,6 +33,19 @@ class SeedGenerator
   SeedGenerator() { next(); }
   /** Default Constructor. Starts from given seed. */
   explicit SeedGenerator(uint64_t s) : d_seed(s) {}
+  /**
+   * Constructor for shard 'shard' of 'num_shards' shards of the seed space.
+   *
+   * The seeds of a shard are a deterministic sequence that does not depend
+   * on the process or the time, and the sequences of different shards are
+   * disjoint: the n-th seed of shard i is a bijective hash of
+   * n * num_shards + i.
+   *
+   * If a nonzero 'key' is given, it is mixed into the hash, which yields a
+   * different sequence (with overwhelming probability disjoint from the
+   * sequence of any other key) for each key.
+   */
+  SeedGenerator(uint32_t shard, uint32_t num_shards, uint64_t key = 0);
 
   /** Set seed. */
   void set_seed(uint64_t s);
@@ -34,9 +53,30 @@ class SeedGenerator
   /** Generate and return the next seed. */
   uint64_t next();
 
+  /** Get the next seed (if not sharded). */
+  uint64_t get_seed() const { return d_seed; }
+  /** Get the number of seeds generated (if sharded). */
+  uint64_t get_num_seeds() const { return d_num_seeds; }
+  /**
+   * Skip to the n-th seed of the sequence of a shard, i.e., the next seed is
+   * the seed at index 'n'.
+   */
+  void set_num_seeds(uint64_t n)
+  {
+    assert(d_num_shards);
+    d_num_seeds = n;
+  }
+
  private:
   /** The current seed. */
   uint64_t d_seed = 0;
+  /** The shard and the number of shards, 0 if not sharded. */
+  uint32_t d_shard      = 0;
+  uint32_t d_num_shards = 0;
+  /** The number of seeds generated in sharded mode. */
+  uint64_t d_num_seeds = 0;
+  /** The hashed key of the sequence in sharded mode. */
+  uint64_t d_key = 0;
 };
 
 /* -------------------------------------------------------------------------- */
@@ -9,10 +9,25 @@
  */
 #include "check_solver.hpp"
 
+#include <numeric>
+
 namespace murxla {
 
 using namespace shadow;
 
+namespace {
+
+/** Get the term of the solver under test of given ShadowTerm. */
+Term
+get_term_orig(const Term& term)
+{
+  ShadowTerm* t = checked_cast<ShadowTerm*>(term.get());
+  assert(t);
+  return t->get_term();
+}
+
+}  // namespace
+
 CheckSolver::CheckSolver(SolverSeedGenerator& sng,
                          Solver* solver,
                          Solver* solver_check)
@@ -29,9 +44,71 @@ CheckSolver::delete_solver()
   d_assertions.clear();
   d_assumptions.clear();
   d_assumptions_shadow.clear();
+  d_evaluator.clear();
   ShadowSolver::delete_solver();
 }
 
+Term
+CheckSolver::mk_const(Sort sort, const std::string& name)
+{
+  Term res = ShadowSolver::mk_const(sort, name);
+  d_evaluator.add_const(get_term_orig(res), sort);
+  return res;
+}
+
+Term
+CheckSolver::mk_value(Sort sort, bool value)
+{
+  Term res = ShadowSolver::mk_value(sort, value);
+  d_evaluator.add_value(get_term_orig(res), sort, value);
+  return res;
+}
+
+Term
+CheckSolver::mk_value(Sort sort, const std::string& value)
+{
+  Term res = ShadowSolver::mk_value(sort, value);
+  d_evaluator.add_value(get_term_orig(res), sort, value);
+  return res;
+}
+
+Term
+CheckSolver::mk_value(Sort sort, const std::string& num, const std::string& den)
+{
+  Term res = ShadowSolver::mk_value(sort, num, den);
+  d_evaluator.add_value(get_term_orig(res), sort, num, den);
+  return res;
+}
+
+Term
+CheckSolver::mk_value(Sort sort, const std::string& value, Base base)
+{
+  Term res = ShadowSolver::mk_value(sort, value, base);
+  d_evaluator.add_value(get_term_orig(res), sort, value, base);
+  return res;
+}
+
+Term
+CheckSolver::mk_special_value(Sort sort,
+                              const AbsTerm::SpecialValueKind& value)
+{
+  Term res = ShadowSolver::mk_special_value(sort, value);
+  d_evaluator.add_special_value(get_term_orig(res), sort, value);
+  return res;
+}
+
+Term
+CheckSolver::mk_term(const Op::Kind& kind,
+                     const std::vector<Term>& args,
+                     const std::vector<uint32_t>& indices)
+{
+  Term res = ShadowSolver::mk_term(kind, args, indices);
+  std::vector<Term> args_orig, args_shadow;
+  get_terms_helper(args, args_orig, args_shadow);
+  d_evaluator.add_term(get_term_orig(res), kind, args_orig, indices);
+  return res;
+}
+
 bool
 CheckSolver::option_unsat_cores_enabled() const
 {
@@ -144,16 +221,66 @@ CheckSolver::get_value(const std::vector<Term>& terms)
 {
   std::vector<Term> res, terms_orig, terms_shadow;
   get_terms_helper(terms, terms_orig, terms_shadow);
-  auto values_orig = d_solver->get_value(terms_orig);
 
-  /* Check values with d_shadow. */
-  if (d_incremental)
+  size_t n_terms           = terms_orig.size();
+  std::vector<Term> values = d_solver->get_value(terms_orig);
+  MURXLA_TEST(values.size() == n_terms);
+
+  /* The indices of the terms whose values could not be verified by the
+   * evaluator. */
+  std::vector<size_t> unverified;
+
+  /* Check values by evaluating the terms under the model of d_solver, if
+   * supported by the evaluator. */
+  if (d_evaluator.is_supported(terms_orig))
+  {
+    /* The values of the constants are queried in a separate call to not
+     * alter the get-value query of the solver under test. */
+    std::vector<Term> consts = d_evaluator.get_consts(terms_orig);
+    std::vector<Term> values_consts;
+    if (!consts.empty())
+    {
+      values_consts = d_solver->get_value(consts);
+      MURXLA_TEST(values_consts.size() == consts.size());
+    }
+    bool has_model = d_evaluator.set_model(consts, values_consts);
+    for (size_t i = 0; i < n_terms; ++i)
+    {
+      std::optional<GroundEvaluator::Value> expected, value;
+      if (has_model)
+      {
+        expected = d_evaluator.evaluate(terms_orig[i]);
+      }
+      if (expected)
+      {
+        value =
+            GroundEvaluator::parse_value(values[i]->to_string(), *expected);
+      }
+      if (!value)
+      {
+        unverified.push_back(i);
+        continue;
+      }
+      MURXLA_TEST(*value == *expected)
+          << "value " << value->to_string() << " of term "
+          << terms_orig[i]->to_string() << " does not match its value "
+          << expected->to_string() << " under the model";
+    }
+  }
+  else
+  {
+    unverified.resize(n_terms);
+    std::iota(unverified.begin(), unverified.end(), 0);
+  }
+
+  /* Check the values that could not be verified with d_solver. */
+  if (d_incremental && !unverified.empty())
   {
     std::vector<Term> assumptions;
-    for (size_t i = 0, n = terms_orig.size(); i < n; ++i)
+    for (size_t i : unverified)
     {
       assumptions.push_back(
-          d_solver->mk_term(Op::EQUAL, {terms_orig[i], values_orig[i]}, {}));
+          d_solver->mk_term(Op::EQUAL, {terms_orig[i], values[i]}, {}));
     }
     MURXLA_TEST(d_solver->check_sat_assuming(assumptions)
                 == Solver::Result::SAT);
@@ -167,6 +294,7 @@ CheckSolver::reset()
   d_assertions.clear();
   d_assumptions.clear();
   d_assumptions_shadow.clear();
+  d_evaluator.clear();
   d_incremental = false;
   ShadowSolver::reset();
 }
@@ -10,6 +10,7 @@
 #ifndef __MURXLA__CHECK_SOLVER_H
 #define __MURXLA__CHECK_SOLVER_H
 
+#include "solver/meta/ground_evaluator.hpp"
 #include "solver/meta/shadow_solver.hpp"
 
 namespace murxla {
@@ -22,6 +23,22 @@ class CheckSolver : public shadow::ShadowSolver
 
   void delete_solver() override;
 
+  Term mk_const(Sort sort, const std::string& name) override;
+
+  Term mk_value(Sort sort, bool value) override;
+  Term mk_value(Sort sort, const std::string& value) override;
+  Term mk_value(Sort sort,
+                const std::string& num,
+                const std::string& den) override;
+  Term mk_value(Sort sort, const std::string& value, Base base) override;
+
+  Term mk_special_value(Sort sort,
+                        const AbsTerm::SpecialValueKind& value) override;
+
+  Term mk_term(const Op::Kind& kind,
+               const std::vector<Term>& args,
+               const std::vector<uint32_t>& indices) override;
+
   bool option_unsat_cores_enabled() const override;
 
   void assert_formula(const Term& t) override;
@@ -62,6 +79,12 @@ class CheckSolver : public shadow::ShadowSolver
   std::vector<Term> d_assumptions_shadow;
   std::unordered_map<Term, Term, std::hash<Term>, Equal> d_assumptions;
 
+  /**
+   * Evaluator for checking values without the check solver, records all
+   * terms of d_solver created via this solver.
+   */
+  GroundEvaluator d_evaluator;
+
   /* Flag whether incremental was enabled for d_solver. */
   bool d_incremental = false;
 };
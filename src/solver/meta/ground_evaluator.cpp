@@ -0,0 +1,1019 @@
+/***
+ * Murxla: A Model-Based API Fuzzer for SMT solvers.
+ *
+ * This file is part of Murxla.
+ *
+ * Copyright (C) 2019-2022 by the authors listed in the AUTHORS file.
+ *
+ * See LICENSE for more information on using this software.
+ */
+#include "solver/meta/ground_evaluator.hpp"
+
+#include <cctype>
+#include <numeric>
+#include <sstream>
+#include <unordered_set>
+
+#include "util.hpp"
+
+namespace murxla {
+
+namespace {
+
+using Value = GroundEvaluator::Value;
+
+/* -------------------------------------------------------------------------- */
+/* Bit-vector helpers.                                                        */
+/* -------------------------------------------------------------------------- */
+
+uint64_t
+bv_mask(uint32_t size)
+{
+  return bv_special_value_ones_uint64(size);
+}
+
+bool
+bv_msb(uint64_t value, uint32_t size)
+{
+  return (value >> (size - 1)) & 1;
+}
+
+uint64_t
+bv_neg(uint64_t value, uint32_t size)
+{
+  return (~value + 1) & bv_mask(size);
+}
+
+uint64_t
+bv_udiv(uint64_t a, uint64_t b, uint32_t size)
+{
+  return b == 0 ? bv_mask(size) : a / b;
+}
+
+uint64_t
+bv_urem(uint64_t a, uint64_t b)
+{
+  return b == 0 ? a : a % b;
+}
+
+Value
+mk_bool(bool value)
+{
+  Value res;
+  res.d_kind = Value::BOOL;
+  res.d_bool = value;
+  return res;
+}
+
+Value
+mk_bv(uint64_t value, uint32_t size)
+{
+  assert(size > 0 && size <= 64);
+  Value res;
+  res.d_kind    = Value::BV;
+  res.d_bv      = value & bv_mask(size);
+  res.d_bv_size = size;
+  return res;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Numeric helpers, empty results indicate overflows.                         */
+/* -------------------------------------------------------------------------- */
+
+std::optional<Value>
+mk_num(int64_t num, int64_t den)
+{
+  if (den == 0 || num == INT64_MIN || den == INT64_MIN) return {};
+  if (den < 0)
+  {
+    if (__builtin_mul_overflow(num, -1, &num)
+        || __builtin_mul_overflow(den, -1, &den))
+    {
+      return {};
+    }
+  }
+  int64_t gcd = std::gcd(num, den);
+  Value res;
+  res.d_kind = Value::NUM;
+  res.d_num  = num / gcd;
+  res.d_den  = den / gcd;
+  return res;
+}
+
+std::optional<Value>
+num_add(const Value& a, const Value& b)
+{
+  int64_t n1, n2, num, den;
+  if (__builtin_mul_overflow(a.d_num, b.d_den, &n1)
+      || __builtin_mul_overflow(b.d_num, a.d_den, &n2)
+      || __builtin_add_overflow(n1, n2, &num)
+      || __builtin_mul_overflow(a.d_den, b.d_den, &den))
+  {
+    return {};
+  }
+  return mk_num(num, den);
+}
+
+std::optional<Value>
+num_neg(const Value& a)
+{
+  int64_t num;
+  if (__builtin_mul_overflow(a.d_num, -1, &num)) return {};
+  return mk_num(num, a.d_den);
+}
+
+std::optional<Value>
+num_mul(const Value& a, const Value& b)
+{
+  int64_t num, den;
+  if (__builtin_mul_overflow(a.d_num, b.d_num, &num)
+      || __builtin_mul_overflow(a.d_den, b.d_den, &den))
+  {
+    return {};
+  }
+  return mk_num(num, den);
+}
+
+std::optional<Value>
+num_div(const Value& a, const Value& b)
+{
+  if (b.d_num == 0) return {};
+  int64_t num, den;
+  if (__builtin_mul_overflow(a.d_num, b.d_den, &num)
+      || __builtin_mul_overflow(a.d_den, b.d_num, &den))
+  {
+    return {};
+  }
+  return mk_num(num, den);
+}
+
+/** Compare two numeric values, returns -1, 0 or 1. */
+std::optional<int32_t>
+num_cmp(const Value& a, const Value& b)
+{
+  int64_t n1, n2;
+  if (__builtin_mul_overflow(a.d_num, b.d_den, &n1)
+      || __builtin_mul_overflow(b.d_num, a.d_den, &n2))
+  {
+    return {};
+  }
+  return n1 < n2 ? -1 : (n1 > n2 ? 1 : 0);
+}
+
+/** Floor of a numeric value. */
+int64_t
+num_floor(const Value& a)
+{
+  int64_t res = a.d_num / a.d_den;
+  if (a.d_num % a.d_den != 0 && a.d_num < 0) res -= 1;
+  return res;
+}
+
+/**
+ * Integer division and modulus as defined in SMT-LIB, i.e., the remainder is
+ * always non-negative.
+ */
+std::optional<Value>
+int_div_mod(const Value& a, const Value& b, bool div)
+{
+  assert(a.d_den == 1 && b.d_den == 1);
+  if (b.d_num == 0) return {};
+  if (b.d_num == -1 && a.d_num == INT64_MIN) return {};
+  int64_t r = a.d_num % b.d_num;
+  if (r < 0) r += b.d_num < 0 ? -b.d_num : b.d_num;
+  if (!div) return mk_num(r, 1);
+  return mk_num((a.d_num - r) / b.d_num, 1);
+}
+
+/** Parse a decimal integer or a decimal with a fractional part. */
+std::optional<Value>
+parse_decimal(const std::string& str)
+{
+  size_t i   = 0;
+  bool neg   = false;
+  int64_t n  = 0;
+  int64_t d  = 1;
+  bool frac  = false;
+  bool digit = false;
+  if (i < str.size() && str[i] == '-')
+  {
+    neg = true;
+    i += 1;
+  }
+  for (; i < str.size(); ++i)
+  {
+    char c = str[i];
+    if (c == '.' && !frac)
+    {
+      frac = true;
+      continue;
+    }
+    if (c < '0' || c > '9') return {};
+    digit = true;
+    if (__builtin_mul_overflow(n, 10, &n)
+        || __builtin_add_overflow(n, c - '0', &n))
+    {
+      return {};
+    }
+    if (frac && __builtin_mul_overflow(d, 10, &d)) return {};
+  }
+  if (!digit) return {};
+  return mk_num(neg ? -n : n, d);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Value parser.                                                              */
+/* -------------------------------------------------------------------------- */
+
+/** Split given string into parentheses and atoms. */
+std::vector<std::string>
+tokenize_sexpr(const std::string& str)
+{
+  std::vector<std::string> res;
+  std::string cur;
+  for (char c : str)
+  {
+    if (c == '(' || c == ')' || std::isspace(c))
+    {
+      if (!cur.empty())
+      {
+        res.push_back(cur);
+        cur.clear();
+      }
+      if (!std::isspace(c))
+      {
+        res.emplace_back(1, c);
+      }
+    }
+    else
+    {
+      cur += c;
+    }
+  }
+  if (!cur.empty())
+  {
+    res.push_back(cur);
+  }
+  return res;
+}
+
+/** Parse a bit-vector literal of given base. */
+std::optional<Value>
+parse_bv(const std::string& digits, uint32_t base, uint32_t size)
+{
+  uint32_t bits = base == 2 ? 1 : 4;
+  if (digits.empty() || digits.size() * bits != size || size > 64) return {};
+  uint64_t value = 0;
+  for (char c : digits)
+  {
+    uint64_t d;
+    if (c >= '0' && c <= '9')
+      d = c - '0';
+    else if (c >= 'a' && c <= 'f')
+      d = c - 'a' + 10;
+    else if (c >= 'A' && c <= 'F')
+      d = c - 'A' + 10;
+    else
+      return {};
+    if (d >= base) return {};
+    value = (value << bits) | d;
+  }
+  return mk_bv(value, size);
+}
+
+/**
+ * Parse the expression starting at token 'i', sets 'i' to the token after
+ * the expression.
+ */
+std::optional<Value>
+parse_sexpr(const std::vector<std::string>& tokens,
+            size_t& i,
+            SortKind sort_kind,
+            uint32_t bv_size)
+{
+  if (i >= tokens.size()) return {};
+  const std::string& tok = tokens[i++];
+
+  if (tok != "(")
+  {
+    if (tok == ")") return {};
+    if (sort_kind == SORT_BOOL)
+    {
+      if (tok == "true") return mk_bool(true);
+      if (tok == "false") return mk_bool(false);
+      return {};
+    }
+    if (sort_kind == SORT_BV)
+    {
+      if (tok.compare(0, 2, "#b") == 0 || tok.compare(0, 2, "0b") == 0)
+      {
+        return parse_bv(tok.substr(2), 2, bv_size);
+      }
+      if (tok.compare(0, 2, "#x") == 0)
+      {
+        return parse_bv(tok.substr(2), 16, bv_size);
+      }
+      return {};
+    }
+    assert(sort_kind == SORT_INT || sort_kind == SORT_REAL);
+    size_t pos = tok.find('/');
+    if (pos != std::string::npos)
+    {
+      auto num = parse_decimal(tok.substr(0, pos));
+      auto den = parse_decimal(tok.substr(pos + 1));
+      if (!num || !den) return {};
+      return num_div(*num, *den);
+    }
+    return parse_decimal(tok);
+  }
+
+  if (i >= tokens.size()) return {};
+  const std::string& op = tokens[i++];
+  std::optional<Value> res;
+  if (op == "_" && sort_kind == SORT_BV)
+  {
+    /* (_ bvN size) */
+    if (i + 1 >= tokens.size() || tokens[i].compare(0, 2, "bv") != 0)
+    {
+      return {};
+    }
+    std::string digits = tokens[i].substr(2);
+    uint32_t size      = str_to_uint32(tokens[i + 1]);
+    if (size != bv_size || size > 64) return {};
+    uint64_t value = 0;
+    for (char c : digits)
+    {
+      if (c < '0' || c > '9') return {};
+      if (__builtin_mul_overflow(value, 10, &value)
+          || __builtin_add_overflow(value, c - '0', &value))
+      {
+        return {};
+      }
+    }
+    if (value > bv_mask(size)) return {};
+    i += 2;
+    res = mk_bv(value, size);
+  }
+  else if (op == "-" && (sort_kind == SORT_INT || sort_kind == SORT_REAL))
+  {
+    auto arg = parse_sexpr(tokens, i, sort_kind, bv_size);
+    if (!arg) return {};
+    res = num_neg(*arg);
+  }
+  else if (op == "/" && (sort_kind == SORT_INT || sort_kind == SORT_REAL))
+  {
+    auto num = parse_sexpr(tokens, i, sort_kind, bv_size);
+    if (!num) return {};
+    auto den = parse_sexpr(tokens, i, sort_kind, bv_size);
+    if (!den) return {};
+    res = num_div(*num, *den);
+  }
+  if (!res || i >= tokens.size() || tokens[i] != ")") return {};
+  i += 1;
+  return res;
+}
+
+/** Return true if given operator kind is supported by the evaluator. */
+bool
+is_supported_kind(const Op::Kind& kind)
+{
+  static const std::unordered_set<Op::Kind> s_kinds = {
+      Op::DISTINCT,        Op::EQUAL,          Op::ITE,
+      Op::AND,             Op::IMPLIES,        Op::NOT,
+      Op::OR,              Op::XOR,            Op::BV_EXTRACT,
+      Op::BV_REPEAT,       Op::BV_ROTATE_LEFT, Op::BV_ROTATE_RIGHT,
+      Op::BV_SIGN_EXTEND,  Op::BV_ZERO_EXTEND, Op::BV_ADD,
+      Op::BV_AND,          Op::BV_ASHR,        Op::BV_COMP,
+      Op::BV_CONCAT,       Op::BV_LSHR,        Op::BV_MULT,
+      Op::BV_NAND,         Op::BV_NEG,         Op::BV_NOR,
+      Op::BV_NOT,          Op::BV_OR,          Op::BV_SDIV,
+      Op::BV_SGE,          Op::BV_SGT,         Op::BV_SHL,
+      Op::BV_SLE,          Op::BV_SLT,         Op::BV_SMOD,
+      Op::BV_SREM,         Op::BV_SUB,         Op::BV_UDIV,
+      Op::BV_UGE,          Op::BV_UGT,         Op::BV_ULE,
+      Op::BV_ULT,          Op::BV_UREM,        Op::BV_XNOR,
+      Op::BV_XOR,          Op::INT_IS_DIV,     Op::INT_NEG,
+      Op::INT_SUB,         Op::INT_ADD,        Op::INT_MUL,
+      Op::INT_DIV,         Op::INT_MOD,        Op::INT_ABS,
+      Op::INT_LT,          Op::INT_LTE,        Op::INT_GT,
+      Op::INT_GTE,         Op::INT_TO_REAL,    Op::REAL_NEG,
+      Op::REAL_SUB,        Op::REAL_ADD,       Op::REAL_MUL,
+      Op::REAL_DIV,        Op::REAL_LT,        Op::REAL_LTE,
+      Op::REAL_GT,         Op::REAL_GTE,       Op::REAL_IS_INT,
+      Op::REAL_TO_INT,
+  };
+  return s_kinds.find(kind) != s_kinds.end();
+}
+
+/** Return true if constants of given sort are supported by the evaluator. */
+bool
+is_supported_sort(SortKind sort_kind, uint32_t bv_size)
+{
+  return sort_kind == SORT_BOOL || sort_kind == SORT_INT
+         || sort_kind == SORT_REAL || (sort_kind == SORT_BV && bv_size <= 64);
+}
+
+}  // namespace
+
+/* -------------------------------------------------------------------------- */
+
+bool
+GroundEvaluator::Value::operator==(const Value& other) const
+{
+  if (d_kind != other.d_kind) return false;
+  switch (d_kind)
+  {
+    case BOOL: return d_bool == other.d_bool;
+    case BV: return d_bv_size == other.d_bv_size && d_bv == other.d_bv;
+    default:
+      assert(d_kind == NUM);
+      return d_num == other.d_num && d_den == other.d_den;
+  }
+}
+
+std::string
+GroundEvaluator::Value::to_string() const
+{
+  std::stringstream ss;
+  switch (d_kind)
+  {
+    case BOOL: ss << (d_bool ? "true" : "false"); break;
+    case BV: ss << "(_ bv" << d_bv << " " << d_bv_size << ")"; break;
+    default:
+      assert(d_kind == NUM);
+      ss << d_num;
+      if (d_den != 1) ss << "/" << d_den;
+  }
+  return ss.str();
+}
+
+std::optional<GroundEvaluator::Value>
+GroundEvaluator::parse_value(const std::string& value,
+                             SortKind sort_kind,
+                             uint32_t bv_size)
+{
+  if (!is_supported_sort(sort_kind, bv_size)) return {};
+  std::vector<std::string> tokens = tokenize_sexpr(value);
+  size_t i                        = 0;
+  std::optional<Value> res        = parse_sexpr(tokens, i, sort_kind, bv_size);
+  if (i != tokens.size()) return {};
+  return res;
+}
+
+std::optional<GroundEvaluator::Value>
+GroundEvaluator::parse_value(const std::string& value, const Value& like)
+{
+  switch (like.d_kind)
+  {
+    case Value::BOOL: return parse_value(value, SORT_BOOL, 0);
+    case Value::BV: return parse_value(value, SORT_BV, like.d_bv_size);
+    default:
+      assert(like.d_kind == Value::NUM);
+      return parse_value(value, SORT_REAL, 0);
+  }
+}
+
+/* -------------------------------------------------------------------------- */
+
+void
+GroundEvaluator::add_const(Term term, Sort sort)
+{
+  Node& node       = d_terms[term];
+  node.d_sort_kind = sort->get_kind();
+  if (node.d_sort_kind == SORT_BV)
+  {
+    node.d_bv_size = sort->get_bv_size();
+  }
+}
+
+void
+GroundEvaluator::add_value(Term term, Sort sort, bool value)
+{
+  add_value_helper(term, sort, mk_bool(value));
+}
+
+void
+GroundEvaluator::add_value(Term term, Sort sort, const std::string& value)
+{
+  SortKind sort_kind = sort->get_kind();
+  if (sort_kind != SORT_INT && sort_kind != SORT_REAL)
+  {
+    add_value_helper(term, sort, {});
+    return;
+  }
+  add_value_helper(term, sort, parse_value(value, sort_kind, 0));
+}
+
+void
+GroundEvaluator::add_value(Term term,
+                           Sort sort,
+                           const std::string& num,
+                           const std::string& den)
+{
+  SortKind sort_kind = sort->get_kind();
+  std::optional<Value> n, d;
+  if (sort_kind == SORT_REAL)
+  {
+    n = parse_decimal(num);
+    d = parse_decimal(den);
+  }
+  add_value_helper(term, sort, n && d ? num_div(*n, *d) : std::nullopt);
+}
+
+void
+GroundEvaluator::add_value(Term term,
+                           Sort sort,
+                           const std::string& value,
+                           Solver::Base base)
+{
+  std::optional<Value> res;
+  if (sort->get_kind() == SORT_BV)
+  {
+    uint32_t size = sort->get_bv_size();
+    if (size <= 64)
+    {
+      if (base == Solver::Base::HEX)
+      {
+        res = parse_bv(value, 16, size);
+      }
+      else
+      {
+        bool neg        = base == Solver::Base::DEC && value[0] == '-';
+        std::string bin = value;
+        if (base == Solver::Base::DEC)
+        {
+          bin = str_dec_to_bin(neg ? value.substr(1) : value);
+        }
+        if (bin.size() <= size)
+        {
+          res = parse_bv(std::string(size - bin.size(), '0') + bin, 2, size);
+          if (res && neg)
+          {
+            res = mk_bv(bv_neg(res->d_bv, size), size);
+          }
+        }
+      }
+    }
+  }
+  add_value_helper(term, sort, res);
+}
+
+void
+GroundEvaluator::add_special_value(Term term,
+                                   Sort sort,
+                                   const AbsTerm::SpecialValueKind& value)
+{
+  std::optional<Value> res;
+  if (sort->get_kind() == SORT_BV)
+  {
+    uint32_t size = sort->get_bv_size();
+    if (size <= 64)
+    {
+      if (value == AbsTerm::SPECIAL_VALUE_BV_ZERO)
+      {
+        res = mk_bv(0, size);
+      }
+      else if (value == AbsTerm::SPECIAL_VALUE_BV_ONE)
+      {
+        res = mk_bv(1, size);
+      }
+      else if (value == AbsTerm::SPECIAL_VALUE_BV_ONES)
+      {
+        res = mk_bv(bv_special_value_ones_uint64(size), size);
+      }
+      else if (value == AbsTerm::SPECIAL_VALUE_BV_MIN_SIGNED)
+      {
+        res = mk_bv(bv_special_value_min_signed_uint64(size), size);
+      }
+      else if (value == AbsTerm::SPECIAL_VALUE_BV_MAX_SIGNED)
+      {
+        res = mk_bv(bv_special_value_max_signed_uint64(size), size);
+      }
+    }
+  }
+  add_value_helper(term, sort, res);
+}
+
+void
+GroundEvaluator::add_term(Term term,
+                          const Op::Kind& kind,
+                          const std::vector<Term>& args,
+                          const std::vector<uint32_t>& indices)
+{
+  Node& node     = d_terms[term];
+  node.d_kind    = kind;
+  node.d_args    = args;
+  node.d_indices = indices;
+}
+
+void
+GroundEvaluator::add_value_helper(Term term,
+                                  Sort sort,
+                                  std::optional<Value> value)
+{
+  Node& node       = d_terms[term];
+  node.d_sort_kind = sort->get_kind();
+  node.d_value     = value;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool
+GroundEvaluator::is_supported(const std::vector<Term>& terms) const
+{
+  BoolMap cache;
+  for (const Term& t : terms)
+  {
+    if (!is_supported(t, cache)) return false;
+  }
+  return true;
+}
+
+bool
+GroundEvaluator::is_supported(const Term& term, BoolMap& cache) const
+{
+  auto it = cache.find(term);
+  if (it != cache.end()) return it->second;
+
+  bool res     = false;
+  auto node_it = d_terms.find(term);
+  if (node_it != d_terms.end())
+  {
+    const Node& node = node_it->second;
+    if (node.d_kind != Op::UNDEFINED)
+    {
+      res = is_supported_kind(node.d_kind);
+      for (size_t i = 0, n = node.d_args.size(); res && i < n; ++i)
+      {
+        res = is_supported(node.d_args[i], cache);
+      }
+    }
+    else if (node.d_value)
+    {
+      res = true;
+    }
+    else
+    {
+      res = node.d_sort_kind != SORT_ANY
+            && is_supported_sort(node.d_sort_kind, node.d_bv_size);
+    }
+  }
+  cache.emplace(term, res);
+  return res;
+}
+
+std::vector<Term>
+GroundEvaluator::get_consts(const std::vector<Term>& terms) const
+{
+  std::vector<Term> res;
+  BoolMap visited;
+  std::vector<Term> visit(terms.begin(), terms.end());
+  while (!visit.empty())
+  {
+    Term cur = visit.back();
+    visit.pop_back();
+    if (!visited.emplace(cur, true).second) continue;
+    auto it = d_terms.find(cur);
+    assert(it != d_terms.end());
+    const Node& node = it->second;
+    if (node.d_kind == Op::UNDEFINED)
+    {
+      if (!node.d_value) res.push_back(cur);
+    }
+    else
+    {
+      visit.insert(visit.end(), node.d_args.begin(), node.d_args.end());
+    }
+  }
+  return res;
+}
+
+bool
+GroundEvaluator::set_model(const std::vector<Term>& consts,
+                           const std::vector<Term>& values)
+{
+  assert(consts.size() == values.size());
+  d_model.clear();
+  d_cache.clear();
+  for (size_t i = 0, n = consts.size(); i < n; ++i)
+  {
+    const Node& node = d_terms.at(consts[i]);
+    auto value =
+        parse_value(values[i]->to_string(), node.d_sort_kind, node.d_bv_size);
+    if (!value) return false;
+    d_model.emplace(consts[i], value);
+  }
+  return true;
+}
+
+std::optional<GroundEvaluator::Value>
+GroundEvaluator::evaluate(const Term& term)
+{
+  auto it = d_cache.find(term);
+  if (it != d_cache.end()) return it->second;
+
+  const Node& node = d_terms.at(term);
+  std::optional<Value> res;
+  if (node.d_kind == Op::UNDEFINED)
+  {
+    res = node.d_value ? node.d_value : d_model.at(term);
+  }
+  else if (node.d_kind == Op::ITE)
+  {
+    /* Only evaluate the selected branch. */
+    auto cond = evaluate(node.d_args[0]);
+    if (cond)
+    {
+      res = evaluate(node.d_args[cond->d_bool ? 1 : 2]);
+    }
+  }
+  else
+  {
+    std::vector<Value> args;
+    for (const Term& arg : node.d_args)
+    {
+      auto value = evaluate(arg);
+      if (!value) break;
+      args.push_back(*value);
+    }
+    if (args.size() == node.d_args.size())
+    {
+      res = evaluate(node, args);
+    }
+  }
+  d_cache.emplace(term, res);
+  return res;
+}
+
+std::optional<GroundEvaluator::Value>
+GroundEvaluator::evaluate(const Node& node,
+                          const std::vector<Value>& args) const
+{
+  const Op::Kind& kind = node.d_kind;
+  size_t n_args        = args.size();
+
+  /* Boolean */
+  if (kind == Op::NOT)
+  {
+    return mk_bool(!args[0].d_bool);
+  }
+  if (kind == Op::AND || kind == Op::OR)
+  {
+    bool res = kind == Op::AND;
+    for (const Value& a : args)
+    {
+      res = kind == Op::AND ? res && a.d_bool : res || a.d_bool;
+    }
+    return mk_bool(res);
+  }
+  if (kind == Op::XOR)
+  {
+    return mk_bool(args[0].d_bool != args[1].d_bool);
+  }
+  if (kind == Op::IMPLIES)
+  {
+    /* Right associative. */
+    bool res = args[n_args - 1].d_bool;
+    for (size_t i = n_args - 1; i-- > 0;)
+    {
+      res = !args[i].d_bool || res;
+    }
+    return mk_bool(res);
+  }
+  if (kind == Op::EQUAL)
+  {
+    for (size_t i = 1; i < n_args; ++i)
+    {
+      if (args[i] != args[0]) return mk_bool(false);
+    }
+    return mk_bool(true);
+  }
+  if (kind == Op::DISTINCT)
+  {
+    for (size_t i = 0; i < n_args; ++i)
+    {
+      for (size_t j = i + 1; j < n_args; ++j)
+      {
+        if (args[i] == args[j]) return mk_bool(false);
+      }
+    }
+    return mk_bool(true);
+  }
+
+  /* Bit-vectors */
+  if (!args.empty() && args[0].d_kind == Value::BV)
+  {
+    uint32_t size = args[0].d_bv_size;
+    uint64_t a    = args[0].d_bv;
+    uint64_t b    = n_args > 1 ? args[1].d_bv : 0;
+
+    if (kind == Op::BV_CONCAT)
+    {
+      uint64_t res      = 0;
+      uint32_t res_size = 0;
+      for (const Value& v : args)
+      {
+        res_size += v.d_bv_size;
+        if (res_size > 64) return {};
+        res = (v.d_bv_size == 64 ? 0 : res << v.d_bv_size) | v.d_bv;
+      }
+      return mk_bv(res, res_size);
+    }
+    if (kind == Op::BV_EXTRACT)
+    {
+      uint32_t hi = node.d_indices[0], lo = node.d_indices[1];
+      return mk_bv(a >> lo, hi - lo + 1);
+    }
+    if (kind == Op::BV_ZERO_EXTEND || kind == Op::BV_SIGN_EXTEND)
+    {
+      uint32_t res_size = size + node.d_indices[0];
+      if (res_size > 64) return {};
+      uint64_t res = a;
+      if (kind == Op::BV_SIGN_EXTEND && bv_msb(a, size))
+      {
+        res |= bv_mask(res_size) & ~bv_mask(size);
+      }
+      return mk_bv(res, res_size);
+    }
+    if (kind == Op::BV_REPEAT)
+    {
+      uint32_t n = node.d_indices[0];
+      if (n == 0 || (uint64_t) size * n > 64) return {};
+      uint64_t res = 0;
+      for (uint32_t i = 0; i < n; ++i)
+      {
+        res = (size == 64 ? 0 : res << size) | a;
+      }
+      return mk_bv(res, size * n);
+    }
+    if (kind == Op::BV_ROTATE_LEFT || kind == Op::BV_ROTATE_RIGHT)
+    {
+      uint32_t n = node.d_indices[0] % size;
+      if (n == 0) return mk_bv(a, size);
+      if (kind == Op::BV_ROTATE_RIGHT) n = size - n;
+      return mk_bv((a << n) | (a >> (size - n)), size);
+    }
+    if (kind == Op::BV_ADD || kind == Op::BV_MULT || kind == Op::BV_AND
+        || kind == Op::BV_OR || kind == Op::BV_XOR)
+    {
+      uint64_t res = a;
+      for (size_t i = 1; i < n_args; ++i)
+      {
+        uint64_t v = args[i].d_bv;
+        if (kind == Op::BV_ADD)
+          res = res + v;
+        else if (kind == Op::BV_MULT)
+          res = res * v;
+        else if (kind == Op::BV_AND)
+          res = res & v;
+        else if (kind == Op::BV_OR)
+          res = res | v;
+        else
+          res = res ^ v;
+      }
+      return mk_bv(res, size);
+    }
+    if (kind == Op::BV_NOT) return mk_bv(~a, size);
+    if (kind == Op::BV_NEG) return mk_bv(bv_neg(a, size), size);
+    if (kind == Op::BV_SUB) return mk_bv(a - b, size);
+    if (kind == Op::BV_NAND) return mk_bv(~(a & b), size);
+    if (kind == Op::BV_NOR) return mk_bv(~(a | b), size);
+    if (kind == Op::BV_XNOR) return mk_bv(~(a ^ b), size);
+    if (kind == Op::BV_COMP) return mk_bv(a == b ? 1 : 0, 1);
+    if (kind == Op::BV_SHL) return mk_bv(b >= size ? 0 : a << b, size);
+    if (kind == Op::BV_LSHR) return mk_bv(b >= size ? 0 : a >> b, size);
+    if (kind == Op::BV_ASHR)
+    {
+      if (b >= size) return mk_bv(bv_msb(a, size) ? bv_mask(size) : 0, size);
+      uint64_t res = a >> b;
+      if (bv_msb(a, size))
+      {
+        res |= bv_mask(size) & ~(bv_mask(size) >> b);
+      }
+      return mk_bv(res, size);
+    }
+    if (kind == Op::BV_UDIV) return mk_bv(bv_udiv(a, b, size), size);
+    if (kind == Op::BV_UREM) return mk_bv(bv_urem(a, b), size);
+    if (kind == Op::BV_SDIV || kind == Op::BV_SREM || kind == Op::BV_SMOD)
+    {
+      bool msb_a = bv_msb(a, size), msb_b = bv_msb(b, size);
+      uint64_t abs_a = msb_a ? bv_neg(a, size) : a;
+      uint64_t abs_b = msb_b ? bv_neg(b, size) : b;
+      if (kind == Op::BV_SDIV)
+      {
+        uint64_t res = bv_udiv(abs_a, abs_b, size);
+        return mk_bv(msb_a != msb_b ? bv_neg(res, size) : res, size);
+      }
+      uint64_t res = bv_urem(abs_a, abs_b);
+      if (kind == Op::BV_SREM)
+      {
+        return mk_bv(msb_a ? bv_neg(res, size) : res, size);
+      }
+      if (res == 0 || (!msb_a && !msb_b)) return mk_bv(res, size);
+      if (msb_a && msb_b) return mk_bv(bv_neg(res, size), size);
+      if (msb_a) return mk_bv(bv_neg(res, size) + b, size);
+      return mk_bv(res + b, size);
+    }
+    if (kind == Op::BV_ULT) return mk_bool(a < b);
+    if (kind == Op::BV_ULE) return mk_bool(a <= b);
+    if (kind == Op::BV_UGT) return mk_bool(a > b);
+    if (kind == Op::BV_UGE) return mk_bool(a >= b);
+    if (kind == Op::BV_SLT || kind == Op::BV_SLE || kind == Op::BV_SGT
+        || kind == Op::BV_SGE)
+    {
+      /* Flipping the sign bits maps signed to unsigned order. */
+      uint64_t sign = bv_special_value_min_signed_uint64(size);
+      uint64_t sa = a ^ sign, sb = b ^ sign;
+      if (kind == Op::BV_SLT) return mk_bool(sa < sb);
+      if (kind == Op::BV_SLE) return mk_bool(sa <= sb);
+      if (kind == Op::BV_SGT) return mk_bool(sa > sb);
+      return mk_bool(sa >= sb);
+    }
+    return {};
+  }
+
+  /* Integers and reals */
+  if (kind == Op::INT_NEG || kind == Op::REAL_NEG)
+  {
+    return num_neg(args[0]);
+  }
+  if (kind == Op::INT_ADD || kind == Op::REAL_ADD || kind == Op::INT_SUB
+      || kind == Op::REAL_SUB || kind == Op::INT_MUL || kind == Op::REAL_MUL
+      || kind == Op::REAL_DIV || kind == Op::INT_DIV || kind == Op::INT_MOD)
+  {
+    /* Left associative. */
+    std::optional<Value> res = args[0];
+    for (size_t i = 1; res && i < n_args; ++i)
+    {
+      if (kind == Op::INT_ADD || kind == Op::REAL_ADD)
+      {
+        res = num_add(*res, args[i]);
+      }
+      else if (kind == Op::INT_SUB || kind == Op::REAL_SUB)
+      {
+        auto neg = num_neg(args[i]);
+        res      = neg ? num_add(*res, *neg) : std::nullopt;
+      }
+      else if (kind == Op::INT_MUL || kind == Op::REAL_MUL)
+      {
+        res = num_mul(*res, args[i]);
+      }
+      else if (kind == Op::REAL_DIV)
+      {
+        res = num_div(*res, args[i]);
+      }
+      else
+      {
+        res = int_div_mod(*res, args[i], kind == Op::INT_DIV);
+      }
+    }
+    return res;
+  }
+  if (kind == Op::INT_ABS)
+  {
+    return args[0].d_num < 0 ? num_neg(args[0]) : args[0];
+  }
+  if (kind == Op::INT_IS_DIV)
+  {
+    if (node.d_indices[0] == 0) return {};
+    return mk_bool(args[0].d_num % (int64_t) node.d_indices[0] == 0);
+  }
+  if (kind == Op::INT_TO_REAL) return args[0];
+  if (kind == Op::REAL_TO_INT) return mk_num(num_floor(args[0]), 1);
+  if (kind == Op::REAL_IS_INT) return mk_bool(args[0].d_den == 1);
+  if (kind == Op::INT_LT || kind == Op::REAL_LT || kind == Op::INT_LTE
+      || kind == Op::REAL_LTE || kind == Op::INT_GT || kind == Op::REAL_GT
+      || kind == Op::INT_GTE || kind == Op::REAL_GTE)
+  {
+    /* Chainable. */
+    for (size_t i = 1; i < n_args; ++i)
+    {
+      auto cmp = num_cmp(args[i - 1], args[i]);
+      if (!cmp) return {};
+      bool res;
+      if (kind == Op::INT_LT || kind == Op::REAL_LT)
+        res = *cmp < 0;
+      else if (kind == Op::INT_LTE || kind == Op::REAL_LTE)
+        res = *cmp <= 0;
+      else if (kind == Op::INT_GT || kind == Op::REAL_GT)
+        res = *cmp > 0;
+      else
+        res = *cmp >= 0;
+      if (!res) return mk_bool(false);
+    }
+    return mk_bool(true);
+  }
+  return {};
+}
+
+void
+GroundEvaluator::clear()
+{
+  d_terms.clear();
+  d_model.clear();
+  d_cache.clear();
+}
+
+/* -------------------------------------------------------------------------- */
+
+}  // namespace murxla
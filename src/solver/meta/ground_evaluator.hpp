@@ -0,0 +1,185 @@
+/***
+ * Murxla: A Model-Based API Fuzzer for SMT solvers.
+ *
+ * This file is part of Murxla.
+ *
+ * Copyright (C) 2019-2022 by the authors listed in the AUTHORS file.
+ *
+ * See LICENSE for more information on using this software.
+ */
+#ifndef __MURXLA__GROUND_EVALUATOR_H
+#define __MURXLA__GROUND_EVALUATOR_H
+
+#include <optional>
+#include <unordered_map>
+
+#include "solver/solver.hpp"
+
+namespace murxla {
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Evaluator for ground terms of the Boolean, bit-vector (of size up to 64),
+ * integer and real fragments under a given model.
+ *
+ * The evaluator records how terms are constructed (see add_*()) and evaluates
+ * terms bottom-up, given the values of the constants they contain (see
+ * set_model()). Integer and real values are represented as rationals over
+ * 64-bit integers, terms whose evaluation overflows or that are otherwise
+ * not evaluable (e.g., division by zero, which is unspecified) are skipped
+ * when checking values.
+ *
+ * Terms are the terms of the solver under test.
+ */
+class GroundEvaluator
+{
+ public:
+  /** A ground value. */
+  struct Value
+  {
+    enum Kind
+    {
+      BOOL,
+      BV,
+      NUM,
+    };
+    Kind d_kind = BOOL;
+    /** The value of a Boolean value. */
+    bool d_bool = false;
+    /** The value and the size of a bit-vector value. */
+    uint64_t d_bv      = 0;
+    uint32_t d_bv_size = 0;
+    /** The normalized numerator and denominator of a numeric value. */
+    int64_t d_num = 0;
+    int64_t d_den = 1;
+
+    bool operator==(const Value& other) const;
+    bool operator!=(const Value& other) const { return !(*this == other); }
+    std::string to_string() const;
+  };
+
+  /**
+   * Parse a value given in SMT-LIB format (or in the format of one of the
+   * supported solvers) of given sort kind and bit-vector size.
+   * Returns an empty optional if the value can not be parsed.
+   */
+  static std::optional<Value> parse_value(const std::string& value,
+                                          SortKind sort_kind,
+                                          uint32_t bv_size);
+  /** Parse a value of the same kind (and size) as value 'like'. */
+  static std::optional<Value> parse_value(const std::string& value,
+                                          const Value& like);
+
+  /** Record first-order constant 'term' of given sort. */
+  void add_const(Term term, Sort sort);
+  /** Record value 'term' of given sort and value (see Solver::mk_value()). */
+  void add_value(Term term, Sort sort, bool value);
+  void add_value(Term term, Sort sort, const std::string& value);
+  void add_value(Term term,
+                 Sort sort,
+                 const std::string& num,
+                 const std::string& den);
+  void add_value(Term term,
+                 Sort sort,
+                 const std::string& value,
+                 Solver::Base base);
+  /** Record special value 'term' of given sort. */
+  void add_special_value(Term term,
+                         Sort sort,
+                         const AbsTerm::SpecialValueKind& value);
+  /** Record 'term' of given kind with given arguments and indices. */
+  void add_term(Term term,
+                const Op::Kind& kind,
+                const std::vector<Term>& args,
+                const std::vector<uint32_t>& indices);
+
+  /**
+   * Return true if all given terms were recorded and only contain supported
+   * operators and constants of supported sorts.
+   */
+  bool is_supported(const std::vector<Term>& terms) const;
+  /** Get the constants contained in given terms. */
+  std::vector<Term> get_consts(const std::vector<Term>& terms) const;
+
+  /**
+   * Set the model to evaluate terms under.
+   * consts: The constants of the model (see get_consts()).
+   * values: The values of the constants, as returned by the solver.
+   * Returns false if the value of any constant can not be parsed.
+   */
+  bool set_model(const std::vector<Term>& consts,
+                 const std::vector<Term>& values);
+
+  /**
+   * Evaluate given term under the current model.
+   * Returns an empty optional if the term is not evaluable.
+   */
+  std::optional<Value> evaluate(const Term& term);
+
+  /** Clear all recorded terms and the model. */
+  void clear();
+
+ private:
+  /**
+   * Terms are identified by address. Term hashes and equality are provided by
+   * the solver and may be expensive or coarse (e.g., for SMT2 terms, which are
+   * all hashed to the same value since their ids are only set on the terms
+   * that wrap them).
+   */
+  struct Hash
+  {
+    size_t operator()(const Term& t) const
+    {
+      return std::hash<AbsTerm*>{}(t.get());
+    }
+  };
+  struct Equal
+  {
+    bool operator()(const Term& t1, const Term& t2) const
+    {
+      return t1.get() == t2.get();
+    }
+  };
+
+  /** A recorded term. */
+  struct Node
+  {
+    /** The kind of the term, Op::UNDEFINED for constants and values. */
+    Op::Kind d_kind = Op::UNDEFINED;
+    /** The sort kind and the bit-vector size of a constant. */
+    SortKind d_sort_kind = SORT_ANY;
+    uint32_t d_bv_size   = 0;
+    /** The value of a value, empty for unsupported values. */
+    std::optional<Value> d_value;
+    /** The arguments and indices of the term. */
+    std::vector<Term> d_args;
+    std::vector<uint32_t> d_indices;
+  };
+
+  using TermMap = std::unordered_map<Term, Node, Hash, Equal>;
+  using ValueMap =
+      std::unordered_map<Term, std::optional<Value>, Hash, Equal>;
+  using BoolMap = std::unordered_map<Term, bool, Hash, Equal>;
+
+  /** Record 'term' as a value of given sort. */
+  void add_value_helper(Term term, Sort sort, std::optional<Value> value);
+  /** Helper for is_supported(), 'cache' holds the already checked terms. */
+  bool is_supported(const Term& term, BoolMap& cache) const;
+  /** Evaluate given node with given evaluated arguments. */
+  std::optional<Value> evaluate(const Node& node,
+                                const std::vector<Value>& args) const;
+
+  /** The recorded terms. */
+  TermMap d_terms;
+  /** The model, maps constants to values. */
+  ValueMap d_model;
+  /** The values of the terms evaluated under the current model. */
+  ValueMap d_cache;
+};
+
+/* -------------------------------------------------------------------------- */
+
+}  // namespace murxla
+
+#endif
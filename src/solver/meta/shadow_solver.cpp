@@ -14,12 +14,395 @@
 namespace murxla {
 namespace shadow {
 
-ShadowSort::ShadowSort(Sort sort, Sort sort_shadow)
-    : d_sort(sort), d_sort_shadow(sort_shadow)
+namespace {
+
+/** Get the sort of the solver under test of given ShadowSort. */
+Sort
+get_sort_orig(const Sort& sort)
+{
+  ShadowSort* s = checked_cast<ShadowSort*>(sort.get());
+  assert(s);
+  return s->get_sort();
+}
+
+/** Get the sort of the cross-check solver of given ShadowSort. */
+Sort
+get_sort_shadow(const Sort& sort)
+{
+  ShadowSort* s = checked_cast<ShadowSort*>(sort.get());
+  assert(s);
+  return s->get_sort_shadow();
+}
+
+/** Get the term of the solver under test of given ShadowTerm. */
+Term
+get_term_orig(const Term& term)
+{
+  ShadowTerm* t = checked_cast<ShadowTerm*>(term.get());
+  assert(t);
+  return t->get_term();
+}
+
+/** Get the term of the cross-check solver of given ShadowTerm. */
+Term
+get_term_shadow(const Term& term)
+{
+  ShadowTerm* t = checked_cast<ShadowTerm*>(term.get());
+  assert(t);
+  return t->get_term_shadow();
+}
+
+/** Get the terms of the solver under test of given ShadowTerms. */
+std::vector<Term>
+get_terms_orig(const std::vector<Term>& terms)
+{
+  std::vector<Term> res;
+  for (const auto& t : terms)
+  {
+    res.push_back(get_term_orig(t));
+  }
+  return res;
+}
+
+/** Get the terms of the cross-check solver of given ShadowTerms. */
+std::vector<Term>
+get_terms_shadow(const std::vector<Term>& terms)
+{
+  std::vector<Term> res;
+  for (const auto& t : terms)
+  {
+    res.push_back(get_term_shadow(t));
+  }
+  return res;
+}
+
+/**
+ * Get the sorts of the solver under test and the cross-check solver for given
+ * sort, which is either null, a parameter sort, an unresolved sort or a
+ * ShadowSort.
+ */
+void
+get_sort_helper(Sort sort, Sort& sort_orig, Sort& sort_shadow)
+{
+  if (!sort)
+  {
+    return;
+  }
+  if (sort->is_param_sort())
+  {
+    ShadowSolver::get_param_sort_helper(sort, sort_orig, sort_shadow);
+  }
+  else if (sort->is_unresolved_sort())
+  {
+    ShadowSolver::get_unresolved_sort_helper(sort, sort_orig, sort_shadow);
+  }
+  else
+  {
+    sort_orig   = get_sort_orig(sort);
+    sort_shadow = get_sort_shadow(sort);
+  }
+}
+
+/**
+ * Get the datatype constructors of the solver under test and the cross-check
+ * solver for given datatype constructors.
+ */
+void
+get_ctors_helper(const AbsSort::DatatypeConstructorMap& ctors,
+                 AbsSort::DatatypeConstructorMap& ctors_orig,
+                 AbsSort::DatatypeConstructorMap& ctors_shadow)
+{
+  for (const auto& c : ctors)
+  {
+    const auto& cname   = c.first;
+    ctors_orig[cname]   = {};
+    ctors_shadow[cname] = {};
+
+    const auto& sels = c.second;
+    for (const auto& s : sels)
+    {
+      const auto& sname  = s.first;
+      auto& sel_sort     = s.second;
+      Sort sel_sort_orig = sel_sort, sel_sort_shadow = sel_sort;
+      if (sel_sort && !sel_sort->is_param_sort())
+      {
+        if (sel_sort->is_unresolved_sort())
+        {
+          ShadowSolver::get_unresolved_sort_helper(
+              sel_sort, sel_sort_orig, sel_sort_shadow);
+        }
+        else
+        {
+          sel_sort_orig   = get_sort_orig(sel_sort);
+          sel_sort_shadow = get_sort_shadow(sel_sort);
+        }
+      }
+      ctors_orig[cname].emplace_back(sname, sel_sort_orig);
+      ctors_shadow[cname].emplace_back(sname, sel_sort_shadow);
+    }
+  }
+}
+
+/** Check the check-sat results of the two solvers for consistency. */
+void
+check_result(Solver::Result res_orig, Solver::Result res_shadow)
+{
+  if (res_orig != Solver::Result::UNKNOWN
+      && res_shadow != Solver::Result::UNKNOWN)
+  {
+    MURXLA_TEST(res_orig == res_shadow)
+        << "Solver reports " << res_orig << " while cross-check solver reports "
+        << res_shadow;
+  }
+}
+
+}  // namespace
+
+/* -------------------------------------------------------------------------- */
+
+ShadowWorker::ShadowWorker() : d_thread(&ShadowWorker::loop, this) {}
+
+ShadowWorker::~ShadowWorker()
+{
+  {
+    std::lock_guard<std::mutex> lock(d_mutex);
+    assert(!d_busy);
+    d_stop = true;
+  }
+  d_cv.notify_all();
+  d_thread.join();
+}
+
+void
+ShadowWorker::post(const std::function<void()>& job)
+{
+  {
+    std::lock_guard<std::mutex> lock(d_mutex);
+    assert(!d_busy);
+    d_job  = job;
+    d_busy = true;
+  }
+  d_cv.notify_all();
+}
+
+void
+ShadowWorker::wait()
+{
+  std::exception_ptr exception;
+  {
+    std::unique_lock<std::mutex> lock(d_mutex);
+    d_cv.wait(lock, [this]() { return !d_busy; });
+    std::swap(exception, d_exception);
+  }
+  if (exception)
+  {
+    std::rethrow_exception(exception);
+  }
+}
+
+void
+ShadowWorker::release(Term term)
+{
+  std::lock_guard<std::mutex> lock(d_mutex);
+  d_released_terms.push_back(std::move(term));
+}
+
+void
+ShadowWorker::release(Sort sort)
+{
+  std::lock_guard<std::mutex> lock(d_mutex);
+  d_released_sorts.push_back(std::move(sort));
+}
+
+void
+ShadowWorker::loop()
+{
+  for (;;)
+  {
+    std::function<void()> job;
+    std::vector<Term> released_terms;
+    std::vector<Sort> released_sorts;
+    {
+      std::unique_lock<std::mutex> lock(d_mutex);
+      d_cv.wait(lock, [this]() { return d_busy || d_stop; });
+      std::swap(job, d_job);
+      std::swap(released_terms, d_released_terms);
+      std::swap(released_sorts, d_released_sorts);
+    }
+    /* Destroy released objects before running the job, while the calling
+     * thread is guaranteed to not access the cross-check solver. */
+    released_terms.clear();
+    released_sorts.clear();
+    if (!job)
+    {
+      assert(d_stop);
+      return;
+    }
+    std::exception_ptr exception;
+    try
+    {
+      job();
+    }
+    catch (...)
+    {
+      exception = std::current_exception();
+    }
+    /* The job may hold references to shadow objects, which must be dropped
+     * while the calling thread still holds its references. */
+    job = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(d_mutex);
+      d_exception = exception;
+      d_busy      = false;
+    }
+    d_cv.notify_all();
+  }
+}
+
+/* -------------------------------------------------------------------------- */
+
+ShadowDispatcher::ShadowDispatcher(bool threaded, bool lazy)
+    : d_worker(threaded ? new ShadowWorker() : nullptr), d_lazy(lazy)
+{
+}
+
+void
+ShadowDispatcher::run(const std::function<void()>& fun,
+                      const std::function<void()>& fun_shadow)
+{
+  if (d_lazy)
+  {
+    fun();
+    d_log.push_back({fun_shadow, false});
+  }
+  else
+  {
+    run_now(fun, fun_shadow);
+  }
+}
+
+void
+ShadowDispatcher::run(const std::function<void()>& fun_shadow)
+{
+  run([]() {}, fun_shadow);
+}
+
+void
+ShadowDispatcher::record_check_sat(const std::function<void()>& fun_shadow)
+{
+  if (d_lazy)
+  {
+    d_log.push_back({fun_shadow, true});
+  }
+  else
+  {
+    run_now([]() {}, fun_shadow);
+  }
+}
+
+void
+ShadowDispatcher::sync(const std::function<void()>& fun,
+                       const std::function<void()>& fun_shadow,
+                       bool check_sat)
+{
+  std::vector<Call> log;
+  std::swap(log, d_log);
+
+  size_t last_check_sat = log.size();
+  if (check_sat)
+  {
+    for (size_t i = log.size(); i-- > 0;)
+    {
+      if (log[i].d_is_check_sat)
+      {
+        last_check_sat = i;
+        break;
+      }
+    }
+  }
+
+  run_now(fun, [&]() {
+    for (size_t i = 0, n = log.size(); i < n; ++i)
+    {
+      if (!log[i].d_is_check_sat || i == last_check_sat)
+      {
+        log[i].d_fun();
+      }
+    }
+    fun_shadow();
+  });
+}
+
+void
+ShadowDispatcher::sync(const std::function<void()>& fun_shadow, bool check_sat)
+{
+  sync([]() {}, fun_shadow, check_sat);
+}
+
+void
+ShadowDispatcher::discard()
+{
+  d_log.clear();
+}
+
+void
+ShadowDispatcher::release(Term term)
+{
+  if (d_worker)
+  {
+    d_worker->release(std::move(term));
+  }
+}
+
+void
+ShadowDispatcher::release(Sort sort)
+{
+  if (d_worker)
+  {
+    d_worker->release(std::move(sort));
+  }
+}
+
+void
+ShadowDispatcher::run_now(const std::function<void()>& fun,
+                          const std::function<void()>& fun_shadow)
+{
+  if (!d_worker)
+  {
+    fun();
+    fun_shadow();
+    return;
+  }
+  d_worker->post(fun_shadow);
+  try
+  {
+    fun();
+  }
+  catch (...)
+  {
+    /* The job may refer to the stack of the caller, always wait for it. */
+    try
+    {
+      d_worker->wait();
+    }
+    catch (...)
+    {
+    }
+    throw;
+  }
+  d_worker->wait();
+}
+
+/* -------------------------------------------------------------------------- */
+
+ShadowSort::ShadowSort(Sort sort,
+                       Sort sort_shadow,
+                       const std::shared_ptr<ShadowDispatcher>& dispatcher)
+    : d_sort(sort), d_sort_shadow(sort_shadow), d_dispatcher(dispatcher)
 {
 }
 
-ShadowSort::~ShadowSort() {}
+ShadowSort::~ShadowSort() { d_dispatcher->release(std::move(d_sort_shadow)); }
 
 size_t
 ShadowSort::hash() const
@@ -31,6 +414,11 @@ bool
 ShadowSort::equals(const Sort& other) const
 {
   ShadowSort* s_sort = checked_cast<ShadowSort*>(other.get());
+  if (d_dispatcher->is_lazy())
+  {
+    /* The sorts of the cross-check solver may not have been created yet. */
+    return d_sort->equals(s_sort->d_sort);
+  }
   return d_sort->equals(s_sort->d_sort)
          && d_sort_shadow->equals(s_sort->d_sort_shadow);
 }
@@ -141,7 +529,9 @@ uint32_t
 ShadowSort::get_bv_size() const
 {
   uint32_t res = d_sort->get_bv_size();
-  MURXLA_TEST(res == d_sort_shadow->get_bv_size());
+  d_dispatcher->run([res, self = shared_from_this()]() {
+    MURXLA_TEST(res == self->d_sort_shadow->get_bv_size());
+  });
   return res;
 }
 
@@ -149,7 +539,9 @@ uint32_t
 ShadowSort::get_fp_exp_size() const
 {
   uint32_t res = d_sort->get_fp_exp_size();
-  MURXLA_TEST(res == d_sort_shadow->get_fp_exp_size());
+  d_dispatcher->run([res, self = shared_from_this()]() {
+    MURXLA_TEST(res == self->d_sort_shadow->get_fp_exp_size());
+  });
   return res;
 }
 
@@ -157,7 +549,9 @@ uint32_t
 ShadowSort::get_fp_sig_size() const
 {
   uint32_t res = d_sort->get_fp_sig_size();
-  MURXLA_TEST(res == d_sort_shadow->get_fp_sig_size());
+  d_dispatcher->run([res, self = shared_from_this()]() {
+    MURXLA_TEST(res == self->d_sort_shadow->get_fp_sig_size());
+  });
   return res;
 }
 
@@ -165,7 +559,9 @@ std::string
 ShadowSort::get_dt_name() const
 {
   std::string res = d_sort->get_dt_name();
-  MURXLA_TEST(res == d_sort_shadow->get_dt_name());
+  d_dispatcher->run([res, self = shared_from_this()]() {
+    MURXLA_TEST(res == self->d_sort_shadow->get_dt_name());
+  });
   return res;
 }
 
@@ -173,7 +569,9 @@ uint32_t
 ShadowSort::get_dt_num_cons() const
 {
   uint32_t res = d_sort->get_dt_num_cons();
-  MURXLA_TEST(res == d_sort_shadow->get_dt_num_cons());
+  d_dispatcher->run([res, self = shared_from_this()]() {
+    MURXLA_TEST(res == self->d_sort_shadow->get_dt_num_cons());
+  });
   return res;
 }
 
@@ -181,7 +579,9 @@ std::vector<std::string>
 ShadowSort::get_dt_cons_names() const
 {
   std::vector<std::string> res = d_sort->get_dt_cons_names();
-  MURXLA_TEST(res == d_sort_shadow->get_dt_cons_names());
+  d_dispatcher->run([res, self = shared_from_this()]() {
+    MURXLA_TEST(res == self->d_sort_shadow->get_dt_cons_names());
+  });
   return res;
 }
 
@@ -189,7 +589,9 @@ uint32_t
 ShadowSort::get_dt_cons_num_sels(const std::string& name) const
 {
   uint32_t res = d_sort->get_dt_cons_num_sels(name);
-  MURXLA_TEST(res == d_sort_shadow->get_dt_cons_num_sels(name));
+  d_dispatcher->run([res, name, self = shared_from_this()]() {
+    MURXLA_TEST(res == self->d_sort_shadow->get_dt_cons_num_sels(name));
+  });
   return res;
 }
 
@@ -197,32 +599,45 @@ std::vector<std::string>
 ShadowSort::get_dt_cons_sel_names(const std::string& name) const
 {
   std::vector<std::string> res = d_sort->get_dt_cons_sel_names(name);
-  MURXLA_TEST(res == d_sort_shadow->get_dt_cons_sel_names(name));
+  d_dispatcher->run([res, name, self = shared_from_this()]() {
+    MURXLA_TEST(res == self->d_sort_shadow->get_dt_cons_sel_names(name));
+  });
   return res;
 }
 
 Sort
 ShadowSort::get_array_index_sort() const
 {
-  std::shared_ptr<ShadowSort> res(new ShadowSort(
-      d_sort->get_array_index_sort(), d_sort_shadow->get_array_index_sort()));
+  auto res = std::make_shared<ShadowSort>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() { res->d_sort = d_sort->get_array_index_sort(); },
+      [res, self = shared_from_this()]() {
+        res->d_sort_shadow = self->d_sort_shadow->get_array_index_sort();
+      });
   return res;
 }
 
 Sort
 ShadowSort::get_array_element_sort() const
 {
-  std::shared_ptr<ShadowSort> res(
-      new ShadowSort(d_sort->get_array_element_sort(),
-                     d_sort_shadow->get_array_element_sort()));
+  auto res = std::make_shared<ShadowSort>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() { res->d_sort = d_sort->get_array_element_sort(); },
+      [res, self = shared_from_this()]() {
+        res->d_sort_shadow = self->d_sort_shadow->get_array_element_sort();
+      });
   return res;
 }
 
 Sort
 ShadowSort::get_bag_element_sort() const
 {
-  std::shared_ptr<ShadowSort> res(new ShadowSort(
-      d_sort->get_bag_element_sort(), d_sort_shadow->get_bag_element_sort()));
+  auto res = std::make_shared<ShadowSort>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() { res->d_sort = d_sort->get_bag_element_sort(); },
+      [res, self = shared_from_this()]() {
+        res->d_sort_shadow = self->d_sort_shadow->get_bag_element_sort();
+      });
   return res;
 }
 
@@ -230,46 +645,65 @@ uint32_t
 ShadowSort::get_fun_arity() const
 {
   uint32_t res = d_sort->get_fun_arity();
-  MURXLA_TEST(res == d_sort_shadow->get_fun_arity());
+  d_dispatcher->run([res, self = shared_from_this()]() {
+    MURXLA_TEST(res == self->d_sort_shadow->get_fun_arity());
+  });
   return res;
 }
 
 Sort
 ShadowSort::get_fun_codomain_sort() const
 {
-  std::shared_ptr<ShadowSort> res(new ShadowSort(
-      d_sort->get_fun_codomain_sort(), d_sort_shadow->get_fun_codomain_sort()));
+  auto res = std::make_shared<ShadowSort>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() { res->d_sort = d_sort->get_fun_codomain_sort(); },
+      [res, self = shared_from_this()]() {
+        res->d_sort_shadow = self->d_sort_shadow->get_fun_codomain_sort();
+      });
   return res;
 }
 
 std::vector<Sort>
 ShadowSort::get_fun_domain_sorts() const
 {
-  std::vector<Sort> sorts        = d_sort->get_fun_domain_sorts();
-  std::vector<Sort> sorts_shadow = d_sort_shadow->get_fun_domain_sorts();
-  MURXLA_TEST(sorts.size() == sorts_shadow.size());
   std::vector<Sort> res;
-  for (size_t i = 0, n = sorts.size(); i < n; ++i)
+  for (const Sort& s : d_sort->get_fun_domain_sorts())
   {
-    res.push_back(
-        std::shared_ptr<ShadowSort>(new ShadowSort(sorts[i], sorts_shadow[i])));
+    res.push_back(std::make_shared<ShadowSort>(s, nullptr, d_dispatcher));
   }
+  d_dispatcher->run([res, self = shared_from_this()]() {
+    std::vector<Sort> sorts_shadow =
+        self->d_sort_shadow->get_fun_domain_sorts();
+    MURXLA_TEST(res.size() == sorts_shadow.size());
+    for (size_t i = 0, n = res.size(); i < n; ++i)
+    {
+      checked_cast<ShadowSort*>(res[i].get())->d_sort_shadow = sorts_shadow[i];
+    }
+  });
   return res;
 }
 
 Sort
 ShadowSort::get_seq_element_sort() const
 {
-  std::shared_ptr<ShadowSort> res(new ShadowSort(
-      d_sort->get_seq_element_sort(), d_sort_shadow->get_seq_element_sort()));
+  auto res = std::make_shared<ShadowSort>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() { res->d_sort = d_sort->get_seq_element_sort(); },
+      [res, self = shared_from_this()]() {
+        res->d_sort_shadow = self->d_sort_shadow->get_seq_element_sort();
+      });
   return res;
 }
 
 Sort
 ShadowSort::get_set_element_sort() const
 {
-  std::shared_ptr<ShadowSort> res(new ShadowSort(
-      d_sort->get_set_element_sort(), d_sort_shadow->get_set_element_sort()));
+  auto res = std::make_shared<ShadowSort>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() { res->d_sort = d_sort->get_set_element_sort(); },
+      [res, self = shared_from_this()]() {
+        res->d_sort_shadow = self->d_sort_shadow->get_set_element_sort();
+      });
   return res;
 }
 
@@ -277,7 +711,9 @@ void
 ShadowSort::set_kind(SortKind sort_kind)
 {
   d_sort->set_kind(sort_kind);
-  d_sort_shadow->set_kind(sort_kind);
+  d_dispatcher->run([sort_kind, self = shared_from_this()]() {
+    self->d_sort_shadow->set_kind(sort_kind);
+  });
   d_kind = sort_kind;
 }
 
@@ -287,55 +723,34 @@ ShadowSort::set_sorts(const std::vector<Sort>& sorts)
   std::vector<Sort> sorts_orig, sorts_shadow;
   ShadowSolver::get_sorts_helper(sorts, sorts_orig, sorts_shadow);
   d_sort->set_sorts(sorts_orig);
-  d_sort_shadow->set_sorts(sorts_shadow);
+  d_dispatcher->run([sorts, self = shared_from_this()]() {
+    std::vector<Sort> sorts_orig, sorts_shadow;
+    ShadowSolver::get_sorts_helper(sorts, sorts_orig, sorts_shadow);
+    self->d_sort_shadow->set_sorts(sorts_shadow);
+  });
   d_sorts = sorts;
 }
 
 void
 ShadowSort::set_associated_sort(Sort sort)
 {
-  ShadowSort* s = checked_cast<ShadowSort*>(sort.get());
-  d_sort->set_associated_sort(s->d_sort);
-  d_sort_shadow->set_associated_sort(s->d_sort_shadow);
+  d_sort->set_associated_sort(get_sort_orig(sort));
+  d_dispatcher->run([sort, self = shared_from_this()]() {
+    self->d_sort_shadow->set_associated_sort(shadow::get_sort_shadow(sort));
+  });
 }
 
 void
 ShadowSort::set_dt_ctors(const DatatypeConstructorMap& ctors)
 {
   DatatypeConstructorMap ctors_orig, ctors_shadow;
-
-  for (const auto& c : ctors)
-  {
-    const auto& cname   = c.first;
-    ctors_orig[cname]   = {};
-    ctors_shadow[cname] = {};
-
-    const auto& sels = c.second;
-    for (const auto& s : sels)
-    {
-      const auto& sname  = s.first;
-      auto& sel_sort     = s.second;
-      Sort sel_sort_orig = sel_sort, sel_sort_shadow = sel_sort;
-      if (sel_sort && !sel_sort->is_param_sort())
-      {
-        if (sel_sort->is_unresolved_sort())
-        {
-          ShadowSolver::get_unresolved_sort_helper(
-              sel_sort, sel_sort_orig, sel_sort_shadow);
-        }
-        else
-        {
-          ShadowSort* sort = checked_cast<ShadowSort*>(sel_sort.get());
-          sel_sort_orig    = sort->get_sort();
-          sel_sort_shadow  = sort->get_sort_shadow();
-        }
-      }
-      ctors_orig[cname].emplace_back(sname, sel_sort_orig);
-      ctors_shadow[cname].emplace_back(sname, sel_sort_shadow);
-    }
-  }
+  get_ctors_helper(ctors, ctors_orig, ctors_shadow);
   d_sort->set_dt_ctors(ctors_orig);
-  d_sort_shadow->set_dt_ctors(ctors_shadow);
+  d_dispatcher->run([ctors, self = shared_from_this()]() {
+    DatatypeConstructorMap ctors_orig, ctors_shadow;
+    get_ctors_helper(ctors, ctors_orig, ctors_shadow);
+    self->d_sort_shadow->set_dt_ctors(ctors_shadow);
+  });
   d_dt_ctors = ctors;
 }
 
@@ -344,17 +759,28 @@ ShadowSort::set_dt_is_instantiated(bool value)
 {
   AbsSort::set_dt_is_instantiated(value);
   d_sort->set_dt_is_instantiated(value);
-  d_sort_shadow->set_dt_is_instantiated(value);
+  d_dispatcher->run([value, self = shared_from_this()]() {
+    self->d_sort_shadow->set_dt_is_instantiated(value);
+  });
 }
 
-ShadowTerm::ShadowTerm(Term term, Term term_shadow)
-    : d_term(term), d_term_shadow(term_shadow){};
+/* -------------------------------------------------------------------------- */
+
+ShadowTerm::ShadowTerm(Term term,
+                       Term term_shadow,
+                       const std::shared_ptr<ShadowDispatcher>& dispatcher)
+    : d_term(term), d_term_shadow(term_shadow), d_dispatcher(dispatcher){};
 
-ShadowTerm::~ShadowTerm() {}
+ShadowTerm::~ShadowTerm() { d_dispatcher->release(std::move(d_term_shadow)); }
 
 size_t
 ShadowTerm::hash() const
 {
+  if (d_dispatcher->is_lazy())
+  {
+    /* The terms of the cross-check solver may not have been created yet. */
+    return d_term->hash();
+  }
   return d_term->hash() + d_term_shadow->hash();
 }
 bool
@@ -363,6 +789,10 @@ ShadowTerm::equals(const Term& other) const
   ShadowTerm* s_term = checked_cast<ShadowTerm*>(other.get());
   if (s_term)
   {
+    if (d_dispatcher->is_lazy())
+    {
+      return d_term->equals(s_term->d_term);
+    }
     return d_term->equals(s_term->d_term)
            && d_term_shadow->equals(s_term->d_term_shadow);
   }
@@ -491,31 +921,19 @@ ShadowTerm::is_const() const
   return d_term->is_const();
 }
 
+
 void
 ShadowTerm::set_sort(Sort sort)
 {
   AbsTerm::set_sort(sort);
   Sort sort_orig, sort_shadow;
-  if (sort)
-  {
-    if (sort->is_param_sort())
-    {
-      ShadowSolver::get_param_sort_helper(sort, sort_orig, sort_shadow);
-    }
-    else if (sort->is_unresolved_sort())
-    {
-      ShadowSolver::get_unresolved_sort_helper(sort, sort_orig, sort_shadow);
-    }
-    else
-    {
-      ShadowSort* s = checked_cast<ShadowSort*>(sort.get());
-      assert(s);
-      sort_orig   = s->get_sort();
-      sort_shadow = s->get_sort_shadow();
-    }
-  }
+  get_sort_helper(sort, sort_orig, sort_shadow);
   d_term->set_sort(sort_orig);
-  d_term_shadow->set_sort(sort_shadow);
+  d_dispatcher->run([sort, self = shared_from_this()]() {
+    Sort sort_orig, sort_shadow;
+    get_sort_helper(sort, sort_orig, sort_shadow);
+    self->d_term_shadow->set_sort(sort_shadow);
+  });
 }
 
 void
@@ -523,7 +941,9 @@ ShadowTerm::set_special_value_kind(const SpecialValueKind& value_kind)
 {
   AbsTerm::set_special_value_kind(value_kind);
   d_term->set_special_value_kind(value_kind);
-  d_term_shadow->set_special_value_kind(value_kind);
+  d_dispatcher->run([value_kind, self = shared_from_this()]() {
+    self->d_term_shadow->set_special_value_kind(value_kind);
+  });
 }
 
 void
@@ -531,18 +951,31 @@ ShadowTerm::set_leaf_kind(LeafKind kind)
 {
   AbsTerm::set_leaf_kind(kind);
   d_term->set_leaf_kind(kind);
-  d_term_shadow->set_leaf_kind(kind);
+  d_dispatcher->run([kind, self = shared_from_this()]() {
+    self->d_term_shadow->set_leaf_kind(kind);
+  });
 }
 
+/* -------------------------------------------------------------------------- */
+
 ShadowSolver::ShadowSolver(SolverSeedGenerator& sng,
                            Solver* solver,
-                           Solver* solver_shadow)
+                           Solver* solver_shadow,
+                           bool threaded,
+                           bool lazy,
+                           uint32_t sample_prob)
     : Solver(sng),
       d_solver(solver),
       d_solver_shadow(solver_shadow),
-      d_same_solver(solver->get_name() == solver_shadow->get_name()){};
+      d_same_solver(solver->get_name() == solver_shadow->get_name()),
+      d_dispatcher(std::make_shared<ShadowDispatcher>(threaded, lazy)),
+      d_sample_prob(sample_prob){};
 
-ShadowSolver::~ShadowSolver(){};
+ShadowSolver::~ShadowSolver()
+{
+  d_dispatcher->discard();
+  d_dispatcher->sync([&]() { d_solver_shadow.reset(nullptr); }, false);
+}
 
 void
 ShadowSolver::get_sorts_helper(const std::vector<Sort>& sorts,
@@ -686,17 +1119,26 @@ ShadowSolver::get_terms_helper(const std::vector<Term>& terms,
 void
 ShadowSolver::new_solver()
 {
-  d_solver->new_solver();
-  d_solver_shadow->new_solver();
+  d_dispatcher->sync([&]() { d_solver->new_solver(); },
+                     [&]() { d_solver_shadow->new_solver(); },
+                     false);
 }
 
 void
 ShadowSolver::delete_solver()
 {
-  d_solver->delete_solver();
-  d_solver_shadow->delete_solver();
-  d_solver.reset(nullptr);
-  d_solver_shadow.reset(nullptr);
+  /* Calls that were not executed yet are not needed anymore. */
+  d_dispatcher->discard();
+  d_dispatcher->sync(
+      [&]() {
+        d_solver->delete_solver();
+        d_solver.reset(nullptr);
+      },
+      [&]() {
+        d_solver_shadow->delete_solver();
+        d_solver_shadow.reset(nullptr);
+      },
+      false);
 }
 
 bool
@@ -724,22 +1166,26 @@ ShadowSolver::get_profile() const
 Term
 ShadowSolver::mk_var(Sort sort, const std::string& name)
 {
-  ShadowSort* s = checked_cast<ShadowSort*>(sort.get());
-  assert(s);
-  Term t        = d_solver->mk_var(s->d_sort, name);
-  Term t_shadow = d_solver_shadow->mk_var(s->d_sort_shadow, name);
-  std::shared_ptr<ShadowTerm> res(new ShadowTerm(t, t_shadow));
+  auto res = std::make_shared<ShadowTerm>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() { res->d_term = d_solver->mk_var(get_sort_orig(sort), name); },
+      [this, res, sort, name]() {
+        res->d_term_shadow =
+            d_solver_shadow->mk_var(get_sort_shadow(sort), name);
+      });
   return res;
 }
 
 Term
 ShadowSolver::mk_const(Sort sort, const std::string& name)
 {
-  ShadowSort* s = checked_cast<ShadowSort*>(sort.get());
-  assert(s);
-  Term t        = d_solver->mk_const(s->d_sort, name);
-  Term t_shadow = d_solver_shadow->mk_const(s->d_sort_shadow, name);
-  std::shared_ptr<ShadowTerm> res(new ShadowTerm(t, t_shadow));
+  auto res = std::make_shared<ShadowTerm>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() { res->d_term = d_solver->mk_const(get_sort_orig(sort), name); },
+      [this, res, sort, name]() {
+        res->d_term_shadow =
+            d_solver_shadow->mk_const(get_sort_shadow(sort), name);
+      });
   return res;
 }
 
@@ -748,36 +1194,42 @@ ShadowSolver::mk_fun(const std::string& name,
                      const std::vector<Term>& args,
                      Term body)
 {
-  ShadowTerm* term = checked_cast<ShadowTerm*>(body.get());
-  assert(term);
-  std::vector<Term> terms_orig, terms_shadow;
-  get_terms_helper(args, terms_orig, terms_shadow);
-  Term t = d_solver->mk_fun(name, terms_orig, term->get_term());
-  Term t_shadow =
-      d_solver_shadow->mk_fun(name, terms_shadow, term->get_term_shadow());
-  std::shared_ptr<ShadowTerm> res(new ShadowTerm(t, t_shadow));
+  auto res = std::make_shared<ShadowTerm>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() {
+        res->d_term = d_solver->mk_fun(
+            name, get_terms_orig(args), get_term_orig(body));
+      },
+      [this, res, name, args, body]() {
+        res->d_term_shadow = d_solver_shadow->mk_fun(
+            name, get_terms_shadow(args), get_term_shadow(body));
+      });
   return res;
 }
 
 Term
 ShadowSolver::mk_value(Sort sort, bool value)
 {
-  ShadowSort* s = checked_cast<ShadowSort*>(sort.get());
-  assert(s);
-  Term t        = d_solver->mk_value(s->d_sort, value);
-  Term t_shadow = d_solver_shadow->mk_value(s->d_sort_shadow, value);
-  std::shared_ptr<ShadowTerm> res(new ShadowTerm(t, t_shadow));
+  auto res = std::make_shared<ShadowTerm>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() { res->d_term = d_solver->mk_value(get_sort_orig(sort), value); },
+      [this, res, sort, value]() {
+        res->d_term_shadow =
+            d_solver_shadow->mk_value(get_sort_shadow(sort), value);
+      });
   return res;
 }
 
 Term
 ShadowSolver::mk_value(Sort sort, const std::string& value)
 {
-  ShadowSort* s = checked_cast<ShadowSort*>(sort.get());
-  assert(s);
-  Term t        = d_solver->mk_value(s->d_sort, value);
-  Term t_shadow = d_solver_shadow->mk_value(s->d_sort_shadow, value);
-  std::shared_ptr<ShadowTerm> res(new ShadowTerm(t, t_shadow));
+  auto res = std::make_shared<ShadowTerm>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() { res->d_term = d_solver->mk_value(get_sort_orig(sort), value); },
+      [this, res, sort, value]() {
+        res->d_term_shadow =
+            d_solver_shadow->mk_value(get_sort_shadow(sort), value);
+      });
   return res;
 }
 
@@ -786,22 +1238,30 @@ ShadowSolver::mk_value(Sort sort,
                        const std::string& num,
                        const std::string& den)
 {
-  ShadowSort* s = checked_cast<ShadowSort*>(sort.get());
-  assert(s);
-  Term t        = d_solver->mk_value(s->d_sort, num, den);
-  Term t_shadow = d_solver_shadow->mk_value(s->d_sort_shadow, num, den);
-  std::shared_ptr<ShadowTerm> res(new ShadowTerm(t, t_shadow));
+  auto res = std::make_shared<ShadowTerm>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() {
+        res->d_term = d_solver->mk_value(get_sort_orig(sort), num, den);
+      },
+      [this, res, sort, num, den]() {
+        res->d_term_shadow =
+            d_solver_shadow->mk_value(get_sort_shadow(sort), num, den);
+      });
   return res;
 }
 
 Term
 ShadowSolver::mk_value(Sort sort, const std::string& value, Base base)
 {
-  ShadowSort* s = checked_cast<ShadowSort*>(sort.get());
-  assert(s);
-  Term t        = d_solver->mk_value(s->d_sort, value, base);
-  Term t_shadow = d_solver_shadow->mk_value(s->d_sort_shadow, value, base);
-  std::shared_ptr<ShadowTerm> res(new ShadowTerm(t, t_shadow));
+  auto res = std::make_shared<ShadowTerm>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() {
+        res->d_term = d_solver->mk_value(get_sort_orig(sort), value, base);
+      },
+      [this, res, sort, value, base]() {
+        res->d_term_shadow =
+            d_solver_shadow->mk_value(get_sort_shadow(sort), value, base);
+      });
   return res;
 }
 
@@ -809,58 +1269,81 @@ Term
 ShadowSolver::mk_special_value(Sort sort,
                                const AbsTerm::SpecialValueKind& value)
 {
-  ShadowSort* s = checked_cast<ShadowSort*>(sort.get());
-  assert(s);
-  Term t        = d_solver->mk_special_value(s->d_sort, value);
-  Term t_shadow = d_solver_shadow->mk_special_value(s->d_sort_shadow, value);
-  std::shared_ptr<ShadowTerm> res(new ShadowTerm(t, t_shadow));
+  auto res = std::make_shared<ShadowTerm>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() {
+        res->d_term = d_solver->mk_special_value(get_sort_orig(sort), value);
+      },
+      [this, res, sort, value]() {
+        res->d_term_shadow =
+            d_solver_shadow->mk_special_value(get_sort_shadow(sort), value);
+      });
   return res;
 }
 
 Sort
 ShadowSolver::mk_sort(const std::string& name)
 {
-  Sort s        = d_solver->mk_sort(name);
-  Sort s_shadow = d_solver_shadow->mk_sort(name);
-  std::shared_ptr<ShadowSort> res(new ShadowSort(s, s_shadow));
+  auto res = std::make_shared<ShadowSort>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() { res->d_sort = d_solver->mk_sort(name); },
+      [this, res, name]() {
+        res->d_sort_shadow = d_solver_shadow->mk_sort(name);
+      });
   return res;
 }
 
 Sort
 ShadowSolver::mk_sort(SortKind kind)
 {
-  Sort s        = d_solver->mk_sort(kind);
-  Sort s_shadow = d_solver_shadow->mk_sort(kind);
-  std::shared_ptr<ShadowSort> res(new ShadowSort(s, s_shadow));
+  auto res = std::make_shared<ShadowSort>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() { res->d_sort = d_solver->mk_sort(kind); },
+      [this, res, kind]() {
+        res->d_sort_shadow = d_solver_shadow->mk_sort(kind);
+      });
   return res;
 }
 
 Sort
 ShadowSolver::mk_sort(SortKind kind, uint32_t size)
 {
-  Sort s        = d_solver->mk_sort(kind, size);
-  Sort s_shadow = d_solver_shadow->mk_sort(kind, size);
-  std::shared_ptr<ShadowSort> res(new ShadowSort(s, s_shadow));
+  auto res = std::make_shared<ShadowSort>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() { res->d_sort = d_solver->mk_sort(kind, size); },
+      [this, res, kind, size]() {
+        res->d_sort_shadow = d_solver_shadow->mk_sort(kind, size);
+      });
   return res;
 }
 
 Sort
 ShadowSolver::mk_sort(SortKind kind, uint32_t esize, uint32_t ssize)
 {
-  Sort s        = d_solver->mk_sort(kind, esize, ssize);
-  Sort s_shadow = d_solver_shadow->mk_sort(kind, esize, ssize);
-  std::shared_ptr<ShadowSort> res(new ShadowSort(s, s_shadow));
+  auto res = std::make_shared<ShadowSort>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() { res->d_sort = d_solver->mk_sort(kind, esize, ssize); },
+      [this, res, kind, esize, ssize]() {
+        res->d_sort_shadow = d_solver_shadow->mk_sort(kind, esize, ssize);
+      });
   return res;
 }
 
 Sort
 ShadowSolver::mk_sort(SortKind kind, const std::vector<Sort>& sorts)
 {
-  std::vector<Sort> sorts_orig, sorts_shadow;
-  get_sorts_helper(sorts, sorts_orig, sorts_shadow);
-  Sort s        = d_solver->mk_sort(kind, sorts_orig);
-  Sort s_shadow = d_solver_shadow->mk_sort(kind, sorts_shadow);
-  std::shared_ptr<ShadowSort> res(new ShadowSort(s, s_shadow));
+  auto res = std::make_shared<ShadowSort>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() {
+        std::vector<Sort> sorts_orig, sorts_shadow;
+        get_sorts_helper(sorts, sorts_orig, sorts_shadow);
+        res->d_sort = d_solver->mk_sort(kind, sorts_orig);
+      },
+      [this, res, kind, sorts]() {
+        std::vector<Sort> sorts_orig, sorts_shadow;
+        get_sorts_helper(sorts, sorts_orig, sorts_shadow);
+        res->d_sort_shadow = d_solver_shadow->mk_sort(kind, sorts_shadow);
+      });
   return res;
 }
 
@@ -874,78 +1357,67 @@ ShadowSolver::mk_sort(
   size_t n_dt_sorts = dt_names.size();
   assert(n_dt_sorts == param_sorts.size());
   assert(n_dt_sorts == constructors.size());
-  std::vector<std::vector<Sort>> param_sorts_orig;
-  std::vector<std::vector<Sort>> param_sorts_shadow;
-  std::vector<AbsSort::DatatypeConstructorMap> constructors_orig;
-  std::vector<AbsSort::DatatypeConstructorMap> constructors_shadow;
 
+  std::vector<Sort> res;
   for (size_t i = 0; i < n_dt_sorts; ++i)
   {
-    AbsSort::DatatypeConstructorMap ctors_orig;
-    AbsSort::DatatypeConstructorMap ctors_shadow;
-    for (const auto& c : constructors[i])
-    {
-      const auto& cname   = c.first;
-      const auto& sels    = c.second;
-      ctors_orig[cname]   = {};
-      ctors_shadow[cname] = {};
+    res.push_back(std::make_shared<ShadowSort>(nullptr, nullptr, d_dispatcher));
+  }
 
-      for (const auto& s : sels)
-      {
-        const auto& sname  = s.first;
-        auto& sel_sort     = s.second;
-        Sort sel_sort_orig = sel_sort, sel_sort_shadow = sel_sort;
-        if (sel_sort && !sel_sort->is_param_sort())
+  d_dispatcher->run(
+      [&]() {
+        std::vector<AbsSort::DatatypeConstructorMap> constructors_orig;
+        for (const auto& ctors : constructors)
         {
-          if (sel_sort->is_unresolved_sort())
-          {
-            get_unresolved_sort_helper(
-                sel_sort, sel_sort_orig, sel_sort_shadow);
-          }
-          else
-          {
-            ShadowSort* sort = checked_cast<ShadowSort*>(sel_sort.get());
-            sel_sort_orig    = sort->get_sort();
-            sel_sort_shadow  = sort->get_sort_shadow();
-          }
+          AbsSort::DatatypeConstructorMap ctors_orig, ctors_shadow;
+          get_ctors_helper(ctors, ctors_orig, ctors_shadow);
+          constructors_orig.push_back(ctors_orig);
         }
-        ctors_orig[cname].emplace_back(sname, sel_sort_orig);
-        ctors_shadow[cname].emplace_back(sname, sel_sort_shadow);
-      }
-    }
-    constructors_orig.push_back(ctors_orig);
-    constructors_shadow.push_back(ctors_shadow);
-  }
-
-  std::vector<Sort> res_orig =
-      d_solver->mk_sort(kind, dt_names, param_sorts, constructors_orig);
-  std::vector<Sort> res_shadow = d_solver_shadow->mk_sort(
-      kind, dt_names, param_sorts, constructors_shadow);
-  MURXLA_TEST(res_orig.size() == n_dt_sorts);
-  MURXLA_TEST(res_orig.size() == res_shadow.size());
-  std::vector<Sort> res;
-  for (size_t i = 0; i < n_dt_sorts; ++i)
-  {
-    res.push_back(std::shared_ptr<ShadowSort>(
-        new ShadowSort(res_orig[i], res_shadow[i])));
-  }
+        std::vector<Sort> res_orig =
+            d_solver->mk_sort(kind, dt_names, param_sorts, constructors_orig);
+        MURXLA_TEST(res_orig.size() == n_dt_sorts);
+        for (size_t i = 0; i < n_dt_sorts; ++i)
+        {
+          checked_cast<ShadowSort*>(res[i].get())->d_sort = res_orig[i];
+        }
+      },
+      [this, res, kind, dt_names, param_sorts, constructors]() {
+        std::vector<AbsSort::DatatypeConstructorMap> constructors_shadow;
+        for (const auto& ctors : constructors)
+        {
+          AbsSort::DatatypeConstructorMap ctors_orig, ctors_shadow;
+          get_ctors_helper(ctors, ctors_orig, ctors_shadow);
+          constructors_shadow.push_back(ctors_shadow);
+        }
+        std::vector<Sort> res_shadow = d_solver_shadow->mk_sort(
+            kind, dt_names, param_sorts, constructors_shadow);
+        MURXLA_TEST(res.size() == res_shadow.size());
+        for (size_t i = 0, n = res.size(); i < n; ++i)
+        {
+          checked_cast<ShadowSort*>(res[i].get())->d_sort_shadow =
+              res_shadow[i];
+        }
+      });
   return res;
 }
 
 Sort
 ShadowSolver::instantiate_sort(Sort param_sort, const std::vector<Sort>& sorts)
 {
-  ShadowSort* sort       = checked_cast<ShadowSort*>(param_sort.get());
-  Sort param_sort_orig   = sort->get_sort();
-  Sort param_sort_shadow = sort->get_sort_shadow();
-
-  std::vector<Sort> sorts_orig, sorts_shadow;
-  get_sorts_helper(sorts, sorts_orig, sorts_shadow);
-
-  Sort s_orig   = d_solver->instantiate_sort(param_sort_orig, sorts_orig);
-  Sort s_shadow = d_solver->instantiate_sort(param_sort_shadow, sorts_shadow);
-
-  std::shared_ptr<ShadowSort> res(new ShadowSort(s_orig, s_shadow));
+  auto res = std::make_shared<ShadowSort>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() {
+        std::vector<Sort> sorts_orig, sorts_shadow;
+        get_sorts_helper(sorts, sorts_orig, sorts_shadow);
+        res->d_sort =
+            d_solver->instantiate_sort(get_sort_orig(param_sort), sorts_orig);
+      },
+      [this, res, param_sort, sorts]() {
+        std::vector<Sort> sorts_orig, sorts_shadow;
+        get_sorts_helper(sorts, sorts_orig, sorts_shadow);
+        res->d_sort_shadow = d_solver_shadow->instantiate_sort(
+            get_sort_shadow(param_sort), sorts_shadow);
+      });
   return res;
 }
 
@@ -954,11 +1426,15 @@ ShadowSolver::mk_term(const Op::Kind& kind,
                       const std::vector<Term>& args,
                       const std::vector<uint32_t>& indices)
 {
-  std::vector<Term> terms_orig, terms_shadow;
-  get_terms_helper(args, terms_orig, terms_shadow);
-  Term t        = d_solver->mk_term(kind, terms_orig, indices);
-  Term t_shadow = d_solver_shadow->mk_term(kind, terms_shadow, indices);
-  std::shared_ptr<ShadowTerm> res(new ShadowTerm(t, t_shadow));
+  auto res = std::make_shared<ShadowTerm>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() {
+        res->d_term = d_solver->mk_term(kind, get_terms_orig(args), indices);
+      },
+      [this, res, kind, args, indices]() {
+        res->d_term_shadow =
+            d_solver_shadow->mk_term(kind, get_terms_shadow(args), indices);
+      });
   return res;
 }
 
@@ -967,11 +1443,15 @@ ShadowSolver::mk_term(const Op::Kind& kind,
                       const std::vector<std::string>& str_args,
                       const std::vector<Term>& args)
 {
-  std::vector<Term> terms_orig, terms_shadow;
-  get_terms_helper(args, terms_orig, terms_shadow);
-  Term t        = d_solver->mk_term(kind, str_args, terms_orig);
-  Term t_shadow = d_solver_shadow->mk_term(kind, str_args, terms_shadow);
-  std::shared_ptr<ShadowTerm> res(new ShadowTerm(t, t_shadow));
+  auto res = std::make_shared<ShadowTerm>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() {
+        res->d_term = d_solver->mk_term(kind, str_args, get_terms_orig(args));
+      },
+      [this, res, kind, str_args, args]() {
+        res->d_term_shadow =
+            d_solver_shadow->mk_term(kind, str_args, get_terms_shadow(args));
+      });
   return res;
 }
 
@@ -981,26 +1461,31 @@ ShadowSolver::mk_term(const Op::Kind& kind,
                       const std::vector<std::string>& str_args,
                       const std::vector<Term>& args)
 {
-  ShadowSort* s_sort = checked_cast<ShadowSort*>(sort.get());
-  Sort sort_orig     = s_sort->get_sort();
-  Sort sort_shadow   = s_sort->get_sort_shadow();
-  std::vector<Term> terms_orig, terms_shadow;
-  get_terms_helper(args, terms_orig, terms_shadow);
-  Term t = d_solver->mk_term(kind, sort_orig, str_args, terms_orig);
-  Term t_shadow =
-      d_solver_shadow->mk_term(kind, sort_shadow, str_args, terms_shadow);
-  std::shared_ptr<ShadowTerm> res(new ShadowTerm(t, t_shadow));
+  auto res = std::make_shared<ShadowTerm>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() {
+        res->d_term = d_solver->mk_term(
+            kind, get_sort_orig(sort), str_args, get_terms_orig(args));
+      },
+      [this, res, kind, sort, str_args, args]() {
+        res->d_term_shadow = d_solver_shadow->mk_term(
+            kind, get_sort_shadow(sort), str_args, get_terms_shadow(args));
+      });
   return res;
 }
 
 Sort
 ShadowSolver::get_sort(Term term, SortKind sort_kind)
 {
-  ShadowTerm* t = checked_cast<ShadowTerm*>(term.get());
-  assert(t);
-  Sort s        = d_solver->get_sort(t->get_term(), sort_kind);
-  Sort s_shadow = d_solver_shadow->get_sort(t->get_term_shadow(), sort_kind);
-  std::shared_ptr<ShadowSort> res(new ShadowSort(s, s_shadow));
+  auto res = std::make_shared<ShadowSort>(nullptr, nullptr, d_dispatcher);
+  d_dispatcher->run(
+      [&]() {
+        res->d_sort = d_solver->get_sort(get_term_orig(term), sort_kind);
+      },
+      [this, res, term, sort_kind]() {
+        res->d_sort_shadow =
+            d_solver_shadow->get_sort(get_term_shadow(term), sort_kind);
+      });
   return res;
 }
 
@@ -1059,13 +1544,16 @@ ShadowSolver::option_unsat_cores_enabled() const
 bool
 ShadowSolver::is_unsat_assumption(const Term& t) const
 {
-  ShadowTerm* term = checked_cast<ShadowTerm*>(t.get());
-  assert(term);
-  bool res = d_solver->is_unsat_assumption(term->get_term());
-  if (d_same_solver)
+  bool res = d_solver->is_unsat_assumption(get_term_orig(t));
+  /* In lazy mode, the cross-check solver may not be in the same state. */
+  if (d_same_solver && d_dispatcher->is_synced())
   {
-    assert(res
-           == d_solver_shadow->is_unsat_assumption(term->get_term_shadow()));
+    d_dispatcher->sync(
+        [&]() {
+          assert(res
+                 == d_solver_shadow->is_unsat_assumption(get_term_shadow(t)));
+        },
+        false);
   }
   return res;
 }
@@ -1073,39 +1561,58 @@ ShadowSolver::is_unsat_assumption(const Term& t) const
 void
 ShadowSolver::assert_formula(const Term& t)
 {
-  ShadowTerm* term = checked_cast<ShadowTerm*>(t.get());
-  assert(term);
-  d_solver->assert_formula(term->get_term());
-  d_solver_shadow->assert_formula(term->get_term_shadow());
+  d_dispatcher->run(
+      [&]() { d_solver->assert_formula(get_term_orig(t)); },
+      [this, t]() { d_solver_shadow->assert_formula(get_term_shadow(t)); });
 }
 
 Solver::Result
 ShadowSolver::check_sat()
 {
-  Result res_orig   = d_solver->check_sat();
-  Result res_shadow = d_solver_shadow->check_sat();
-  if (res_orig != Result::UNKNOWN && res_shadow != Result::UNKNOWN)
+  Result res_orig, res_shadow;
+  if (d_dispatcher->is_lazy() && d_sample_prob < MURXLA_PROB_MAX
+      && !d_rng.pick_with_prob(d_sample_prob))
   {
-    MURXLA_TEST(res_orig == res_shadow)
-        << "Solver reports " << res_orig << " while cross-check solver reports "
-        << res_shadow;
+    /* Not cross-checked, only needed if the cross-check solver is queried. */
+    res_orig = d_solver->check_sat();
+    d_dispatcher->record_check_sat([this, res_orig]() {
+      check_result(res_orig, d_solver_shadow->check_sat());
+    });
+    return res_orig;
   }
+  d_dispatcher->sync([&]() { res_orig = d_solver->check_sat(); },
+                     [&]() { res_shadow = d_solver_shadow->check_sat(); },
+                     false);
+  check_result(res_orig, res_shadow);
   return res_orig;
 }
 
 Solver::Result
 ShadowSolver::check_sat_assuming(const std::vector<Term>& assumptions)
 {
-  std::vector<Term> assumptions_orig, assumptions_shadow;
-  get_terms_helper(assumptions, assumptions_orig, assumptions_shadow);
-  Result res_orig   = d_solver->check_sat_assuming(assumptions_orig);
-  Result res_shadow = d_solver_shadow->check_sat_assuming(assumptions_shadow);
-  if (res_orig != Result::UNKNOWN && res_shadow != Result::UNKNOWN)
+  Result res_orig, res_shadow;
+  if (d_dispatcher->is_lazy() && d_sample_prob < MURXLA_PROB_MAX
+      && !d_rng.pick_with_prob(d_sample_prob))
   {
-    MURXLA_TEST(res_orig == res_shadow)
-        << "Solver reports " << res_orig << " while cross-check solver reports "
-        << res_shadow;
+    /* Not cross-checked, only needed if the cross-check solver is queried. */
+    res_orig = d_solver->check_sat_assuming(get_terms_orig(assumptions));
+    d_dispatcher->record_check_sat([this, res_orig, assumptions]() {
+      check_result(res_orig,
+                   d_solver_shadow->check_sat_assuming(
+                       get_terms_shadow(assumptions)));
+    });
+    return res_orig;
   }
+  d_dispatcher->sync(
+      [&]() {
+        res_orig = d_solver->check_sat_assuming(get_terms_orig(assumptions));
+      },
+      [&]() {
+        res_shadow =
+            d_solver_shadow->check_sat_assuming(get_terms_shadow(assumptions));
+      },
+      false);
+  check_result(res_orig, res_shadow);
   return res_orig;
 }
 
@@ -1113,13 +1620,16 @@ std::vector<Term>
 ShadowSolver::get_unsat_assumptions()
 {
   assert(d_same_solver);
-  std::vector<Term> res, terms, terms_shadow;
-  auto ua_orig   = d_solver->get_unsat_assumptions();
-  auto ua_shadow = d_solver_shadow->get_unsat_assumptions();
+  std::vector<Term> res, ua_orig, ua_shadow;
+  d_dispatcher->sync(
+      [&]() { ua_orig = d_solver->get_unsat_assumptions(); },
+      [&]() { ua_shadow = d_solver_shadow->get_unsat_assumptions(); },
+      true);
   assert(ua_orig.size() == ua_shadow.size());
   for (size_t i = 0; i < ua_orig.size(); ++i)
   {
-    res.emplace_back(new ShadowTerm(ua_orig[i], ua_shadow[i]));
+    res.push_back(
+        std::make_shared<ShadowTerm>(ua_orig[i], ua_shadow[i], d_dispatcher));
   }
   return res;
 }
@@ -1128,13 +1638,15 @@ std::vector<Term>
 ShadowSolver::get_unsat_core()
 {
   assert(d_same_solver);
-  std::vector<Term> res, terms, terms_shadow;
-  auto uc_orig   = d_solver->get_unsat_core();
-  auto uc_shadow = d_solver_shadow->get_unsat_core();
+  std::vector<Term> res, uc_orig, uc_shadow;
+  d_dispatcher->sync([&]() { uc_orig = d_solver->get_unsat_core(); },
+                     [&]() { uc_shadow = d_solver_shadow->get_unsat_core(); },
+                     true);
   assert(uc_orig.size() == uc_shadow.size());
   for (size_t i = 0; i < uc_orig.size(); ++i)
   {
-    res.emplace_back(new ShadowTerm(uc_orig[i], uc_shadow[i]));
+    res.push_back(
+        std::make_shared<ShadowTerm>(uc_orig[i], uc_shadow[i], d_dispatcher));
   }
   return res;
 }
@@ -1142,66 +1654,73 @@ ShadowSolver::get_unsat_core()
 void
 ShadowSolver::push(uint32_t n_levels)
 {
-  d_solver->push(n_levels);
-  d_solver_shadow->push(n_levels);
+  d_dispatcher->run([&]() { d_solver->push(n_levels); },
+                    [this, n_levels]() { d_solver_shadow->push(n_levels); });
 }
 
 void
 ShadowSolver::pop(uint32_t n_levels)
 {
-  d_solver->pop(n_levels);
-  d_solver_shadow->pop(n_levels);
+  d_dispatcher->run([&]() { d_solver->pop(n_levels); },
+                    [this, n_levels]() { d_solver_shadow->pop(n_levels); });
 }
 
 void
 ShadowSolver::print_model()
 {
+  /* Not concurrently, to not interleave the output of both solvers. */
   d_solver->print_model();
-  d_solver_shadow->print_model();
+  d_dispatcher->sync([&]() { d_solver_shadow->print_model(); }, true);
 }
 
 void
 ShadowSolver::reset()
 {
-  d_solver->reset();
-  d_solver_shadow->reset();
+  d_dispatcher->run([&]() { d_solver->reset(); },
+                    [this]() { d_solver_shadow->reset(); });
 }
 
 void
 ShadowSolver::reset_assertions()
 {
-  d_solver->reset_assertions();
-  d_solver_shadow->reset_assertions();
+  d_dispatcher->run([&]() { d_solver->reset_assertions(); },
+                    [this]() { d_solver_shadow->reset_assertions(); });
 }
 
 void
 ShadowSolver::set_opt(const std::string& opt, const std::string& value)
 {
+  /* Options are set right away since setting an option may fail with a
+   * MurxlaSolverOptionException, which is handled by the caller. */
   const std::string shadow_prefix = MURXLA_CHECK_SOLVER_OPT_PREFIX;
   if (opt.find(shadow_prefix, 0) == 0)
   {
     std::string name(opt.begin() + shadow_prefix.size(), opt.end());
-    d_solver_shadow->set_opt(name, value);
+    d_dispatcher->sync([&]() { d_solver_shadow->set_opt(name, value); },
+                       false);
   }
   else
   {
     d_solver->set_opt(opt, value);
   }
 
+  std::string name_shadow;
   if (opt == d_solver->get_option_name_incremental())
   {
-    d_solver_shadow->set_opt(d_solver_shadow->get_option_name_incremental(),
-                             value);
+    name_shadow = d_solver_shadow->get_option_name_incremental();
   }
   else if (opt == d_solver->get_option_name_model_gen())
   {
-    d_solver_shadow->set_opt(d_solver_shadow->get_option_name_model_gen(),
-                             value);
+    name_shadow = d_solver_shadow->get_option_name_model_gen();
   }
   else if (opt == d_solver->get_option_name_unsat_assumptions())
   {
-    d_solver_shadow->set_opt(
-        d_solver_shadow->get_option_name_unsat_assumptions(), value);
+    name_shadow = d_solver_shadow->get_option_name_unsat_assumptions();
+  }
+  if (!name_shadow.empty())
+  {
+    d_dispatcher->sync(
+        [&]() { d_solver_shadow->set_opt(name_shadow, value); }, false);
   }
 }
 
@@ -1221,14 +1740,18 @@ std::vector<Term>
 ShadowSolver::get_value(const std::vector<Term>& terms)
 {
   assert(d_same_solver);
-  std::vector<Term> res, terms_orig, terms_shadow;
-  get_terms_helper(terms, terms_orig, terms_shadow);
-  auto values_orig   = d_solver->get_value(terms_orig);
-  auto values_shadow = d_solver_shadow->get_value(terms_shadow);
+  std::vector<Term> res, values_orig, values_shadow;
+  d_dispatcher->sync(
+      [&]() { values_orig = d_solver->get_value(get_terms_orig(terms)); },
+      [&]() {
+        values_shadow = d_solver_shadow->get_value(get_terms_shadow(terms));
+      },
+      true);
   assert(values_orig.size() == values_shadow.size());
   for (size_t i = 0; i < values_orig.size(); ++i)
   {
-    res.emplace_back(new ShadowTerm(values_orig[i], values_shadow[i]));
+    res.push_back(std::make_shared<ShadowTerm>(
+        values_orig[i], values_shadow[i], d_dispatcher));
   }
   return res;
 }
@@ -10,6 +10,12 @@
 #ifndef __MURXLA__SHADOW_SOLVER_H
 #define __MURXLA__SHADOW_SOLVER_H
 
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
 #include "fsm.hpp"
 #include "solver/solver.hpp"
 #include "theory.hpp"
@@ -17,13 +23,163 @@
 namespace murxla {
 namespace shadow {
 
-class ShadowSort : public AbsSort
+/**
+ * Worker thread that performs all calls into the cross-check solver of a
+ * ShadowSolver (see option --cross-check-threaded).
+ *
+ * Objects of the cross-check solver are created and destroyed on the worker
+ * thread only, since some solvers (e.g., cvc5) maintain thread-local state.
+ */
+class ShadowWorker
+{
+ public:
+  /** Constructor. Starts the worker thread. */
+  ShadowWorker();
+  /**
+   * Destructor. Destroys all released objects on the worker thread and stops
+   * the worker thread.
+   */
+  ~ShadowWorker();
+
+  /** Hand given job to the worker thread. */
+  void post(const std::function<void()>& job);
+  /**
+   * Wait for the posted job to finish. Rethrows the exception the job threw,
+   * if any.
+   */
+  void wait();
+
+  /**
+   * Release given cross-check solver object. It is destroyed on the worker
+   * thread before the next job is run.
+   */
+  void release(Term term);
+  void release(Sort sort);
+
+ private:
+  /** The main loop of the worker thread. */
+  void loop();
+
+  /** Mutex protecting the members below. */
+  std::mutex d_mutex;
+  /** Signals a new job or stop to the worker, and job completion back. */
+  std::condition_variable d_cv;
+  /** The posted job, null if none. */
+  std::function<void()> d_job;
+  /** True if a job was posted and has not finished yet. */
+  bool d_busy = false;
+  /** True if the worker thread is to be stopped. */
+  bool d_stop = false;
+  /** The exception thrown by the last job, if any. */
+  std::exception_ptr d_exception;
+  /** The released terms to be destroyed on the worker thread. */
+  std::vector<Term> d_released_terms;
+  /** The released sorts to be destroyed on the worker thread. */
+  std::vector<Sort> d_released_sorts;
+  /** The worker thread, declared last to be started last. */
+  std::thread d_thread;
+};
+
+/**
+ * Dispatches the calls into the cross-check solver of a ShadowSolver.
+ *
+ * By default, the cross-check part of a call is executed right after the call
+ * into the solver under test. With a worker (see option
+ * --cross-check-threaded), both are executed concurrently, and the call
+ * returns when both are done. This keeps the cross-check solver in lock step
+ * with the solver under test.
+ *
+ * In lazy mode (see option --cross-check-lazy), the cross-check part of a call
+ * is only recorded, and recorded calls are executed in order when the
+ * cross-check solver is synchronized at a comparison point (see sync()).
+ * Recorded calls must thus not refer to the stack of the caller. Shadow
+ * objects are only created when the calls creating them are executed.
+ */
+class ShadowDispatcher
+{
+ public:
+  /**
+   * Constructor.
+   * threaded: True to execute calls into the cross-check solver on a worker
+   *           thread.
+   * lazy    : True to record calls into the cross-check solver until the next
+   *           synchronization.
+   */
+  ShadowDispatcher(bool threaded, bool lazy);
+
+  /** Return true if in lazy mode. */
+  bool is_lazy() const { return d_lazy; }
+  /** Return true if there are no recorded calls left to execute. */
+  bool is_synced() const { return d_log.empty(); }
+
+  /**
+   * Run 'fun' (calls into the solver under test) and dispatch 'fun_shadow'
+   * (calls into the cross-check solver).
+   */
+  void run(const std::function<void()>& fun,
+           const std::function<void()>& fun_shadow);
+  /** Dispatch 'fun_shadow' (calls into the cross-check solver). */
+  void run(const std::function<void()>& fun_shadow);
+  /**
+   * Record 'fun_shadow', a check-sat call into the cross-check solver that is
+   * only executed if it is needed to answer a query on the cross-check solver
+   * (see sync()). Executes 'fun_shadow' right away if not in lazy mode.
+   */
+  void record_check_sat(const std::function<void()>& fun_shadow);
+  /**
+   * Run 'fun' and execute all recorded calls, followed by 'fun_shadow'.
+   * Recorded check-sat calls are skipped, except for the most recent one if
+   * 'check_sat' is true, i.e., if 'fun_shadow' queries the cross-check solver
+   * for the results of the most recent check-sat call.
+   */
+  void sync(const std::function<void()>& fun,
+            const std::function<void()>& fun_shadow,
+            bool check_sat);
+  /** Execute all recorded calls, followed by 'fun_shadow' (see above). */
+  void sync(const std::function<void()>& fun_shadow, bool check_sat);
+  /** Discard all recorded calls. */
+  void discard();
+
+  /** Release given cross-check solver object. */
+  void release(Term term);
+  void release(Sort sort);
+
+ private:
+  /** A recorded call into the cross-check solver. */
+  struct Call
+  {
+    /** The call. */
+    std::function<void()> d_fun;
+    /** True if this is a check-sat call (see record_check_sat()). */
+    bool d_is_check_sat;
+  };
+
+  /**
+   * Run 'fun' on the calling thread and 'fun_shadow' on the worker thread
+   * concurrently and wait for both to finish. Without a worker, run 'fun' and
+   * then 'fun_shadow' on the calling thread.
+   */
+  void run_now(const std::function<void()>& fun,
+               const std::function<void()>& fun_shadow);
+
+  /** The worker, null if not threaded. */
+  std::unique_ptr<ShadowWorker> d_worker;
+  /** True if in lazy mode. */
+  bool d_lazy;
+  /** The recorded calls (lazy mode). */
+  std::vector<Call> d_log;
+};
+
+class ShadowSort : public AbsSort,
+                   public std::enable_shared_from_this<ShadowSort>
 {
   friend class ShadowTerm;
   friend class ShadowSolver;
 
  public:
-  ShadowSort(Sort sort, Sort sort_shadow);
+  ShadowSort(Sort sort,
+             Sort sort_shadow,
+             const std::shared_ptr<ShadowDispatcher>& dispatcher);
   ~ShadowSort() override;
   size_t hash() const override;
   bool equals(const Sort& other) const override;
@@ -74,14 +230,19 @@ class ShadowSort : public AbsSort
  private:
   Sort d_sort;
   Sort d_sort_shadow;
+  /** The dispatcher of the calls into the cross-check solver. */
+  std::shared_ptr<ShadowDispatcher> d_dispatcher;
 };
 
-class ShadowTerm : public AbsTerm
+class ShadowTerm : public AbsTerm,
+                   public std::enable_shared_from_this<ShadowTerm>
 {
   friend class ShadowSolver;
 
  public:
-  ShadowTerm(Term term, Term term_shadow);
+  ShadowTerm(Term term,
+             Term term_shadow,
+             const std::shared_ptr<ShadowDispatcher>& dispatcher);
   ~ShadowTerm() override;
   size_t hash() const override;
   bool equals(const Term& other) const override;
@@ -118,6 +279,8 @@ class ShadowTerm : public AbsTerm
  private:
   Term d_term;
   Term d_term_shadow;
+  /** The dispatcher of the calls into the cross-check solver. */
+  std::shared_ptr<ShadowDispatcher> d_dispatcher;
 };
 
 class ShadowSolver : public Solver
@@ -138,7 +301,23 @@ class ShadowSolver : public Solver
                                std::vector<Term>& terms_orig,
                                std::vector<Term>& terms_shadow);
 
-  ShadowSolver(SolverSeedGenerator& sng, Solver* solver, Solver* solver_shadow);
+  /**
+   * Constructor.
+   * solver       : The solver under test.
+   * solver_shadow: The solver to cross-check with.
+   * threaded     : True to run the cross-check solver concurrently to the
+   *                solver under test on a separate thread.
+   * lazy         : True to defer calls into the cross-check solver until the
+   *                next cross-checked check-sat call.
+   * sample_prob  : The probability (100% = 1000) of a check-sat call to be
+   *                cross-checked in lazy mode.
+   */
+  ShadowSolver(SolverSeedGenerator& sng,
+               Solver* solver,
+               Solver* solver_shadow,
+               bool threaded        = false,
+               bool lazy            = false,
+               uint32_t sample_prob = MURXLA_PROB_MAX);
   ~ShadowSolver() override;
 
   void new_solver() override;
@@ -236,6 +415,13 @@ class ShadowSolver : public Solver
   /** Flag that indicates whether d_solver and d_solver_shadow are instances of
    * the same solver. */
   bool d_same_solver;
+  /** The dispatcher of the calls into d_solver_shadow. */
+  std::shared_ptr<ShadowDispatcher> d_dispatcher;
+  /**
+   * The probability (100% = 1000) of a check-sat call to be cross-checked in
+   * lazy mode.
+   */
+  uint32_t d_sample_prob;
 };
 
 }  // namespace shadow
@@ -0,0 +1,149 @@
+/***
+ * Murxla: A Model-Based API Fuzzer for SMT solvers.
+ *
+ * This file is part of Murxla.
+ *
+ * Copyright (C) 2019-2022 by the authors listed in the AUTHORS file.
+ *
+ * See LICENSE for more information on using this software.
+ */
+#include "smt2_process.hpp"
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+#include "except.hpp"
+
+namespace murxla {
+namespace smt2 {
+
+/* -------------------------------------------------------------------------- */
+
+Smt2Process::Smt2Process(const std::string& solver_call)
+    : d_solver_call(solver_call)
+{
+}
+
+Smt2Process::~Smt2Process()
+{
+  if (is_running() && is_owner())
+  {
+    kill();
+  }
+}
+
+void
+Smt2Process::start()
+{
+  assert(!is_running());
+
+  int32_t fd_to[2], fd_from[2];
+
+  /* Open input/output pipes from and to the external online solver. */
+  MURXLA_EXIT_ERROR(pipe(fd_to) != 0) << "creating input pipe failed";
+  MURXLA_EXIT_ERROR(pipe(fd_from) != 0) << "creating output pipe failed";
+
+  d_pid = fork();
+
+  MURXLA_EXIT_ERROR_FORK(d_pid < 0, true) << "forking solver process failed.";
+
+  /* Online solver process. */
+  if (d_pid == 0)
+  {
+    /* SIGPIPE is ignored in the murxla run process, do not inherit this. */
+    signal(SIGPIPE, SIG_DFL);
+
+    close(fd_to[WRITE_END]);
+    dup2(fd_to[READ_END], STDIN_FILENO);
+
+    close(fd_from[READ_END]);
+    /* Redirect stdout of external solver to write end. */
+    dup2(fd_from[WRITE_END], STDOUT_FILENO);
+    /* Redirect stderr of external solver to write end. */
+    dup2(fd_from[WRITE_END], STDERR_FILENO);
+
+    std::vector<char*> execv_args;
+    std::string arg;
+    std::stringstream ss(d_solver_call);
+    while (std::getline(ss, arg, ' '))
+    {
+      execv_args.push_back(strdup(arg.c_str()));
+    }
+    execv_args.push_back(nullptr);
+
+    execv(execv_args[0], execv_args.data());
+
+    for (char* s : execv_args)
+    {
+      free(s);
+    }
+
+    MURXLA_EXIT_ERROR_FORK(true, true)
+        << "'" << d_solver_call << "' is not executable";
+  }
+
+  close(fd_to[READ_END]);
+  close(fd_from[WRITE_END]);
+  d_fd_to     = fd_to[WRITE_END];
+  d_fd_from   = fd_from[READ_END];
+  d_owner_pid = getpid();
+  d_num_uses  = 0;
+}
+
+void
+Smt2Process::wait()
+{
+  assert(is_running());
+  assert(is_owner());
+  close_pipes();
+  waitpid(d_pid, nullptr, 0);
+  d_pid = 0;
+}
+
+void
+Smt2Process::kill()
+{
+  assert(is_running());
+  assert(is_owner());
+  ::kill(d_pid, SIGKILL);
+  wait();
+}
+
+void
+Smt2Process::terminated()
+{
+  close_pipes();
+  d_pid = 0;
+}
+
+bool
+Smt2Process::is_owner() const
+{
+  return d_owner_pid == getpid();
+}
+
+void
+Smt2Process::close_pipes()
+{
+  if (d_fd_to >= 0)
+  {
+    close(d_fd_to);
+    d_fd_to = -1;
+  }
+  if (d_fd_from >= 0)
+  {
+    close(d_fd_from);
+    d_fd_from = -1;
+  }
+}
+
+/* -------------------------------------------------------------------------- */
+
+}  // namespace smt2
+}  // namespace murxla
@@ -0,0 +1,112 @@
+/***
+ * Murxla: A Model-Based API Fuzzer for SMT solvers.
+ *
+ * This file is part of Murxla.
+ *
+ * Copyright (C) 2019-2022 by the authors listed in the AUTHORS file.
+ *
+ * See LICENSE for more information on using this software.
+ */
+#ifndef __MURXLA__SMT2_PROCESS_H
+#define __MURXLA__SMT2_PROCESS_H
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <string>
+
+namespace murxla {
+namespace smt2 {
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * An external online SMT2 solver process, connected via pipes to its stdin
+ * and stdout/stderr.
+ *
+ * A process is either owned by the Smt2Solver that uses it (one process per
+ * run), or by the Murxla supervisor, which keeps it alive across runs (see
+ * option --smt2-reuse). In the latter case, the run processes forked by the
+ * supervisor inherit the pipes, and only the supervisor may kill and collect
+ * the process.
+ */
+class Smt2Process
+{
+ public:
+  /**
+   * Constructor.
+   * solver_call: The solver binary to execute, with its arguments separated
+   *              by spaces.
+   */
+  Smt2Process(const std::string& solver_call);
+  /**
+   * Destructor. Kills the process if it is still running and the calling
+   * process started it.
+   */
+  ~Smt2Process();
+
+  /** Start the process. */
+  void start();
+  /**
+   * Close the pipes and wait for the process to terminate. Must only be
+   * called by the process that started it.
+   */
+  void wait();
+  /**
+   * Kill the process and wait for it to terminate. Must only be called by
+   * the process that started it.
+   */
+  void kill();
+  /**
+   * Mark the process as terminated and close the pipes. To be called when
+   * the process was already collected via wait() or waitpid().
+   */
+  void terminated();
+
+  /** Return true if the process was started and has not terminated yet. */
+  bool is_running() const { return d_pid > 0; }
+  /**
+   * Return true if the process was started by the calling process, i.e.,
+   * if the calling process is allowed to collect it.
+   */
+  bool is_owner() const;
+
+  /** Get the process id of the process, 0 if not running. */
+  pid_t get_pid() const { return d_pid; }
+  /** Get the file descriptor of the pipe to the stdin of the process. */
+  int32_t get_fd_to() const { return d_fd_to; }
+  /** Get the file descriptor of the pipe from the stdout of the process. */
+  int32_t get_fd_from() const { return d_fd_from; }
+
+  /** Get the number of runs the process was used for since it was started. */
+  uint64_t get_num_uses() const { return d_num_uses; }
+  /** Increment the number of runs the process was used for. */
+  void inc_num_uses() { d_num_uses += 1; }
+
+ private:
+  static constexpr int32_t READ_END  = 0;
+  static constexpr int32_t WRITE_END = 1;
+
+  /** Close the pipes to and from the process. */
+  void close_pipes();
+
+  /** The solver binary to execute, with its arguments. */
+  std::string d_solver_call;
+  /** The process id of the process, 0 if not running. */
+  pid_t d_pid = 0;
+  /** The process id of the process that started the process. */
+  pid_t d_owner_pid = 0;
+  /** The write end of the pipe to the stdin of the process. */
+  int32_t d_fd_to = -1;
+  /** The read end of the pipe from the stdout and stderr of the process. */
+  int32_t d_fd_from = -1;
+  /** The number of runs the process was used for since it was started. */
+  uint64_t d_num_uses = 0;
+};
+
+/* -------------------------------------------------------------------------- */
+
+}  // namespace smt2
+}  // namespace murxla
+
+#endif
@@ -0,0 +1,146 @@
+/***
+ * Murxla: A Model-Based API Fuzzer for SMT solvers.
+ *
+ * This file is part of Murxla.
+ *
+ * Copyright (C) 2019-2022 by the authors listed in the AUTHORS file.
+ *
+ * See LICENSE for more information on using this software.
+ */
+#include "smt2_reader.hpp"
+
+#include <unistd.h>
+
+#include <cassert>
+#include <cctype>
+#include <cerrno>
+
+namespace murxla {
+namespace smt2 {
+
+/* -------------------------------------------------------------------------- */
+
+Smt2Reader::Smt2Reader(int32_t fd, size_t chunk_size)
+    : d_fd(fd), d_chunk_size(chunk_size)
+{
+  assert(chunk_size > 0);
+}
+
+std::string_view
+Smt2Reader::read()
+{
+  for (;;)
+  {
+    for (size_t size = d_buf.size(); d_pos < size; ++d_pos)
+    {
+      char c = d_buf[d_pos];
+
+      if (!d_started)
+      {
+        if (std::isspace(static_cast<unsigned char>(c)))
+        {
+          d_begin = d_pos + 1;
+          continue;
+        }
+        d_started = true;
+        d_sexpr   = c == '(';
+      }
+
+      size_t end = d_pos;
+      if (!d_sexpr)
+      {
+        if (c != '\n') continue;
+        /* response is a single line */
+        if (end > d_begin && d_buf[end - 1] == '\r') --end;
+      }
+      else if (d_in_string)
+      {
+        /* An escaped quote "" closes and immediately reopens the literal. */
+        if (c == '"') d_in_string = false;
+        continue;
+      }
+      else if (d_in_symbol)
+      {
+        if (c == '|') d_in_symbol = false;
+        continue;
+      }
+      else if (d_in_comment)
+      {
+        if (c == '\n') d_in_comment = false;
+        continue;
+      }
+      else
+      {
+        if (c == '"')
+        {
+          d_in_string = true;
+        }
+        else if (c == '|')
+        {
+          d_in_symbol = true;
+        }
+        else if (c == ';')
+        {
+          d_in_comment = true;
+        }
+        else if (c == '(')
+        {
+          ++d_depth;
+        }
+        else if (c == ')')
+        {
+          assert(d_depth > 0);
+          --d_depth;
+        }
+        if (d_depth > 0) continue;
+        /* response is an S-expression, including the closing parenthesis */
+        end += 1;
+      }
+
+      std::string_view res(d_buf.data() + d_begin, end - d_begin);
+      d_pos     = d_pos + 1;
+      d_begin   = d_pos;
+      d_started = false;
+      return res;
+    }
+
+    if (!fill())
+    {
+      d_begin      = d_buf.size();
+      d_pos        = d_begin;
+      d_started    = false;
+      d_depth      = 0;
+      d_in_string  = false;
+      d_in_symbol  = false;
+      d_in_comment = false;
+      return RESPONSE_EOF;
+    }
+  }
+}
+
+bool
+Smt2Reader::fill()
+{
+  /* Discard consumed data. */
+  if (d_begin > 0)
+  {
+    d_buf.erase(0, d_begin);
+    d_pos -= d_begin;
+    d_begin = 0;
+  }
+
+  size_t size = d_buf.size();
+  d_buf.resize(size + d_chunk_size);
+  ssize_t n;
+  do
+  {
+    n = ::read(d_fd, d_buf.data() + size, d_chunk_size);
+  } while (n < 0 && errno == EINTR);
+  d_buf.resize(size + (n > 0 ? static_cast<size_t>(n) : 0));
+  return n > 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+}  // namespace smt2
+}  // namespace murxla
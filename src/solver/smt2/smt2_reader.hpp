@@ -0,0 +1,100 @@
+/***
+ * Murxla: A Model-Based API Fuzzer for SMT solvers.
+ *
+ * This file is part of Murxla.
+ *
+ * Copyright (C) 2019-2022 by the authors listed in the AUTHORS file.
+ *
+ * See LICENSE for more information on using this software.
+ */
+#ifndef __MURXLA__SMT2_READER_H
+#define __MURXLA__SMT2_READER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace murxla {
+namespace smt2 {
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Buffered reader for the responses of an online SMT2 solver.
+ *
+ * Reads from a file descriptor in large chunks and splits the input into
+ * responses. A response is either an S-expression (if its first
+ * non-whitespace character is '(') or a single line.
+ *
+ * S-expressions are scanned for their closing parenthesis. Parentheses in
+ * string literals ("...", with "" as escaped quote), quoted symbols (|...|)
+ * and comments (; until the end of the line) are ignored. Scanning is
+ * incremental, i.e., data that was already scanned is not scanned again when
+ * a response spans multiple chunks.
+ */
+class Smt2Reader
+{
+ public:
+  /** The default size of the chunks read from the file descriptor. */
+  static constexpr size_t CHUNK_SIZE = 64 * 1024;
+  /** The response returned on end of input. */
+  inline static const std::string RESPONSE_EOF = "[EOF]";
+
+  /**
+   * Constructor.
+   * fd        : The file descriptor to read from.
+   * chunk_size: The size of the chunks to read.
+   */
+  Smt2Reader(int32_t fd, size_t chunk_size = CHUNK_SIZE);
+
+  /**
+   * Read the next response.
+   *
+   * Leading whitespace is skipped, the response does not include the
+   * terminating newline. Returns RESPONSE_EOF if the input ends before the
+   * response is complete.
+   *
+   * The returned view is only valid until the next call to read().
+   */
+  std::string_view read();
+
+ private:
+  /**
+   * Read the next chunk from the file descriptor and append it to d_buf.
+   * Returns false on end of input.
+   */
+  bool fill();
+
+  /** The file descriptor to read from. */
+  int32_t d_fd;
+  /** The size of the chunks to read. */
+  size_t d_chunk_size;
+  /** The buffer holding the data read but not yet consumed. */
+  std::string d_buf;
+  /** The position of the first byte of the current response in d_buf. */
+  size_t d_begin = 0;
+  /** The position of the next byte to scan in d_buf. */
+  size_t d_pos = 0;
+
+  /* The scanner state of the current response. */
+
+  /** True if a response started (first non-whitespace byte was read). */
+  bool d_started = false;
+  /** True if the current response is an S-expression. */
+  bool d_sexpr = false;
+  /** The parenthesis nesting depth of the current S-expression. */
+  uint64_t d_depth = 0;
+  /** True if the scanner is in a string literal. */
+  bool d_in_string = false;
+  /** True if the scanner is in a quoted symbol. */
+  bool d_in_symbol = false;
+  /** True if the scanner is in a comment. */
+  bool d_in_comment = false;
+};
+
+/* -------------------------------------------------------------------------- */
+
+}  // namespace smt2
+}  // namespace murxla
+
+#endif
@@ -23,13 +23,16 @@
 namespace murxla {
 namespace smt2 {
 
-/* Process id of online solver. */
-static pid_t s_online_solver_pid = 0;
+/* Process ids of online solvers. */
+static std::vector<pid_t> s_online_solver_pids;
 
 static void
 kill_online_solver(int32_t sig)
 {
-  kill(s_online_solver_pid, SIGKILL);
+  for (pid_t pid : s_online_solver_pids)
+  {
+    kill(pid, SIGKILL);
+  }
 }
 
 /* -------------------------------------------------------------------------- */
@@ -490,6 +493,15 @@ get_default(const std::unordered_map<std::string, std::string>& map,
   }
   return it->second;
 }
+
+/** Return true if terms of given kind open a new scope. */
+bool
+is_new_scope(const Op::Kind& kind)
+{
+  return kind == Op::FORALL || kind == Op::EXISTS
+         || kind == Op::SET_COMPREHENSION || kind == Op::DT_MATCH
+         || kind == Op::FUN;
+}
 }  // namespace
 
 const std::string
@@ -505,9 +517,6 @@ Smt2Term::get_repr() const
   std::unordered_map<const Smt2Term*, uint64_t> refs;
   std::vector<std::string> lets;
 
-  std::unordered_set<Op::Kind> new_scope = {
-      Op::FORALL, Op::EXISTS, Op::SET_COMPREHENSION, Op::DT_MATCH, Op::FUN};
-
   // Compute references
   visit.push_back(this);
   while (!visit.empty())
@@ -520,7 +529,7 @@ Smt2Term::get_repr() const
     {
       cache.emplace(cur, "");
       /* Do not go below quantifiers. */
-      if (new_scope.find(cur->d_kind) != new_scope.end())
+      if (is_new_scope(cur->d_kind))
       {
         continue;
       }
@@ -551,166 +560,22 @@ Smt2Term::get_repr() const
     }
     else
     {
-      std::stringstream res;
-
-      size_t i = 0;
-      if (cur->get_leaf_kind() != AbsTerm::LeafKind::NONE
-          || cur->get_kind() == Op::FUN)
-      {
-        assert(!cur->d_repr.empty());
-        res << cur->d_repr;
-      }
-      else
-      {
-        if (cur->d_kind == Op::DT_APPLY_TESTER)
-        {
-          assert(cur->d_str_args.size() == 1);
-          res << "((_ " << d_op_kind_to_str.at(cur->d_kind) << " "
-              << cur->d_str_args[0] << ")";
-        }
-        else if (cur->d_kind == Op::DT_APPLY_UPDATER)
-        {
-          assert(cur->d_str_args.size() == 2);
-          res << "((_ " << d_op_kind_to_str.at(cur->d_kind) << " "
-              << cur->d_str_args[1] << ")";
-        }
-        else if (cur->d_kind == Op::DT_MATCH)
-        {
-          res << "(" << d_op_kind_to_str.at(cur->d_kind) << " "
-              << to_smt2_term(cur->d_args[i++])->get_repr() << " (";
-          for (size_t n = cur->d_args.size(); i < n; ++i)
-          {
-            res << to_smt2_term(cur->d_args[i])->get_repr();
-          }
-          res << "))";
-        }
-        else if (cur->d_kind == Op::DT_MATCH_BIND_CASE)
-        {
-          if (cur->d_str_args.empty())
-          {
-            /* variable pattern */
-            assert(cur->d_args.size() == 2);
-            res << "(" << to_smt2_term(cur->d_args[0])->get_repr() << " "
-                << to_smt2_term(cur->d_args[1])->get_repr() << ")";
-            i = 2;
-          }
-          else
-          {
-            res << "((" << cur->d_str_args[0] << " ";
-            for (size_t n = cur->d_args.size() - 1; i < n; ++i)
-            {
-              if (i > 0) res << " ";
-              res << to_smt2_term(cur->d_args[i])->get_repr();
-            }
-            res << ") ";
-            res << to_smt2_term(cur->d_args[i++])->get_repr();
-            res << ")";
-          }
-        }
-        else if (cur->d_kind == Op::DT_MATCH_CASE)
-        {
-          assert(cur->d_str_args.size() == 1);
-          assert(cur->d_args.size() == 1);
-          res << "(" << cur->d_str_args[0] << " "
-              << to_smt2_term(cur->d_args[0])->get_repr() << ") ";
-          i = cur->d_args.size();
-        }
-        else if (cur->d_indices.empty())
-        {
-          if (!cur->d_args.empty())
-          {
-            res << "(";
-          }
-          if (cur->d_kind == Op::UF_APPLY)
-          {
-            res << to_smt2_term(cur->d_args[0])->get_repr();
-            i += 1;
-          }
-          else if (cur->d_kind == Op::DT_APPLY_CONS)
-          {
-            assert(cur->get_str_args().size() == 1);
-            res << cur->get_str_args()[0];
-          }
-          else if (cur->d_kind == Op::DT_APPLY_SEL)
-          {
-            assert(cur->get_str_args().size() == 2);
-            res << cur->get_str_args()[1];
-          }
-          else
-          {
-            res << get_default(d_op_kind_to_str, cur->d_kind, cur->d_kind);
-          }
-          if (cur->d_kind == Op::FORALL || cur->d_kind == Op::EXISTS
-              || cur->d_kind == Op::SET_COMPREHENSION)
-          {
-            assert(cur->d_args.size() > 1);
-            size_t size = cur->d_args.size() - 1;
-            if (cur->d_kind == Op::SET_COMPREHENSION)
-            {
-              assert(size >= 1);
-              size -= 1;
-            }
-            /* print bound variables, body is last argument term in d_args */
-            res << " (";
-            for (; i < size; ++i)
-            {
-              if (i > 0) res << " ";
-              const Smt2Term* smt2_term = to_smt2_term(cur->d_args[i]);
-              assert(smt2_term->get_leaf_kind() == AbsTerm::LeafKind::VARIABLE);
-              Smt2Sort* smt2_sort =
-                  static_cast<Smt2Sort*>(cur->d_args[i]->get_sort().get());
-
-              const auto itt = cache.find(smt2_term);
-              assert(itt != cache.end());
-              assert(!itt->second.empty());
-
-              res << "(" << itt->second << " " << smt2_sort->get_repr() << ")";
-            }
-            res << ")";
-          }
-        }
-        else
-        {
-          res << "((_ "
-              << get_default(d_op_kind_to_str, cur->d_kind, cur->d_kind);
-          for (uint32_t p : cur->d_indices)
-          {
-            res << " " << p;
-          }
-          res << ")";
-        }
-        size_t size = cur->d_args.size();
-        if (i < size)
-        {
-          for (; i < size; ++i)
-          {
-            const auto itt = cache.find(to_smt2_term(cur->d_args[i]));
-            assert(itt != cache.end());
-            assert(!itt->second.empty());
-            res << " " << itt->second;
-          }
-          if (!cur->d_args.empty())
-          {
-            res << ")";
-          }
-        }
-      }
-
       if (it->second.empty())
       {
-        uint64_t nrefs = refs[cur];
+        std::string res = cur->get_node_repr(cache);
+        uint64_t nrefs  = refs[cur];
 
         if (nrefs > 1 && cur->get_leaf_kind() == AbsTerm::LeafKind::NONE)
         {
           std::stringstream let;
           let << "_let" << lets.size() / 2;
           lets.push_back(let.str());
-          lets.push_back(res.str());
+          lets.push_back(res);
           it->second = let.str();
         }
         else
         {
-          it->second = res.str();
+          it->second = res;
         }
       }
     }
@@ -741,222 +606,669 @@ Smt2Term::get_repr() const
   return res.str();
 }
 
-/* -------------------------------------------------------------------------- */
-/* Smt2Solver                                                                 */
-/* -------------------------------------------------------------------------- */
-
-/* Trim whitespaces (in place) from given str. */
-static void
-trim_str(std::string& s)
+std::string
+Smt2Term::get_node_repr(
+    const std::unordered_map<const Smt2Term*, std::string>& cache) const
 {
-  /* trim from left */
-  s.erase(s.begin(), std::find_if(s.begin(), s.end(), [](int ch) {
-            return !std::isspace(ch);
-          }));
-  /* trim from right */
-  s.erase(std::find_if(
-              s.rbegin(), s.rend(), [](int ch) { return !std::isspace(ch); })
-              .base(),
-          s.end());
-}
+  std::stringstream res;
 
-void
-Smt2Solver::push_to_external(std::string s, ResponseKind expected)
-{
-  assert(d_file_to);
-  assert(d_file_from);
-  fputs(s.c_str(), d_file_to);
-  fputc('\n', d_file_to);
-  fflush(d_file_to);
-  std::string res = get_from_external();
-  trim_str(res);
-  switch (expected)
+  size_t i = 0;
+  if (get_leaf_kind() != AbsTerm::LeafKind::NONE || get_kind() == Op::FUN)
   {
-    case ResponseKind::SMT2_SUCCESS:
-      if (res != "success")
+    assert(!d_repr.empty());
+    res << d_repr;
+  }
+  else
+  {
+    if (d_kind == Op::DT_APPLY_TESTER)
+    {
+      assert(d_str_args.size() == 1);
+      res << "((_ " << d_op_kind_to_str.at(d_kind) << " " << d_str_args[0]
+          << ")";
+    }
+    else if (d_kind == Op::DT_APPLY_UPDATER)
+    {
+      assert(d_str_args.size() == 2);
+      res << "((_ " << d_op_kind_to_str.at(d_kind) << " " << d_str_args[1]
+          << ")";
+    }
+    else if (d_kind == Op::DT_MATCH)
+    {
+      res << "(" << d_op_kind_to_str.at(d_kind) << " "
+          << to_smt2_term(d_args[i++])->get_repr() << " (";
+      for (size_t n = d_args.size(); i < n; ++i)
       {
-        std::cerr << "[murxla] SMT2: Error: expected 'success' response from "
-                     "online solver but got '"
-                  << res << "'" << std::endl;
-        exit(EXIT_ERROR);
+        res << to_smt2_term(d_args[i])->get_repr();
       }
-      break;
-    case ResponseKind::SMT2_SAT:
-      if (res != "sat" && res != "unsat" && res != "unknown")
+      res << "))";
+    }
+    else if (d_kind == Op::DT_MATCH_BIND_CASE)
+    {
+      if (d_str_args.empty())
       {
-        std::cerr << "[murxla] SMT2: Error: expected 'sat', 'unsat' or "
-                     "'unknown' response from online solver but got '"
-                  << res << "'" << std::endl;
-        exit(EXIT_ERROR);
+        /* variable pattern */
+        assert(d_args.size() == 2);
+        res << "(" << to_smt2_term(d_args[0])->get_repr() << " "
+            << to_smt2_term(d_args[1])->get_repr() << ")";
+        i = 2;
+      }
+      else
+      {
+        res << "((" << d_str_args[0] << " ";
+        for (size_t n = d_args.size() - 1; i < n; ++i)
+        {
+          if (i > 0) res << " ";
+          res << to_smt2_term(d_args[i])->get_repr();
+        }
+        res << ") ";
+        res << to_smt2_term(d_args[i++])->get_repr();
+        res << ")";
+      }
+    }
+    else if (d_kind == Op::DT_MATCH_CASE)
+    {
+      assert(d_str_args.size() == 1);
+      assert(d_args.size() == 1);
+      res << "(" << d_str_args[0] << " " << to_smt2_term(d_args[0])->get_repr()
+          << ") ";
+      i = d_args.size();
+    }
+    else if (d_indices.empty())
+    {
+      if (!d_args.empty())
+      {
+        res << "(";
       }
-      if (res == "sat")
+      if (d_kind == Op::UF_APPLY)
       {
-        d_last_result = Solver::Result::SAT;
+        res << to_smt2_term(d_args[0])->get_repr();
+        i += 1;
       }
-      else if (res == "unsat")
+      else if (d_kind == Op::DT_APPLY_CONS)
       {
-        d_last_result = Solver::Result::UNSAT;
+        assert(get_str_args().size() == 1);
+        res << get_str_args()[0];
       }
-      else if (res == "unknown")
+      else if (d_kind == Op::DT_APPLY_SEL)
       {
-        d_last_result = Solver::Result::UNKNOWN;
+        assert(get_str_args().size() == 2);
+        res << get_str_args()[1];
       }
-      break;
-    default:
-      assert(expected == ResponseKind::SMT2_SEXPR);
-      if (res[0] != '(' || res.find("error") != std::string::npos
-          || res.find("Error") != std::string::npos
-          || res.find("ERROR") != std::string::npos)
-      {
-        std::cerr << "[murxla] SMT2: Error: expected S-expression response "
-                     "from online solver but got '"
-                  << res << "'" << std::endl;
-        exit(EXIT_ERROR);
+      else
+      {
+        res << get_default(d_op_kind_to_str, d_kind, d_kind);
+      }
+      if (d_kind == Op::FORALL || d_kind == Op::EXISTS
+          || d_kind == Op::SET_COMPREHENSION)
+      {
+        assert(d_args.size() > 1);
+        size_t size = d_args.size() - 1;
+        if (d_kind == Op::SET_COMPREHENSION)
+        {
+          assert(size >= 1);
+          size -= 1;
+        }
+        /* print bound variables, body is last argument term in d_args */
+        res << " (";
+        for (; i < size; ++i)
+        {
+          if (i > 0) res << " ";
+          const Smt2Term* smt2_term = to_smt2_term(d_args[i]);
+          assert(smt2_term->get_leaf_kind() == AbsTerm::LeafKind::VARIABLE);
+          Smt2Sort* smt2_sort =
+              static_cast<Smt2Sort*>(d_args[i]->get_sort().get());
+
+          const auto itt = cache.find(smt2_term);
+          assert(itt != cache.end());
+          assert(!itt->second.empty());
+
+          res << "(" << itt->second << " " << smt2_sort->get_repr() << ")";
+        }
+        res << ")";
+      }
+    }
+    else
+    {
+      res << "((_ " << get_default(d_op_kind_to_str, d_kind, d_kind);
+      for (uint32_t p : d_indices)
+      {
+        res << " " << p;
+      }
+      res << ")";
+    }
+    size_t size = d_args.size();
+    if (i < size)
+    {
+      for (; i < size; ++i)
+      {
+        const auto itt = cache.find(to_smt2_term(d_args[i]));
+        assert(itt != cache.end());
+        assert(!itt->second.empty());
+        res << " " << itt->second;
       }
+      if (!d_args.empty())
+      {
+        res << ")";
+      }
+    }
   }
+
+  return res.str();
 }
 
-/**
- * Either parses one line or an s-expression if the first character of the
- * stream is '('.
- */
-std::string
-Smt2Solver::get_from_external() const
+/* -------------------------------------------------------------------------- */
+/* Smt2Solver                                                                 */
+/* -------------------------------------------------------------------------- */
+
+/* Trim whitespaces (in place) from given str. */
+static void
+trim_str(std::string_view& s)
 {
-  std::vector<std::string> lines;
-  std::stringstream ss;
-  size_t in_sexpr = 0;
-  size_t nchars   = 0;
-  while (true)
+  while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front())))
+  {
+    s.remove_prefix(1);
+  }
+  while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back())))
+  {
+    s.remove_suffix(1);
+  }
+}
+
+void
+Smt2Solver::push_to_external(std::string s, ResponseKind expected)
+{
+  assert(!d_externals.empty());
+  for (auto& e : d_externals)
   {
-    int32_t c = fgetc(d_file_from);
-    ++nchars;
-    if (c == EOF)
+    assert(e.file_to);
+    assert(e.reader);
+    /* A failed write means that the solver terminated, which is reported
+     * when reading its responses. */
+    if (fputs(s.c_str(), e.file_to) == EOF || fputc('\n', e.file_to) == EOF)
     {
-      return "[EOF]";
+      e.write_failed = true;
     }
-    else if (c == '(' && (in_sexpr || nchars == 1))
+  }
+  if (d_pipelined && expected == ResponseKind::SMT2_SUCCESS)
+  {
+    d_pending.push_back(s);
+    if (d_pending.size() >= MAX_PENDING)
+    {
+      sync_external();
+    }
+    return;
+  }
+  sync_external();
+
+  /* The first online solver that answered 'sat' or 'unsat', and its answer. */
+  size_t n_externals      = d_externals.size();
+  size_t decided          = n_externals;
+  std::string decided_res = "unknown";
+
+  for (size_t i = 0; i < n_externals; ++i)
+  {
+    std::string_view res = get_from_external(i);
+    trim_str(res);
+    switch (expected)
     {
-      ++in_sexpr;
+      case ResponseKind::SMT2_SUCCESS:
+        if (res != "success")
+        {
+          std::cerr << "[murxla] SMT2: Error: expected 'success' response "
+                       "from "
+                    << get_external_name(i) << " but got '" << res << "'"
+                    << std::endl;
+          exit(EXIT_ERROR);
+        }
+        break;
+      case ResponseKind::SMT2_SAT:
+        if (res != "sat" && res != "unsat" && res != "unknown")
+        {
+          std::cerr << "[murxla] SMT2: Error: expected 'sat', 'unsat' or "
+                       "'unknown' response from "
+                    << get_external_name(i) << " but got '" << res << "'"
+                    << std::endl;
+          exit(EXIT_ERROR);
+        }
+        if (res == "unknown") break;
+        if (decided == n_externals)
+        {
+          decided     = i;
+          decided_res = res;
+        }
+        else if (res != decided_res)
+        {
+          std::cerr << "[murxla] SMT2: Error: " << get_external_name(decided)
+                    << " answered '" << decided_res << "' but "
+                    << get_external_name(i) << " answered '" << res << "'"
+                    << std::endl;
+          exit(EXIT_ERROR);
+        }
+        break;
+      default:
+        assert(expected == ResponseKind::SMT2_SEXPR);
+        if (res.empty() || res[0] != '('
+            || res.find("error") != std::string::npos
+            || res.find("Error") != std::string::npos
+            || res.find("ERROR") != std::string::npos)
+        {
+          std::cerr << "[murxla] SMT2: Error: expected S-expression response "
+                       "from "
+                    << get_external_name(i) << " but got '" << res << "'"
+                    << std::endl;
+          exit(EXIT_ERROR);
+        }
     }
-    else if (c == ')' && in_sexpr)
+  }
+
+  for (size_t i = 0; i < n_externals; ++i)
+  {
+    if (d_externals[i].write_failed)
     {
-      --in_sexpr;
+      std::cerr << "[murxla] SMT2: Error: failed to write to "
+                << get_external_name(i) << std::endl;
+      exit(EXIT_ERROR);
     }
+  }
 
-    ss << ((char) c);
-    if (c == '\n')
+  if (expected == ResponseKind::SMT2_SAT)
+  {
+    if (decided_res == "sat")
     {
-      lines.push_back(ss.str());
-      ss.str("");
-      ss.clear();
+      d_last_result = Solver::Result::SAT;
     }
-    if (c == '\n' && !in_sexpr)
+    else if (decided_res == "unsat")
     {
-      break;
+      d_last_result = Solver::Result::UNSAT;
+    }
+    else
+    {
+      d_last_result = Solver::Result::UNKNOWN;
     }
   }
-  std::string res;
-  for (auto& line : lines)
+}
+
+void
+Smt2Solver::sync_external()
+{
+  for (auto& e : d_externals)
   {
-    d_out << "; " << line;
-    res += line;
+    if (fflush(e.file_to) == EOF)
+    {
+      e.write_failed = true;
+    }
   }
-  d_out << std::flush;
-  return res;
+  /* Pending commands are written to d_out together with their responses to
+   * get the same output as in unpipelined mode. */
+  for (const auto& cmd : d_pending)
+  {
+    d_out << cmd << std::endl;
+    for (size_t i = 0, n = d_externals.size(); i < n; ++i)
+    {
+      std::string_view res = get_from_external(i);
+      trim_str(res);
+      if (res != "success")
+      {
+        std::cerr << "[murxla] SMT2: Error: expected 'success' response from "
+                  << get_external_name(i) << " but got '" << res << "'"
+                  << std::endl;
+        exit(EXIT_ERROR);
+      }
+    }
+  }
+  d_pending.clear();
 }
 
 void
-Smt2Solver::dump_smt2(std::string s, ResponseKind expected)
+Smt2Solver::sync_reused_process(size_t i)
 {
-  d_out << s << std::endl << std::flush;
-  if (d_online) push_to_external(s, expected);
+  std::stringstream ss;
+  ss << "murxla-sync-" << getpid();
+  std::string token = ss.str();
+
+  FILE* file_to = d_externals[i].file_to;
+  fputs(("(echo \"" + token + "\")\n").c_str(), file_to);
+  fflush(file_to);
+  for (;;)
+  {
+    std::string_view res = get_from_external(i, false);
+    trim_str(res);
+    if (res == Smt2Reader::RESPONSE_EOF)
+    {
+      std::cerr << "[murxla] SMT2: Error: process of reused "
+                << get_external_name(i) << " terminated unexpectedly"
+                << std::endl;
+      exit(EXIT_ERROR);
+    }
+    /* Some solvers print the echoed string without quotes. */
+    if (res.size() >= 2 && res.front() == '"' && res.back() == '"')
+    {
+      res = res.substr(1, res.size() - 2);
+    }
+    if (res == token) break;
+  }
 }
 
-Smt2Solver::Smt2Solver(SolverSeedGenerator& sng,
-                       std::ostream& out,
-                       const std::string& solver_binary)
-    : Solver(sng),
-      d_out(out),
-      d_online(!solver_binary.empty()),
-      d_file_to(nullptr),
-      d_file_from(nullptr),
-      d_solver_call(solver_binary)
+std::string_view
+Smt2Solver::get_from_external(size_t i, bool echo)
 {
+  std::string_view res = d_externals[i].reader->read();
+  if (echo)
+  {
+    /* In fan-out mode, prefix responses with the index of the solver. */
+    std::stringstream prefix;
+    prefix << "; ";
+    if (d_externals.size() > 1) prefix << "[" << i << "] ";
+    for (size_t pos = 0, n = res.size(); pos <= n;)
+    {
+      size_t end = std::min(res.find('\n', pos), n);
+      d_out << prefix.str() << res.substr(pos, end - pos) << "\n";
+      pos = end + 1;
+    }
+    d_out << std::flush;
+  }
+  return res;
 }
 
-Smt2Solver::~Smt2Solver()
+std::string
+Smt2Solver::get_external_name(size_t i) const
 {
-  if (d_online_pid)
+  if (d_externals.size() == 1)
   {
-    assert(d_online);
-    waitpid(d_online_pid, nullptr, 0);
+    return "online solver";
   }
+  return "online solver '" + d_externals[i].solver_call + "'";
 }
 
 void
-Smt2Solver::new_solver()
+Smt2Solver::dump_smt2(std::string s, ResponseKind expected)
 {
-  if (d_online)
+  if (d_online && d_pipelined && expected == ResponseKind::SMT2_SUCCESS)
   {
-    int32_t fd_to[2], fd_from[2];
+    /* Written to d_out together with its response, see sync_external(). */
+    push_to_external(s, expected);
+    return;
+  }
+  if (d_online) sync_external();
+  d_out << s << std::endl << std::flush;
+  if (d_online) push_to_external(s, expected);
+}
 
-    /* Open input/output pipes from and to the external online solver. */
-    MURXLA_EXIT_ERROR(pipe(fd_to) != 0) << "creating input pipe failed";
-    MURXLA_EXIT_ERROR(pipe(fd_from) != 0) << "creating output pipe failed";
+std::string
+Smt2Solver::get_repr(const Term& term, bool define_shared)
+{
+  if (!d_share_terms)
+  {
+    return to_smt2_term(term)->get_repr();
+  }
+  return get_shared_repr(term, define_shared, define_shared);
+}
 
-    d_online_pid = fork();
+std::string
+Smt2Solver::get_shared_repr(const Term& term,
+                            bool define_printed,
+                            bool define_shared)
+{
+  /* Terms that are printed without traversing their arguments. */
+  auto is_opaque = [define_printed, this](const Smt2Term* t) {
+    return !t->d_repr.empty() || !t->d_def.empty() || is_new_scope(t->d_kind)
+           || (define_printed && t->d_printed && is_shareable(t));
+  };
+
+  std::vector<Term> visit;
+  std::unordered_map<const Smt2Term*, std::string> cache;
+  std::unordered_map<const Smt2Term*, uint64_t> refs;
+  std::vector<std::string> lets;
 
-    MURXLA_EXIT_ERROR_FORK(d_online_pid < 0, true)
-        << "forking solver process failed.";
+  /* Compute references. */
+  visit.push_back(term);
+  while (!visit.empty())
+  {
+    const Smt2Term* cur = to_smt2_term(visit.back());
+    visit.pop_back();
 
-    /* Online solver process. */
-    if (d_online_pid == 0)
+    if (cache.emplace(cur, "").second && !is_opaque(cur))
     {
-      close(fd_to[SMT2_WRITE_END]);
-      dup2(fd_to[SMT2_READ_END], STDIN_FILENO);
+      for (const auto& arg : cur->d_args)
+      {
+        visit.push_back(arg);
+        refs[to_smt2_term(arg)] += 1;
+      }
+    }
+  }
+
+  cache.clear();
+  visit.push_back(term);
+  while (!visit.empty())
+  {
+    const Term& t       = visit.back();
+    const Smt2Term* cur = to_smt2_term(t);
+    auto [it, inserted] = cache.emplace(cur, "");
 
-      close(fd_from[SMT2_READ_END]);
-      /* Redirect stdout of external solver to write end. */
-      dup2(fd_from[SMT2_WRITE_END], STDOUT_FILENO);
-      /* Redirect stderr of external solver to write end. */
-      dup2(fd_from[SMT2_WRITE_END], STDERR_FILENO);
+    if (!it->second.empty())
+    {
+      visit.pop_back();
+      continue;
+    }
 
-      std::vector<char*> execv_args;
-      std::string arg;
-      std::stringstream ss(d_solver_call);
-      while (std::getline(ss, arg, ' '))
+    if (!is_opaque(cur))
+    {
+      if (inserted)
+      {
+        for (const auto& arg : cur->d_args)
+        {
+          visit.push_back(arg);
+        }
+        continue;
+      }
+      std::string res = cur->get_node_repr(cache);
+      cur->d_printed  = true;
+      if (refs[cur] > 1)
+      {
+        if (define_shared && is_shareable(cur))
+        {
+          it->second = define(t, res);
+        }
+        else
+        {
+          std::stringstream let;
+          let << "_let" << lets.size() / 2;
+          lets.push_back(let.str());
+          lets.push_back(res);
+          it->second = let.str();
+        }
+      }
+      else
       {
-        execv_args.push_back(strdup(arg.c_str()));
+        it->second = res;
       }
-      execv_args.push_back(nullptr);
+    }
+    else if (!cur->d_repr.empty())
+    {
+      it->second = cur->d_repr;
+    }
+    else if (!cur->d_def.empty())
+    {
+      it->second = cur->d_def;
+    }
+    else if (is_new_scope(cur->d_kind))
+    {
+      it->second = cur->get_repr();
+    }
+    else
+    {
+      /* Printed by a previous command, define it now. */
+      Term def = t;
+      it->second = define(def, get_shared_repr(def, false, true));
+    }
+    visit.pop_back();
+  }
+
+  const std::string& res = cache.at(to_smt2_term(term));
+  assert(!res.empty());
+  if (lets.empty())
+  {
+    return res;
+  }
 
-      execv(execv_args[0], execv_args.data());
+  std::stringstream ss, close;
+  for (size_t i = 0; i < lets.size(); i += 2)
+  {
+    ss << "(let ((" << lets[i] << " " << lets[i + 1] << "))";
+    close << ")";
+  }
+  ss << res << close.str();
+  return ss.str();
+}
+
+bool
+Smt2Solver::is_shareable(const Smt2Term* term) const
+{
+  std::vector<const Smt2Term*> visit{term};
+  while (!visit.empty())
+  {
+    const Smt2Term* cur = visit.back();
+    if (cur->d_shareable >= 0)
+    {
+      visit.pop_back();
+      continue;
+    }
 
-      for (char* s : execv_args)
+    bool shareable = true;
+    if (!cur->d_repr.empty())
+    {
+      shareable = cur->get_leaf_kind() != AbsTerm::LeafKind::VARIABLE;
+    }
+    else if (is_new_scope(cur->d_kind))
+    {
+      shareable = false;
+    }
+    else
+    {
+      bool done = true;
+      for (const auto& arg : cur->d_args)
       {
-        free(s);
+        const Smt2Term* a = to_smt2_term(arg);
+        if (a->d_shareable < 0)
+        {
+          visit.push_back(a);
+          done = false;
+        }
+        else if (a->d_shareable == 0)
+        {
+          shareable = false;
+        }
       }
+      if (!done) continue;
+    }
+    cur->d_shareable = shareable ? 1 : 0;
+    visit.pop_back();
+  }
+  return term->d_shareable == 1;
+}
+
+const std::string&
+Smt2Solver::define(const Term& term, const std::string& body)
+{
+  const Smt2Term* t = to_smt2_term(term);
+  assert(t->d_def.empty());
+  assert(term->get_sort());
+  const auto& s = checked_cast<Smt2Sort*>(term->get_sort().get());
+
+  std::stringstream name;
+  name << "_def" << d_n_defs++;
+  t->d_def = name.str();
+  d_defs.push_back(term);
+
+  std::stringstream smt2;
+  smt2 << "(define-fun " << t->d_def << " () " << s->get_repr() << " " << body
+       << ")";
+  dump_smt2(smt2.str());
+  return t->d_def;
+}
+
+void
+Smt2Solver::clear_defs()
+{
+  for (const Term& t : d_defs)
+  {
+    to_smt2_term(t)->d_def.clear();
+  }
+  d_defs.clear();
+}
+
+Smt2Solver::Smt2Solver(SolverSeedGenerator& sng,
+                       std::ostream& out,
+                       const std::vector<std::string>& solver_binaries,
+                       bool pipelined,
+                       bool share_terms,
+                       const std::vector<Smt2Process*>& processes)
+    : Solver(sng),
+      d_out(out),
+      d_online(!solver_binaries.empty()),
+      d_pipelined(pipelined),
+      d_share_terms(share_terms),
+      d_externals(solver_binaries.size()),
+      d_reuse_process(!processes.empty())
+{
+  assert(!d_reuse_process || processes.size() == solver_binaries.size());
+  for (size_t i = 0, n = solver_binaries.size(); i < n; ++i)
+  {
+    d_externals[i].solver_call = solver_binaries[i];
+    if (d_reuse_process)
+    {
+      d_externals[i].process = processes[i];
+    }
+  }
+}
 
-      MURXLA_EXIT_ERROR_FORK(true, true)
-          << "'" << d_solver_call << "' is not executable";
+Smt2Solver::~Smt2Solver()
+{
+  for (auto& e : d_externals)
+  {
+    if (e.file_to)
+    {
+      fclose(e.file_to);
+    }
+    /* A reused process is collected by the process that started it. */
+    if (e.own_process && e.own_process->is_running())
+    {
+      e.own_process->wait();
+    }
+  }
+}
+
+void
+Smt2Solver::new_solver()
+{
+  /* Kill online solvers in case the SMT2 solver process gets a SIGINT signal.
+   * This ensures that the online solver processes will always be cleaned up
+   * in case they run into a timeout. */
+  s_online_solver_pids.clear();
+  for (size_t i = 0, n = d_externals.size(); i < n; ++i)
+  {
+    External& e = d_externals[i];
+    if (!d_reuse_process)
+    {
+      e.own_process.reset(new Smt2Process(e.solver_call));
+      e.own_process->start();
+      e.process = e.own_process.get();
     }
+    assert(e.process->is_running());
 
-    /* Kill online solver in case the SMT2 solver process gets a SIGINT signal.
-     * This ensures that the online solver process will always be cleaned up in
-     * case it runs into a timeout. */
-    s_online_solver_pid = d_online_pid;
+    s_online_solver_pids.push_back(e.process->get_pid());
     signal(SIGINT, kill_online_solver);
 
-    close(fd_to[SMT2_READ_END]);
-    close(fd_from[SMT2_WRITE_END]);
-    d_file_to   = fdopen(fd_to[SMT2_WRITE_END], "w");
-    d_file_from = fdopen(fd_from[SMT2_READ_END], "r");
+    e.file_to = fdopen(dup(e.process->get_fd_to()), "w");
+    e.reader.reset(new Smt2Reader(e.process->get_fd_from()));
 
-    MURXLA_EXIT_ERROR_FORK(d_file_to == nullptr, true)
+    MURXLA_EXIT_ERROR_FORK(e.file_to == nullptr, true)
         << "opening read channel to external solver failed";
-    MURXLA_EXIT_ERROR_FORK(d_file_from == nullptr, true)
-        << "opening write channel to external solver failed";
+
+    if (d_reuse_process)
+    {
+      sync_reused_process(i);
+    }
   }
 
   d_initialized = true;
@@ -972,7 +1284,21 @@ Smt2Solver::new_solver()
 void
 Smt2Solver::delete_solver()
 {
+  if (d_reuse_process)
+  {
+    /* Keep the processes alive for the next run. The response to '(reset)' is
+     * discarded by the next run, see sync_reused_process(). */
+    sync_external();
+    d_out << "(reset)" << std::endl << std::flush;
+    for (const auto& e : d_externals)
+    {
+      fputs("(reset)\n", e.file_to);
+      fflush(e.file_to);
+    }
+    return;
+  }
   dump_smt2("(exit)");
+  if (d_online) sync_external();
 }
 
 bool
@@ -1062,10 +1388,9 @@ Smt2Solver::mk_fun(const std::string& name,
   }
   smt2 << ") ";
 
-  const auto& t = to_smt2_term(body);
   const auto& s = checked_cast<Smt2Sort*>(body->get_sort().get());
 
-  smt2 << s->get_repr() << " " << t->get_repr() << ")";
+  smt2 << s->get_repr() << " " << get_repr(body) << ")";
 
   dump_smt2(smt2.str());
   std::vector<Term> smt2_args(args.begin(), args.end());
@@ -1914,8 +2239,7 @@ void
 Smt2Solver::assert_formula(const Term& t)
 {
   std::stringstream smt2;
-  Smt2Term* smt2_term = static_cast<Smt2Term*>(t.get());
-  smt2 << "(assert " << smt2_term->get_repr() << ")";
+  smt2 << "(assert " << get_repr(t) << ")";
   dump_smt2(smt2.str());
 }
 
@@ -1933,9 +2257,8 @@ Smt2Solver::check_sat_assuming(const std::vector<Term>& assumptions)
   smt2 << "(check-sat-assuming ( ";
   for (size_t i = 0, n = assumptions.size(); i < n; ++i)
   {
-    Smt2Term* smt2_term = static_cast<Smt2Term*>(assumptions[i].get());
     if (i > 0) smt2 << " ";
-    smt2 << smt2_term->get_repr();
+    smt2 << get_repr(assumptions[i], false);
   }
   smt2 << "))";
   dump_smt2(smt2.str(), ResponseKind::SMT2_SAT);
@@ -1990,6 +2313,7 @@ void
 Smt2Solver::reset()
 {
   dump_smt2("(reset)");
+  clear_defs();
 }
 
 void
@@ -2083,9 +2407,8 @@ Smt2Solver::get_value(const std::vector<Term>& terms)
   smt2 << "(get-value (";
   for (size_t i = 0, n = terms.size(); i < n; ++i)
   {
-    Smt2Term* smt2_term = static_cast<Smt2Term*>(terms[i].get());
     if (i > 0) smt2 << " ";
-    smt2 << smt2_term->get_repr();
+    smt2 << get_repr(terms[i], false);
   }
   smt2 << "))";
   dump_smt2(smt2.str(), ResponseKind::SMT2_SEXPR);
@@ -10,7 +10,11 @@
 #ifndef __MURXLA__SMT2_SOLVER_H
 #define __MURXLA__SMT2_SOLVER_H
 
+#include <deque>
+
 #include "fsm.hpp"
+#include "solver/smt2/smt2_process.hpp"
+#include "solver/smt2/smt2_reader.hpp"
 #include "solver/solver.hpp"
 #include "theory.hpp"
 
@@ -93,6 +97,8 @@ class Smt2Sort : public AbsSort
 
 class Smt2Term : public AbsTerm
 {
+  friend class Smt2Solver;
+
  public:
   Smt2Term(Op::Kind kind,
            std::vector<std::string> str_args,
@@ -119,6 +125,13 @@ class Smt2Term : public AbsTerm
   const std::string get_repr() const;
 
  private:
+  /**
+   * Get the smt2 representation of this term as a node, i.e., with its
+   * arguments represented by their entries in 'cache'.
+   */
+  std::string get_node_repr(
+      const std::unordered_map<const Smt2Term*, std::string>& cache) const;
+
   /** The operator kind of this term. */
   Op::Kind d_kind;
   /** The string arguments of this term. Only needed for DT operator kinds. */
@@ -130,6 +143,18 @@ class Smt2Term : public AbsTerm
   /** The smt2 representation of this term. */
   std::string d_repr;
 
+  /* Shared printing state, only used if term sharing is enabled. */
+
+  /** The name of the global definition of this term, empty if undefined. */
+  mutable std::string d_def;
+  /** True if this term was printed by a previous command. */
+  mutable bool d_printed = false;
+  /**
+   * Cached result of Smt2Solver::is_shareable(): 1 if shareable, 0 if not,
+   * -1 if not yet computed.
+   */
+  mutable int8_t d_shareable = -1;
+
   std::unordered_map<std::string, std::string> d_op_kind_to_str = {
       {Op::DISTINCT, "distinct"},
       {Op::EQUAL, "="},
@@ -373,9 +398,31 @@ class Smt2Term : public AbsTerm
 class Smt2Solver : public Solver
 {
  public:
+  /**
+   * Constructor.
+   *
+   * sng            : The associated solver seed generator.
+   * out            : The output stream to dump the SMT-LIB output to.
+   * solver_binaries: The solver binaries to pass the SMT-LIB output to
+   *                  (online mode), empty if offline. If more than one
+   *                  binary is given, each command is sent to all of them
+   *                  and their responses are compared (fan-out mode).
+   * pipelined      : True to not wait for 'success' responses of the online
+   *                  solvers after each command, see push_to_external().
+   * share_terms    : True to define shared subterms globally, see
+   *                  get_repr().
+   * processes      : The running external solver processes to use in online
+   *                  mode (one per solver binary), empty to start new
+   *                  processes for this solver. The processes are reused
+   *                  across runs and cleaned up via '(reset)' on
+   *                  delete_solver() rather than terminated via '(exit)'.
+   */
   Smt2Solver(SolverSeedGenerator& sng,
              std::ostream& out,
-             const std::string& solver_binary);
+             const std::vector<std::string>& solver_binaries,
+             bool pipelined                             = false,
+             bool share_terms                           = false,
+             const std::vector<Smt2Process*>& processes = {});
   ~Smt2Solver() override;
 
   void new_solver() override;
@@ -469,14 +516,129 @@ class Smt2Solver : public Solver
     SMT2_SEXPR,
   };
 
+  /**
+   * The maximum number of commands that wait for their 'success' response in
+   * pipelined mode. Bounds the amount of unread output of the online solver,
+   * which would otherwise block on a full pipe.
+   */
+  static constexpr size_t MAX_PENDING = 1024;
+
+  /** An external online solver. */
+  struct External
+  {
+    /** The solver binary to execute, with its arguments. */
+    std::string solver_call;
+    /** The external solver process, if started by this solver. */
+    std::unique_ptr<Smt2Process> own_process;
+    /** The external solver process. */
+    Smt2Process* process = nullptr;
+    /** The channel to send commands to the external solver. */
+    FILE* file_to = nullptr;
+    /** The reader for the responses of the external solver. */
+    std::unique_ptr<Smt2Reader> reader;
+    /** True if writing to the external solver failed. */
+    bool write_failed = false;
+  };
+
+  /**
+   * Send command to the online solvers and check their responses.
+   *
+   * The command is first sent to all online solvers, and their responses are
+   * read afterwards. The solvers thus process the command concurrently, and
+   * the cost of a command is the maximum rather than the sum of their
+   * latencies. In fan-out mode, differing check-sat results are reported as
+   * error.
+   *
+   * In pipelined mode, the 'success' responses of commands that expect a
+   * 'success' response are not read immediately. These commands are queued
+   * and their responses are only checked on the next command that expects
+   * a different response (see sync_external()).
+   */
   void push_to_external(std::string s, ResponseKind expected);
-  std::string get_from_external() const;
+  /**
+   * Check the responses of all pending commands in pipelined mode.
+   * An unexpected response is reported together with the command it was
+   * given for.
+   */
+  void sync_external();
+  /**
+   * Discard the output of the reused external solver process of the i-th
+   * online solver that was not read by previous runs, e.g., the response to
+   * '(reset)', which depends on the value of :print-success. Synchronizes
+   * via an echo command.
+   */
+  void sync_reused_process(size_t i);
+  /**
+   * Read a response from the i-th online solver. If 'echo' is true, the
+   * response is echoed to d_out as SMT-LIB comment.
+   *
+   * The returned view is only valid until the next response is read from
+   * this solver.
+   */
+  std::string_view get_from_external(size_t i, bool echo = true);
+  /**
+   * Get the name of the i-th online solver to be used in error messages.
+   * Includes the solver binary only in fan-out mode.
+   */
+  std::string get_external_name(size_t i) const;
   void dump_smt2(std::string s,
                  ResponseKind expected = ResponseKind::SMT2_SUCCESS);
+
+  /**
+   * Get the smt2 representation of given term as argument of a command.
+   *
+   * If term sharing is enabled, shareable subterms that occur more than once
+   * in the term or were already printed by a previous command are defined
+   * globally via define-fun, and referenced by name from then on. The
+   * definitions are dumped immediately, i.e., before the command that is
+   * currently being printed. Only the new structure of a term is serialized,
+   * previously defined subterms are not traversed again.
+   *
+   * If 'define_shared' is false, no new definitions are dumped and subterms
+   * that occur more than once are let-bound instead. This is required for
+   * queries such as get-value, which must directly follow the check-sat call
+   * they refer to.
+   *
+   * If term sharing is disabled, this is equivalent to Smt2Term::get_repr().
+   */
+  std::string get_repr(const Term& term, bool define_shared = true);
+  /**
+   * Helper for get_repr().
+   *
+   * If 'define_printed' is true, shareable subterms that were printed by a
+   * previous command are defined globally, else they are printed in place.
+   * If 'define_shared' is false, no new definitions are created.
+   */
+  std::string get_shared_repr(const Term& term,
+                              bool define_printed,
+                              bool define_shared);
+  /**
+   * Determine if given term is shareable, i.e., if it can be defined globally.
+   * A term is shareable if it does not contain variables or binders.
+   */
+  bool is_shareable(const Smt2Term* term) const;
+  /**
+   * Define given term globally with the given smt2 representation as body.
+   * Returns the name of the definition.
+   */
+  const std::string& define(const Term& term, const std::string& body);
+  /**
+   * Forget all global definitions. Called on reset, which also resets
+   * :global-declarations. Definitions are kept on pop and reset-assertions
+   * since :global-declarations is always enabled.
+   */
+  void clear_defs();
+
   std::ostream& d_out = std::cout;
   bool d_online       = false;
-  FILE* d_file_to     = nullptr;
-  FILE* d_file_from   = nullptr;
+  bool d_pipelined    = false;
+  bool d_share_terms  = false;
+  /** The online solvers. */
+  std::vector<External> d_externals;
+  /** True if the external solver processes are reused across runs. */
+  bool d_reuse_process = false;
+  /** The commands that wait for their 'success' response (pipelined mode). */
+  std::deque<std::string> d_pending;
 
   bool d_initialized               = false;
   bool d_incremental               = false;
@@ -487,14 +649,12 @@ class Smt2Solver : public Solver
   uint32_t d_n_unnamed_ufs         = 0;
   uint32_t d_n_unnamed_vars        = 0;
   uint64_t d_define_sort_param_cnt = 0;
+  uint64_t d_n_defs                = 0;
   Solver::Result d_last_result     = Solver::Result::UNKNOWN;
 
-  static constexpr int32_t SMT2_READ_END  = 0;
-  static constexpr int32_t SMT2_WRITE_END = 1;
-
-  pid_t d_online_pid = 0;
-  std::string d_solver_call;
   std::unordered_map<std::string, std::string> d_sort_fun_map;
+  /** The terms that are currently defined globally (term sharing). */
+  std::vector<Term> d_defs;
 };
 
 /* -------------------------------------------------------------------------- */
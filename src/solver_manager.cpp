@@ -770,7 +770,7 @@ SolverManager::report_result(Solver::Result res)
   d_sat_result = res;
   d_sat_called = true;
   ++d_n_sat_calls;
-  ++d_mbt_stats->d_results[res];
+  d_mbt_stats->inc_result(res);
 }
 
 std::unordered_map<std::string, std::string>
@@ -27,7 +27,7 @@
 namespace murxla {
 
 namespace statistics {
-struct Statistics;
+class Statistics;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -36,6 +36,7 @@ class SolverManager
 {
   friend class FSM;
   friend class DD;
+  friend class Murxla;
 
  public:
   using SortSet = std::unordered_set<Sort>;
@@ -9,35 +9,469 @@
  */
 #include "statistics.hpp"
 
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <sstream>
+
+#include "except.hpp"
 #include "op.hpp"
 #include "solver/solver.hpp"
 
 namespace murxla {
 namespace statistics {
 
+void
+Statistics::set_shard(uint32_t shard)
+{
+  assert(shard < MURXLA_STATS_N_SHARDS);
+  s_shard = shard;
+}
+
+Statistics::~Statistics()
+{
+  if (d_counters)
+  {
+    munmap(d_counters, d_size);
+  }
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint64_t
+Statistics::register_kind(const std::string& kind,
+                          std::vector<std::string>& names,
+                          std::unordered_map<std::string, uint64_t>& ids)
+{
+  auto [it, inserted] = ids.emplace(kind, names.size());
+  if (inserted)
+  {
+    names.push_back(kind);
+  }
+  return it->second;
+}
+
+uint64_t
+Statistics::register_op(const std::string& kind)
+{
+  return register_kind(kind, d_op_kinds, d_op_ids);
+}
+
+uint64_t
+Statistics::register_state(const std::string& kind)
+{
+  return register_kind(kind, d_state_kinds, d_state_ids);
+}
+
+uint64_t
+Statistics::register_action(const std::string& kind)
+{
+  return register_kind(kind, d_action_kinds, d_action_ids);
+}
+
+uint64_t
+Statistics::register_transition(const std::string& state,
+                                const std::string& action,
+                                const std::string& next,
+                                uint64_t weight)
+{
+  auto [it, inserted] = d_transition_ids.emplace(
+      state + "\n" + action + "\n" + next, d_transitions.size());
+  if (inserted)
+  {
+    d_transitions.push_back({state, action, next, weight});
+  }
+  return it->second;
+}
+
+void
+Statistics::allocate(bool timing)
+{
+  assert(!d_counters);
+
+  d_num_counters[RESULTS]              = 3;
+  d_num_counters[OPS]                  = d_op_kinds.size();
+  d_num_counters[OPS_OK]               = d_op_kinds.size();
+  d_num_counters[SORTS]                = SORT_ANY;
+  d_num_counters[SORTS_OK]             = SORT_ANY;
+  d_num_counters[STATES]               = d_state_kinds.size();
+  d_num_counters[ACTIONS]              = d_action_kinds.size();
+  d_num_counters[ACTIONS_OK]           = d_action_kinds.size();
+  d_num_counters[TRANSITIONS]          = d_transitions.size();
+  d_num_counters[TRANSITIONS_OK]       = d_transitions.size();
+  d_num_counters[TRANSITIONS_DISABLED] = d_transitions.size();
+  if (timing)
+  {
+    d_num_counters[ACTION_TIMES] = d_action_kinds.size() * HIST_SIZE;
+    d_num_counters[OP_TIMES]     = d_op_kinds.size() * HIST_SIZE;
+  }
+  d_timing = timing;
+
+  size_t size = 0;
+  for (uint32_t k = 0; k < N_COUNTER_KINDS; ++k)
+  {
+    d_offsets[k] = size;
+    size += d_num_counters[k];
+  }
+  /* Align shards to cache lines. */
+  size_t per_line = MURXLA_CACHE_LINE_SIZE / sizeof(std::atomic<uint64_t>);
+  d_shard_size    = (size + per_line - 1) / per_line * per_line;
+  d_size = d_shard_size * MURXLA_STATS_N_SHARDS * sizeof(std::atomic<uint64_t>);
+
+  void* mem = mmap(nullptr,
+                   d_size,
+                   PROT_READ | PROT_WRITE,
+                   MAP_ANONYMOUS | MAP_SHARED,
+                   -1,
+                   0);
+  if (mem == MAP_FAILED)
+  {
+    throw MurxlaException("failed to map shared memory for statistics");
+  }
+  d_counters = static_cast<std::atomic<uint64_t>*>(mem);
+  for (size_t i = 0, n = d_shard_size * MURXLA_STATS_N_SHARDS; i < n; ++i)
+  {
+    new (&d_counters[i]) std::atomic<uint64_t>(0);
+  }
+}
+
+void
+Statistics::load(const std::vector<nlohmann::json>& stats)
+{
+  bool timing = false;
+  for (const auto& j : stats)
+  {
+    for (const auto& [kind, n] : j.at("states").items())
+    {
+      register_state(kind);
+    }
+    for (const auto& [kind, n] : j.at("actions").items())
+    {
+      register_action(kind);
+    }
+    for (const auto& [kind, n] : j.at("ops").items())
+    {
+      register_op(kind);
+    }
+    for (const auto& t : j.at("transitions"))
+    {
+      register_transition(t.at("state"),
+                          t.at("action"),
+                          t.at("next"),
+                          t.at("weight").get<uint64_t>());
+    }
+    timing = timing || j.contains("action_times");
+  }
+
+  allocate(timing);
+
+  for (const auto& j : stats)
+  {
+    add(j);
+  }
+}
+
+void
+Statistics::add(const nlohmann::json& stats)
+{
+  using IdMap = std::unordered_map<std::string, uint64_t>;
+
+  auto add_kinds = [this](CounterKind kind,
+                          CounterKind kind_ok,
+                          const nlohmann::json& counts,
+                          const IdMap& ids) {
+    for (const auto& [name, n] : counts.items())
+    {
+      auto it = ids.find(name);
+      if (it == ids.end()) continue;
+      add(kind, it->second, n.at(0));
+      add(kind_ok, it->second, n.at(1));
+    }
+  };
+  auto add_hists = [this](CounterKind kind,
+                          const nlohmann::json& hists,
+                          const IdMap& ids) {
+    for (const auto& [name, hist] : hists.items())
+    {
+      auto it = ids.find(name);
+      if (it == ids.end()) continue;
+      for (uint32_t i = 0; i < HIST_SIZE; ++i)
+      {
+        add(kind, it->second * HIST_SIZE + i, hist.at(i));
+      }
+    }
+  };
+
+  for (uint32_t i = 0; i < 3; ++i)
+  {
+    add(RESULTS, i, stats.at("results").at(i));
+  }
+  for (uint32_t i = 0; i < SORT_ANY; ++i)
+  {
+    add(SORTS, i, stats.at("sorts").at(i).at(0));
+    add(SORTS_OK, i, stats.at("sorts").at(i).at(1));
+  }
+  for (const auto& [name, n] : stats.at("states").items())
+  {
+    auto it = d_state_ids.find(name);
+    if (it == d_state_ids.end()) continue;
+    add(STATES, it->second, n);
+  }
+  add_kinds(ACTIONS, ACTIONS_OK, stats.at("actions"), d_action_ids);
+  add_kinds(OPS, OPS_OK, stats.at("ops"), d_op_ids);
+  for (const auto& t : stats.at("transitions"))
+  {
+    auto it = d_transition_ids.find(t.at("state").get<std::string>() + "\n"
+                                    + t.at("action").get<std::string>() + "\n"
+                                    + t.at("next").get<std::string>());
+    if (it == d_transition_ids.end()) continue;
+    add(TRANSITIONS, it->second, t.at("taken"));
+    add(TRANSITIONS_OK, it->second, t.at("ok"));
+    add(TRANSITIONS_DISABLED, it->second, t.at("disabled"));
+  }
+  if (stats.contains("action_times"))
+  {
+    add_hists(ACTION_TIMES, stats.at("action_times"), d_action_ids);
+    add_hists(OP_TIMES, stats.at("op_times"), d_op_ids);
+  }
+}
+
+void
+Statistics::reset()
+{
+  for (size_t i = 0, n = d_size / sizeof(std::atomic<uint64_t>); i < n; ++i)
+  {
+    d_counters[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+nlohmann::json
+Statistics::to_json(bool nonzero_only) const
+{
+  Counters counters = aggregate();
+  nlohmann::json j;
+
+  j["results"] = counters.d_results;
+  j["sorts"]   = nlohmann::json::array();
+  for (uint32_t i = 0; i < SORT_ANY; ++i)
+  {
+    j["sorts"].push_back({counters.d_sorts[i], counters.d_sorts_ok[i]});
+  }
+  j["states"] = nlohmann::json::object();
+  for (size_t i = 0, n = counters.d_states.size(); i < n; ++i)
+  {
+    if (nonzero_only && counters.d_states[i] == 0) continue;
+    j["states"][d_state_kinds[i]] = counters.d_states[i];
+  }
+  j["actions"] = nlohmann::json::object();
+  for (size_t i = 0, n = counters.d_actions.size(); i < n; ++i)
+  {
+    if (nonzero_only && counters.d_actions[i] == 0
+        && counters.d_actions_ok[i] == 0)
+    {
+      continue;
+    }
+    j["actions"][d_action_kinds[i]] = {counters.d_actions[i],
+                                       counters.d_actions_ok[i]};
+  }
+  j["ops"] = nlohmann::json::object();
+  for (size_t i = 0, n = counters.d_ops.size(); i < n; ++i)
+  {
+    if (nonzero_only && counters.d_ops[i] == 0 && counters.d_ops_ok[i] == 0)
+    {
+      continue;
+    }
+    j["ops"][d_op_kinds[i]] = {counters.d_ops[i], counters.d_ops_ok[i]};
+  }
+  j["transitions"] = nlohmann::json::array();
+  for (size_t i = 0, n = counters.d_transitions.size(); i < n; ++i)
+  {
+    if (nonzero_only && counters.d_transitions[i] == 0
+        && counters.d_transitions_ok[i] == 0
+        && counters.d_transitions_disabled[i] == 0)
+    {
+      continue;
+    }
+    const Transition& t = d_transitions[i];
+    j["transitions"].push_back(
+        {{"state", t.d_state},
+         {"action", t.d_action},
+         {"next", t.d_next},
+         {"weight", t.d_weight},
+         {"taken", counters.d_transitions[i]},
+         {"ok", counters.d_transitions_ok[i]},
+         {"disabled", counters.d_transitions_disabled[i]}});
+  }
+  if (d_timing)
+  {
+    auto hists = [nonzero_only](const std::vector<uint64_t>& times,
+                                const std::vector<std::string>& names) {
+      nlohmann::json res = nlohmann::json::object();
+      for (size_t i = 0, n = times.size() / HIST_SIZE; i < n; ++i)
+      {
+        auto begin = times.begin() + i * HIST_SIZE;
+        auto end   = begin + HIST_SIZE;
+        if (nonzero_only
+            && std::all_of(begin, end, [](uint64_t t) { return t == 0; }))
+        {
+          continue;
+        }
+        res[names[i]] = std::vector<uint64_t>(begin, end);
+      }
+      return res;
+    };
+    j["action_times"] = hists(counters.d_action_times, d_action_kinds);
+    j["op_times"]     = hists(counters.d_op_times, d_op_kinds);
+  }
+  return j;
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint32_t
+Statistics::get_bucket(uint64_t ns)
+{
+  if (ns < 8)
+  {
+    return static_cast<uint32_t>(ns);
+  }
+  uint32_t exp = 63 - static_cast<uint32_t>(__builtin_clzll(ns));
+  if (exp >= HIST_MAX_EXP)
+  {
+    return HIST_N_BUCKETS - 1;
+  }
+  /* The two bits below the most significant bit select the bucket. */
+  return 8 + (exp - 3) * 4 + static_cast<uint32_t>((ns >> (exp - 2)) & 3);
+}
+
+uint64_t
+Statistics::get_bucket_min(uint32_t bucket)
+{
+  if (bucket < 8)
+  {
+    return bucket;
+  }
+  uint32_t exp = 3 + (bucket - 8) / 4;
+  return static_cast<uint64_t>(4 + (bucket - 8) % 4) << (exp - 2);
+}
+
+void
+Statistics::add(CounterKind kind, uint64_t idx, uint64_t n)
+{
+  if (idx >= d_num_counters[kind])
+  {
+    return;
+  }
+  std::atomic<uint64_t>& counter =
+      d_counters[s_shard * d_shard_size + d_offsets[kind] + idx];
+  if ((kind == ACTION_TIMES || kind == OP_TIMES) && idx % HIST_SIZE == HIST_MAX)
+  {
+    uint64_t max = counter.load(std::memory_order_relaxed);
+    while (n > max
+           && !counter.compare_exchange_weak(max, n, std::memory_order_relaxed))
+    {
+    }
+  }
+  else
+  {
+    counter.fetch_add(n, std::memory_order_relaxed);
+  }
+}
+
+void
+Statistics::add_time(CounterKind kind, uint64_t id, uint64_t ns)
+{
+  add(kind, id * HIST_SIZE + get_bucket(ns), 1);
+  add(kind, id * HIST_SIZE + HIST_SUM, ns);
+  add(kind, id * HIST_SIZE + HIST_MAX, ns);
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint64_t
+Statistics::get_num_results(uint32_t res) const
+{
+  return sum(RESULTS)[res];
+}
+
+std::vector<uint64_t>
+Statistics::sum(CounterKind kind) const
+{
+  /* The number of results and sorts is fixed, even if not allocated. */
+  size_t size = d_num_counters[kind];
+  if (kind == RESULTS) size = 3;
+  if (kind == SORTS || kind == SORTS_OK) size = SORT_ANY;
+
+  std::vector<uint64_t> res(size);
+  for (uint32_t s = 0; d_counters && s < MURXLA_STATS_N_SHARDS; ++s)
+  {
+    const std::atomic<uint64_t>* counters =
+        &d_counters[s * d_shard_size + d_offsets[kind]];
+    for (size_t i = 0, n = d_num_counters[kind]; i < n; ++i)
+    {
+      uint64_t value = counters[i].load(std::memory_order_relaxed);
+      if ((kind == ACTION_TIMES || kind == OP_TIMES)
+          && i % HIST_SIZE == HIST_MAX)
+      {
+        res[i] = std::max(res[i], value);
+      }
+      else
+      {
+        res[i] += value;
+      }
+    }
+  }
+  return res;
+}
+
+Counters
+Statistics::aggregate() const
+{
+  Counters res;
+  res.d_results              = sum(RESULTS);
+  res.d_ops                  = sum(OPS);
+  res.d_ops_ok               = sum(OPS_OK);
+  res.d_sorts                = sum(SORTS);
+  res.d_sorts_ok             = sum(SORTS_OK);
+  res.d_states               = sum(STATES);
+  res.d_actions              = sum(ACTIONS);
+  res.d_actions_ok           = sum(ACTIONS_OK);
+  res.d_transitions          = sum(TRANSITIONS);
+  res.d_transitions_ok       = sum(TRANSITIONS_OK);
+  res.d_transitions_disabled = sum(TRANSITIONS_DISABLED);
+  res.d_action_times         = sum(ACTION_TIMES);
+  res.d_op_times             = sum(OP_TIMES);
+  return res;
+}
+
 void
 Statistics::print() const
 {
+  Counters counters = aggregate();
+
   std::cout << std::endl;
 
   uint64_t sum = 0, sum_ok = 0;
 
   std::cout << "States:" << std::endl;
-  for (uint32_t i = 0; i < MURXLA_MAX_N_STATES && d_state_kinds[i][0]; ++i)
+  for (size_t i = 0, n = counters.d_states.size(); i < n; ++i)
   {
-    std::cout << "  " << d_state_kinds[i] << ": " << d_states[i] << std::endl;
-    sum += d_states[i];
+    std::cout << "  " << d_state_kinds[i] << ": " << counters.d_states[i]
+              << std::endl;
+    sum += counters.d_states[i];
   }
   std::cout << "  Total: " << sum << std::endl;
 
   sum = 0, sum_ok = 0;
   std::cout << "Actions:" << std::endl;
-  for (uint32_t i = 0; i < MURXLA_MAX_N_ACTIONS && d_action_kinds[i][0]; ++i)
+  for (size_t i = 0, n = counters.d_actions.size(); i < n; ++i)
   {
-    std::cout << "  " << d_action_kinds[i] << ": " << d_actions[i] << " ("
-              << d_actions_ok[i] << ")" << std::endl;
-    sum += d_actions[i];
-    sum_ok += d_actions_ok[i];
+    std::cout << "  " << d_action_kinds[i] << ": " << counters.d_actions[i]
+              << " (" << counters.d_actions_ok[i] << ")" << std::endl;
+    sum += counters.d_actions[i];
+    sum_ok += counters.d_actions_ok[i];
   }
   std::cout << "  Total: " << sum << " (" << sum_ok << ")" << std::endl;
 
@@ -45,20 +479,20 @@ Statistics::print() const
   std::cout << "Results:" << std::endl;
   for (uint32_t i = 0; i < 3; ++i)
   {
-    std::cout << "  " << static_cast<Solver::Result>(i) << ": " << d_results[i]
-              << std::endl;
-    sum += d_results[i];
+    std::cout << "  " << static_cast<Solver::Result>(i) << ": "
+              << counters.d_results[i] << std::endl;
+    sum += counters.d_results[i];
   }
   std::cout << "  Total: " << sum << std::endl;
 
   sum = 0, sum_ok = 0;
   std::cout << "Ops:" << std::endl;
-  for (uint32_t i = 0; i < MURXLA_MAX_N_OPS && d_op_kinds[i][0]; ++i)
+  for (size_t i = 0, n = counters.d_ops.size(); i < n; ++i)
   {
-    std::cout << "  " << d_op_kinds[i] << ": " << d_ops[i] << " ("
-              << d_ops_ok[i] << ")" << std::endl;
-    sum += d_ops[i];
-    sum_ok += d_ops_ok[i];
+    std::cout << "  " << d_op_kinds[i] << ": " << counters.d_ops[i] << " ("
+              << counters.d_ops_ok[i] << ")" << std::endl;
+    sum += counters.d_ops[i];
+    sum_ok += counters.d_ops_ok[i];
   }
   std::cout << "  Total: " << sum << " (" << sum_ok << ")" << std::endl;
 
@@ -66,12 +500,172 @@ Statistics::print() const
   std::cout << "Sorts:" << std::endl;
   for (uint32_t i = 0; i < SORT_ANY; ++i)
   {
-    std::cout << "  " << static_cast<SortKind>(i) << ": " << d_sorts[i] << " ("
-              << d_sorts_ok[i] << ")" << std::endl;
-    sum += d_sorts[i];
-    sum_ok += d_sorts_ok[i];
+    std::cout << "  " << static_cast<SortKind>(i) << ": "
+              << counters.d_sorts[i] << " (" << counters.d_sorts_ok[i] << ")"
+              << std::endl;
+    sum += counters.d_sorts[i];
+    sum_ok += counters.d_sorts_ok[i];
   }
   std::cout << "  Total: " << sum << " (" << sum_ok << ")" << std::endl;
+
+  print_transitions(counters);
+
+  if (d_timing)
+  {
+    std::cout << "Action times:" << std::endl;
+    print_times(counters.d_action_times, d_action_kinds);
+    std::cout << "Op times (term creation):" << std::endl;
+    print_times(counters.d_op_times, d_op_kinds);
+  }
+}
+
+namespace {
+
+/** Format given latency in nanoseconds with an appropriate unit. */
+std::string
+format_time(uint64_t ns)
+{
+  std::stringstream ss;
+  if (ns < 1000)
+  {
+    ss << ns << "ns";
+    return ss.str();
+  }
+  double t = static_cast<double>(ns);
+  ss << std::fixed << std::setprecision(2);
+  if (ns < 1000000)
+  {
+    ss << t / 1e3 << "us";
+  }
+  else if (ns < 1000000000)
+  {
+    ss << t / 1e6 << "ms";
+  }
+  else
+  {
+    ss << t / 1e9 << "s";
+  }
+  return ss.str();
+}
+
+}  // namespace
+
+void
+Statistics::print_transitions(const Counters& counters) const
+{
+  std::stringstream header;
+  header << "| " << std::setw(25) << "Action"
+         << " | " << std::setw(12) << "Expected [%]"
+         << " | " << std::setw(12) << "Observed [%]"
+         << " | " << std::setw(10) << "Taken"
+         << " | " << std::setw(11) << "Success [%]"
+         << " | " << std::setw(8) << "Disabled"
+         << " | " << std::setw(20) << "Next"
+         << " |";
+  std::string hr(header.str().size(), '-');
+
+  std::unordered_map<std::string, std::vector<size_t>> state_transitions;
+  for (size_t i = 0, n = d_transitions.size(); i < n; ++i)
+  {
+    state_transitions[d_transitions[i].d_state].push_back(i);
+  }
+
+  std::cout << "Transitions:" << std::endl;
+  for (const auto& state : d_state_kinds)
+  {
+    auto it = state_transitions.find(state);
+    if (it == state_transitions.end()) continue;
+
+    std::vector<size_t>& ids = it->second;
+    uint64_t sum_weights = 0, sum_taken = 0;
+    for (size_t id : ids)
+    {
+      sum_weights += d_transitions[id].d_weight;
+      sum_taken += counters.d_transitions[id];
+    }
+    std::sort(ids.begin(), ids.end(), [this](size_t a, size_t b) {
+      return d_transitions[a].d_weight > d_transitions[b].d_weight;
+    });
+
+    std::cout << std::endl
+              << "State: " << state << " (" << sum_taken << ")" << std::endl;
+    std::cout << hr << std::endl;
+    std::cout << header.str() << std::endl;
+    std::cout << hr << std::endl;
+    for (size_t id : ids)
+    {
+      const Transition& t = d_transitions[id];
+      uint64_t taken      = counters.d_transitions[id];
+      auto percent        = [](uint64_t n, uint64_t total) {
+        return total ? 100.0 * static_cast<double>(n)
+                           / static_cast<double>(total)
+                            : 0.0;
+      };
+
+      std::stringstream row;
+      row << std::setprecision(2) << std::fixed;
+      row << "| " << std::setw(25) << t.d_action;
+      row << " | " << std::setw(12) << percent(t.d_weight, sum_weights);
+      row << " | " << std::setw(12) << percent(taken, sum_taken);
+      row << " | " << std::setw(10) << taken;
+      row << " | " << std::setw(11)
+          << percent(counters.d_transitions_ok[id], taken);
+      row << " | " << std::setw(8) << counters.d_transitions_disabled[id];
+      row << " | " << std::setw(20) << (t.d_next != state ? t.d_next : "")
+          << " |";
+      std::cout << row.str() << std::endl;
+    }
+    std::cout << hr << std::endl;
+  }
+}
+
+void
+Statistics::print_times(const std::vector<uint64_t>& times,
+                        const std::vector<std::string>& names)
+{
+  uint64_t total = 0;
+  for (size_t i = 0, n = times.size() / HIST_SIZE; i < n; ++i)
+  {
+    total += times[i * HIST_SIZE + HIST_SUM];
+  }
+
+  for (size_t i = 0, n = times.size() / HIST_SIZE; i < n; ++i)
+  {
+    const uint64_t* hist = &times[i * HIST_SIZE];
+    uint64_t count       = 0;
+    for (uint32_t b = 0; b < HIST_N_BUCKETS; ++b)
+    {
+      count += hist[b];
+    }
+    if (count == 0) continue;
+
+    /* Percentiles are reported as the upper bound of their bucket. */
+    auto percentile = [&](uint64_t p) {
+      uint64_t rank = (count * p + 99) / 100, seen = 0;
+      uint32_t b    = 0;
+      for (; b < HIST_N_BUCKETS - 1; ++b)
+      {
+        seen += hist[b];
+        if (seen >= rank) break;
+      }
+      uint64_t upper = b < HIST_N_BUCKETS - 1 ? get_bucket_min(b + 1) - 1
+                                               : hist[HIST_MAX];
+      return std::min(upper, hist[HIST_MAX]);
+    };
+
+    std::stringstream share;
+    share << std::fixed << std::setprecision(1)
+          << 100.0 * static_cast<double>(hist[HIST_SUM])
+                 / static_cast<double>(std::max<uint64_t>(total, 1));
+
+    std::cout << "  " << names[i] << ": " << count
+              << " (p50: " << format_time(percentile(50))
+              << ", p99: " << format_time(percentile(99))
+              << ", max: " << format_time(hist[HIST_MAX])
+              << ", total: " << format_time(hist[HIST_SUM]) << ", "
+              << share.str() << "%)" << std::endl;
+  }
+  std::cout << "  Total: " << format_time(total) << std::endl;
 }
 
 }  // namespace statistics
@@ -10,6 +10,14 @@
 #ifndef __MURXLA__STATISTICS_H
 #define __MURXLA__STATISTICS_H
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "config.hpp"
 #include "op.hpp"
 
@@ -17,27 +25,327 @@ namespace murxla {
 
 namespace statistics {
 
+/** The size of a cache line, shards are aligned to cache lines. */
+#define MURXLA_CACHE_LINE_SIZE 64
+
+/** Aggregated statistics counters. */
+struct Counters
+{
+  std::vector<uint64_t> d_results;
+  std::vector<uint64_t> d_ops;
+  std::vector<uint64_t> d_ops_ok;
+  std::vector<uint64_t> d_sorts;
+  std::vector<uint64_t> d_sorts_ok;
+  std::vector<uint64_t> d_states;
+  std::vector<uint64_t> d_actions;
+  std::vector<uint64_t> d_actions_ok;
+  /** The number of taken, successful and disabled FSM transitions. */
+  std::vector<uint64_t> d_transitions;
+  std::vector<uint64_t> d_transitions_ok;
+  std::vector<uint64_t> d_transitions_disabled;
+  /**
+   * The latency histograms of actions and operators, if timing is enabled.
+   * Stores Statistics::HIST_SIZE values per kind, see Statistics::Timer.
+   */
+  std::vector<uint64_t> d_action_times;
+  std::vector<uint64_t> d_op_times;
+};
+
 /**
  * Statistics.
  *
- * The main statistics object is located in shared memory. We thus only use
- * base types here.
+ * The kinds of operators, states and actions are registered by name (see
+ * register_op(), register_state() and register_action()), which assigns
+ * them ids that are independent of the configuration of a specific test
+ * run. All kinds are registered by the main process before any test run is
+ * forked, and the counters are then allocated in shared memory, sized for
+ * the registered kinds (see allocate()). Test runs only increment counters,
+ * kinds that were not registered before allocation are not counted. A
+ * statistics object that is never allocated does not count anything.
+ *
+ * The counters are sharded into MURXLA_STATS_N_SHARDS cache-line-aligned
+ * shards, each process increments the counters of its own shard (see
+ * set_shard()) with relaxed atomic increments. Processes that run
+ * concurrently thus neither lose updates nor share cache lines (unless they
+ * are assigned the same shard, which is still correct). The counters are
+ * aggregated over all shards when read.
+ *
+ * Optionally, the latencies of actions and of creating terms of each
+ * operator kind are recorded in log-bucketed histograms (see Timer).
  */
-struct Statistics
+class Statistics
 {
-  uint64_t d_results[3];
-  char d_op_kinds[MURXLA_MAX_N_OPS][MURXLA_MAX_KIND_LEN];
-  uint64_t d_ops[MURXLA_MAX_N_OPS];
-  uint64_t d_ops_ok[MURXLA_MAX_N_OPS];
-  uint64_t d_sorts[SORT_ANY];
-  uint64_t d_sorts_ok[SORT_ANY];
-  char d_state_kinds[MURXLA_MAX_N_STATES][MURXLA_MAX_KIND_LEN];
-  uint64_t d_states[MURXLA_MAX_N_STATES];
-  char d_action_kinds[MURXLA_MAX_N_ACTIONS][MURXLA_MAX_KIND_LEN];
-  uint64_t d_actions[MURXLA_MAX_N_ACTIONS];
-  uint64_t d_actions_ok[MURXLA_MAX_N_ACTIONS];
+  /** The kinds of counters. */
+  enum CounterKind
+  {
+    RESULTS,
+    OPS,
+    OPS_OK,
+    SORTS,
+    SORTS_OK,
+    STATES,
+    ACTIONS,
+    ACTIONS_OK,
+    TRANSITIONS,
+    TRANSITIONS_OK,
+    TRANSITIONS_DISABLED,
+    ACTION_TIMES,
+    OP_TIMES,
+    N_COUNTER_KINDS,
+  };
+
+ public:
+  /** A transition of the FSM. */
+  struct Transition
+  {
+    /** The kinds of the state, its action and the next state. */
+    std::string d_state;
+    std::string d_action;
+    std::string d_next;
+    /**
+     * The configured weight of the transition (the probability of taking the
+     * transition is its weight relative to the sum of the weights of all
+     * transitions of the state).
+     */
+    uint64_t d_weight;
+  };
+
+  /**
+   * The number of buckets of a latency histogram.
+   *
+   * Latencies are recorded in nanoseconds. Latencies below 8ns have a bucket
+   * each, larger latencies are bucketed by power of two, with four buckets
+   * per power of two (i.e., with a relative error of at most 25%). Latencies
+   * of 2^HIST_MAX_EXP nanoseconds (about 18 minutes) and above share the
+   * last bucket.
+   */
+  static constexpr uint32_t HIST_MAX_EXP   = 40;
+  static constexpr uint32_t HIST_N_BUCKETS = 8 + (HIST_MAX_EXP - 3) * 4 + 1;
+  /** The index of the sum and the maximum of the latencies of a histogram. */
+  static constexpr uint32_t HIST_SUM = HIST_N_BUCKETS;
+  static constexpr uint32_t HIST_MAX = HIST_N_BUCKETS + 1;
+  /** The number of values of a histogram. */
+  static constexpr uint32_t HIST_SIZE = HIST_N_BUCKETS + 2;
+
+  /** Get the histogram bucket of given latency. */
+  static uint32_t get_bucket(uint64_t ns);
+  /** Get the smallest latency of given histogram bucket. */
+  static uint64_t get_bucket_min(uint32_t bucket);
+
+  /**
+   * Records the time from its construction to its destruction in the
+   * latency histogram of an action or operator kind, see time_action() and
+   * time_op(). Does nothing if timing is disabled.
+   */
+  class Timer
+  {
+   public:
+    ~Timer()
+    {
+      if (d_stats)
+      {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - d_start);
+        d_stats->add_time(d_kind, d_id, static_cast<uint64_t>(ns.count()));
+      }
+    }
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+
+   private:
+    friend class Statistics;
+    Timer(Statistics* stats, CounterKind kind, uint64_t id)
+        : d_stats(stats), d_kind(kind), d_id(id)
+    {
+      if (d_stats)
+      {
+        d_start = std::chrono::steady_clock::now();
+      }
+    }
+
+    Statistics* d_stats;
+    CounterKind d_kind;
+    uint64_t d_id;
+    std::chrono::steady_clock::time_point d_start;
+  };
+
+  static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                "statistics in shared memory require lock-free counters");
+
+  /**
+   * Set the shard of the counters that this process increments.
+   * Must be called in each process before incrementing any counter.
+   */
+  static void set_shard(uint32_t shard);
+
+  Statistics() = default;
+  ~Statistics();
+  Statistics(const Statistics&) = delete;
+  Statistics& operator=(const Statistics&) = delete;
+
+  /**
+   * Register the kind of an operator, state or action.
+   * Returns the id of the kind, kinds that are registered more than once are
+   * assigned the same id.
+   */
+  uint64_t register_op(const std::string& kind);
+  uint64_t register_state(const std::string& kind);
+  uint64_t register_action(const std::string& kind);
+  /**
+   * Register a transition of the FSM with given configured weight.
+   * Returns the id of the transition, transitions that are registered more
+   * than once are assigned the same id (and keep the weight of their first
+   * registration).
+   */
+  uint64_t register_transition(const std::string& state,
+                               const std::string& action,
+                               const std::string& next,
+                               uint64_t weight);
+
+  /**
+   * Allocate the counters for the registered kinds in shared memory.
+   * Must be called (at most once) before forking any process that increments
+   * counters.
+   * timing: True to also allocate latency histograms, see Timer.
+   */
+  void allocate(bool timing = false);
+  /**
+   * Register the kinds of given serialized statistics (see to_json()),
+   * allocate the counters and initialize them with the sum of the counters
+   * of the given statistics. Must be called instead of allocate(), e.g., to
+   * merge the statistics of several campaigns.
+   */
+  void load(const std::vector<nlohmann::json>& stats);
+  /**
+   * Add the counters of given serialized statistics (see to_json()) to the
+   * counters of the shard of this process. Counters of kinds that are not
+   * registered are ignored.
+   */
+  void add(const nlohmann::json& stats);
+  /**
+   * Reset all counters to zero. Must not be called while processes that
+   * increment counters are running.
+   */
+  void reset();
+
+  /**
+   * Serialize the counters aggregated over all shards, together with the
+   * registered kinds.
+   * nonzero_only: True to omit kinds whose counters are all zero, e.g., to
+   *               send deltas. The result can be add()ed but not load()ed.
+   */
+  nlohmann::json to_json(bool nonzero_only = false) const;
+
+  /** Increment the counters of the shard of this process. */
+  void inc_result(uint64_t res) { inc(RESULTS, res); }
+  void inc_op(uint64_t id) { inc(OPS, id); }
+  void inc_op_ok(uint64_t id) { inc(OPS_OK, id); }
+  void inc_sort(uint64_t kind) { inc(SORTS, kind); }
+  void inc_sort_ok(uint64_t kind) { inc(SORTS_OK, kind); }
+  void inc_state(uint64_t id) { inc(STATES, id); }
+  void inc_action(uint64_t id) { inc(ACTIONS, id); }
+  void inc_action_ok(uint64_t id) { inc(ACTIONS_OK, id); }
+  void inc_transition(uint64_t id) { inc(TRANSITIONS, id); }
+  void inc_transition_ok(uint64_t id) { inc(TRANSITIONS_OK, id); }
+  void inc_transition_disabled(uint64_t id) { inc(TRANSITIONS_DISABLED, id); }
+
+  /** Time an action. */
+  Timer time_action(uint64_t id)
+  {
+    return Timer(d_timing ? this : nullptr, ACTION_TIMES, id);
+  }
+  /** Time the creation of a term of given operator kind. */
+  Timer time_op(const std::string& kind)
+  {
+    if (!d_timing)
+    {
+      return Timer(nullptr, OP_TIMES, 0);
+    }
+    auto it = d_op_ids.find(kind);
+    return it == d_op_ids.end() ? Timer(nullptr, OP_TIMES, 0)
+                                : Timer(this, OP_TIMES, it->second);
+  }
+
+  /** Get the names of the registered kinds, indexed by id. */
+  const std::vector<std::string>& get_op_kinds() const { return d_op_kinds; }
+  const std::vector<std::string>& get_state_kinds() const
+  {
+    return d_state_kinds;
+  }
+  const std::vector<std::string>& get_action_kinds() const
+  {
+    return d_action_kinds;
+  }
+  const std::vector<Transition>& get_transitions() const
+  {
+    return d_transitions;
+  }
+
+  /** Get the number of results of given kind over all shards. */
+  uint64_t get_num_results(uint32_t res) const;
+  /** Aggregate the counters of all shards. */
+  Counters aggregate() const;
 
   void print() const;
+
+ private:
+  /** Register given kind in given names and ids. */
+  static uint64_t register_kind(const std::string& kind,
+                                std::vector<std::string>& names,
+                                std::unordered_map<std::string, uint64_t>& ids);
+
+  /** Increment the counter of given kind and id. */
+  void inc(CounterKind kind, uint64_t id)
+  {
+    if (id < d_num_counters[kind])
+    {
+      d_counters[s_shard * d_shard_size + d_offsets[kind] + id].fetch_add(
+          1, std::memory_order_relaxed);
+    }
+  }
+  /**
+   * Add 'n' to the counter at index 'idx' of given kind (for the maximum of
+   * a latency histogram, update the maximum with 'n').
+   */
+  void add(CounterKind kind, uint64_t idx, uint64_t n);
+  /** Record latency 'ns' in the histogram of given kind and id. */
+  void add_time(CounterKind kind, uint64_t id, uint64_t ns);
+  /**
+   * Sum up the counters of given kind over all shards (except for the
+   * maximum latencies of histograms, which are maxed).
+   */
+  std::vector<uint64_t> sum(CounterKind kind) const;
+  /** Print the expected and observed frequencies of the transitions. */
+  void print_transitions(const Counters& counters) const;
+  /** Print the latency histograms of given kind and names. */
+  static void print_times(const std::vector<uint64_t>& times,
+                          const std::vector<std::string>& names);
+
+  /** The names of the registered kinds, indexed by id. */
+  std::vector<std::string> d_op_kinds;
+  std::vector<std::string> d_state_kinds;
+  std::vector<std::string> d_action_kinds;
+  std::vector<Transition> d_transitions;
+  /** Map the names of the registered kinds to their id. */
+  std::unordered_map<std::string, uint64_t> d_op_ids;
+  std::unordered_map<std::string, uint64_t> d_state_ids;
+  std::unordered_map<std::string, uint64_t> d_action_ids;
+  std::unordered_map<std::string, uint64_t> d_transition_ids;
+
+  /** True if latency histograms are allocated. */
+  bool d_timing = false;
+  /** The counters in shared memory, one shard per worker slot. */
+  std::atomic<uint64_t>* d_counters = nullptr;
+  /** The size of the shared memory region in bytes. */
+  size_t d_size = 0;
+  /** The number of counters of a shard, a multiple of the cache line size. */
+  size_t d_shard_size = 0;
+  /** The number and the offsets of the counters of each kind in a shard. */
+  uint64_t d_num_counters[N_COUNTER_KINDS] = {};
+  uint64_t d_offsets[N_COUNTER_KINDS]      = {};
+
+  /** The shard of this process. */
+  inline static uint32_t s_shard = 0;
 };
 
 }  // namespace statistics
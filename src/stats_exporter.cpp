@@ -0,0 +1,215 @@
+/***
+ * Murxla: A Model-Based API Fuzzer for SMT solvers.
+ *
+ * This file is part of Murxla.
+ *
+ * Copyright (C) 2019-2022 by the authors listed in the AUTHORS file.
+ *
+ * See LICENSE for more information on using this software.
+ */
+#include "stats_exporter.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <nlohmann/json.hpp>
+#include <sstream>
+
+#include "solver/solver.hpp"
+#include "util.hpp"
+
+namespace murxla {
+namespace statistics {
+
+/* -------------------------------------------------------------------------- */
+
+Exporter::Exporter(const Statistics* stats,
+                   const std::string& file_name,
+                   const std::string& textfile_name,
+                   double interval)
+    : d_stats(stats),
+      d_file_name(file_name),
+      d_textfile_name(textfile_name),
+      d_interval(interval),
+      d_start_time(get_cur_wall_time())
+{
+  std::filesystem::path path(file_name);
+  d_csv = path.extension() == ".csv";
+
+  d_prev.d_time     = d_start_time;
+  d_prev.d_counters = d_stats->aggregate();
+  d_thread          = std::thread(&Exporter::run, this);
+}
+
+Exporter::~Exporter()
+{
+  {
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_stop = true;
+  }
+  d_cv.notify_one();
+  d_thread.join();
+  export_snapshot();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void
+Exporter::run()
+{
+  auto interval = std::chrono::duration<double>(d_interval);
+  std::unique_lock<std::mutex> lock(d_mutex);
+  while (!d_cv.wait_for(lock, interval, [this]() { return d_stop; }))
+  {
+    lock.unlock();
+    export_snapshot();
+    lock.lock();
+  }
+}
+
+void
+Exporter::export_snapshot()
+{
+  Snapshot cur;
+  cur.d_time     = get_cur_wall_time();
+  cur.d_runs     = d_runs.load(std::memory_order_relaxed);
+  cur.d_timeouts = d_timeouts.load(std::memory_order_relaxed);
+  cur.d_errors   = d_errors.load(std::memory_order_relaxed);
+  cur.d_counters = d_stats->aggregate();
+
+  if (!d_file_name.empty())
+  {
+    write_row(cur, d_prev);
+  }
+  if (!d_textfile_name.empty())
+  {
+    write_textfile(cur);
+  }
+  d_prev = std::move(cur);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void
+Exporter::write_row(const Snapshot& cur, const Snapshot& prev)
+{
+  const Counters& c                     = cur.d_counters;
+  const Counters& p                     = prev.d_counters;
+  const std::vector<std::string>& names = d_stats->get_action_kinds();
+
+  double interval = cur.d_time - prev.d_time;
+  uint64_t runs   = cur.d_runs - prev.d_runs;
+  double rate     = interval > 0 ? static_cast<double>(runs) / interval : 0;
+
+  std::stringstream row;
+  if (d_csv)
+  {
+    if (!std::filesystem::exists(d_file_name)
+        || std::filesystem::file_size(d_file_name) == 0)
+    {
+      row << "time,elapsed,interval,runs,runs_per_sec,timeouts,errors";
+      for (uint32_t i = 0; i < 3; ++i)
+      {
+        row << "," << static_cast<Solver::Result>(i);
+      }
+      for (const auto& name : names)
+      {
+        row << "," << name;
+      }
+      row << "\n";
+    }
+    row << get_cur_utc_time() << "," << std::fixed
+        << std::setprecision(2) << cur.d_time - d_start_time << ","
+        << interval << "," << runs << "," << rate << ","
+        << cur.d_timeouts - prev.d_timeouts << ","
+        << cur.d_errors - prev.d_errors;
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+      row << "," << c.d_results[i] - p.d_results[i];
+    }
+    for (size_t i = 0, n = c.d_actions.size(); i < n; ++i)
+    {
+      row << "," << c.d_actions[i] - p.d_actions[i];
+    }
+    row << "\n";
+  }
+  else
+  {
+    nlohmann::json j;
+    j["time"]         = get_cur_utc_time();
+    j["elapsed"]      = cur.d_time - d_start_time;
+    j["interval"]     = interval;
+    j["runs"]         = runs;
+    j["runs_per_sec"] = rate;
+    j["timeouts"]     = cur.d_timeouts - prev.d_timeouts;
+    j["errors"]       = cur.d_errors - prev.d_errors;
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+      std::stringstream ss;
+      ss << static_cast<Solver::Result>(i);
+      j["results"][ss.str()] = c.d_results[i] - p.d_results[i];
+    }
+    j["actions"] = nlohmann::json::object();
+    for (size_t i = 0, n = c.d_actions.size(); i < n; ++i)
+    {
+      if (c.d_actions[i] != p.d_actions[i])
+      {
+        j["actions"][names[i]] = {c.d_actions[i] - p.d_actions[i],
+                                  c.d_actions_ok[i] - p.d_actions_ok[i]};
+      }
+    }
+    row << j.dump() << "\n";
+  }
+
+  std::ofstream file(d_file_name, std::ios_base::app);
+  file << row.str() << std::flush;
+}
+
+void
+Exporter::write_textfile(const Snapshot& cur) const
+{
+  const Counters& c = cur.d_counters;
+  std::stringstream ss;
+
+  ss << "# HELP murxla_runs_total Number of test runs.\n"
+     << "# TYPE murxla_runs_total counter\n"
+     << "murxla_runs_total " << cur.d_runs << "\n";
+  ss << "# HELP murxla_timeouts_total Number of test runs that timed out.\n"
+     << "# TYPE murxla_timeouts_total counter\n"
+     << "murxla_timeouts_total " << cur.d_timeouts << "\n";
+  ss << "# HELP murxla_errors_total Number of new errors found.\n"
+     << "# TYPE murxla_errors_total counter\n"
+     << "murxla_errors_total " << cur.d_errors << "\n";
+  ss << "# HELP murxla_results_total Number of satisfiability results.\n"
+     << "# TYPE murxla_results_total counter\n";
+  for (uint32_t i = 0; i < 3; ++i)
+  {
+    ss << "murxla_results_total{result=\"" << static_cast<Solver::Result>(i)
+       << "\"} " << c.d_results[i] << "\n";
+  }
+  ss << "# HELP murxla_actions_total Number of actions (ok: successful).\n"
+     << "# TYPE murxla_actions_total counter\n";
+  const std::vector<std::string>& names = d_stats->get_action_kinds();
+  for (size_t i = 0, n = c.d_actions.size(); i < n; ++i)
+  {
+    ss << "murxla_actions_total{action=\"" << names[i] << "\",ok=\"false\"} "
+       << c.d_actions[i] - c.d_actions_ok[i] << "\n";
+    ss << "murxla_actions_total{action=\"" << names[i] << "\",ok=\"true\"} "
+       << c.d_actions_ok[i] << "\n";
+  }
+
+  /* Replace the text file atomically so that it is never read partially. */
+  std::string tmp_name = d_textfile_name + ".tmp";
+  {
+    std::ofstream file(tmp_name);
+    file << ss.str();
+  }
+  std::rename(tmp_name.c_str(), d_textfile_name.c_str());
+}
+
+/* -------------------------------------------------------------------------- */
+
+}  // namespace statistics
+}  // namespace murxla
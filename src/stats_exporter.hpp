@@ -0,0 +1,111 @@
+/***
+ * Murxla: A Model-Based API Fuzzer for SMT solvers.
+ *
+ * This file is part of Murxla.
+ *
+ * Copyright (C) 2019-2022 by the authors listed in the AUTHORS file.
+ *
+ * See LICENSE for more information on using this software.
+ */
+#ifndef __MURXLA__STATS_EXPORTER_H
+#define __MURXLA__STATS_EXPORTER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "statistics.hpp"
+
+namespace murxla {
+namespace statistics {
+
+/**
+ * Periodically exports snapshots of the statistics of a continuous test run.
+ *
+ * Every 'interval' seconds (and once more when the exporter is destroyed), a
+ * row with the deltas of the counters since the previous snapshot is
+ * appended to the export file, in CSV format if its name ends with '.csv'
+ * and in JSON Lines format otherwise. Optionally, the totals are written to
+ * a text file in the format of the Prometheus node exporter textfile
+ * collector, which is replaced atomically.
+ *
+ * Snapshots are taken on a separate thread, which only reads the (atomic)
+ * counters, the test loop is never blocked.
+ */
+class Exporter
+{
+ public:
+  /**
+   * Constructor, starts the export thread.
+   * stats         : The statistics to export, must be allocated.
+   * file_name     : The name of the file to append snapshots to, may be empty.
+   * textfile_name : The name of the node exporter text file, may be empty.
+   * interval      : The interval between snapshots in seconds.
+   */
+  Exporter(const Statistics* stats,
+           const std::string& file_name,
+           const std::string& textfile_name,
+           double interval);
+  /** Destructor, stops the export thread and takes a final snapshot. */
+  ~Exporter();
+
+  /** Count a finished test run, a timeout and a new error, respectively. */
+  void inc_runs() { d_runs.fetch_add(1, std::memory_order_relaxed); }
+  void inc_timeouts() { d_timeouts.fetch_add(1, std::memory_order_relaxed); }
+  void inc_errors() { d_errors.fetch_add(1, std::memory_order_relaxed); }
+
+ private:
+  /** The totals of a snapshot. */
+  struct Snapshot
+  {
+    double d_time       = 0;
+    uint64_t d_runs     = 0;
+    uint64_t d_timeouts = 0;
+    uint64_t d_errors   = 0;
+    Counters d_counters;
+  };
+
+  /** The main loop of the export thread. */
+  void run();
+  /** Take a snapshot and export it. */
+  void export_snapshot();
+  /** Append the deltas of 'cur' to 'prev' to the export file. */
+  void write_row(const Snapshot& cur, const Snapshot& prev);
+  /** Write the totals of 'cur' to the text file. */
+  void write_textfile(const Snapshot& cur) const;
+
+  /** The exported statistics. */
+  const Statistics* d_stats;
+  /** The name of the export file. */
+  std::string d_file_name;
+  /** The name of the node exporter text file. */
+  std::string d_textfile_name;
+  /** True to export in CSV format. */
+  bool d_csv = false;
+  /** The interval between snapshots in seconds. */
+  double d_interval;
+
+  /** The counters that are maintained by the test loop. */
+  std::atomic<uint64_t> d_runs{0};
+  std::atomic<uint64_t> d_timeouts{0};
+  std::atomic<uint64_t> d_errors{0};
+
+  /** The time the exporter was started. */
+  double d_start_time;
+  /** The previous snapshot. */
+  Snapshot d_prev;
+
+  /** Synchronization of the export thread. */
+  std::mutex d_mutex;
+  std::condition_variable d_cv;
+  bool d_stop = false;
+  std::thread d_thread;
+};
+
+}  // namespace statistics
+}  // namespace murxla
+
+#endif
@@ -14,9 +14,11 @@
 
 #include <algorithm>
 #include <cassert>
+#include <ctime>
 #include <fstream>
 #include <iomanip>
 #include <limits>
+#include <nlohmann/json.hpp>
 #include <sstream>
 #include <unordered_map>
 
@@ -621,6 +623,14 @@ find_in_file(const std::string& file_name, const std::string& s, bool is_forked)
 
 /* -------------------------------------------------------------------------- */
 
+std::string
+dump_json(const nlohmann::json& j)
+{
+  return j.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+}
+
+/* -------------------------------------------------------------------------- */
+
 double
 get_cur_wall_time()
 {
@@ -629,6 +639,17 @@ get_cur_wall_time()
   return (double) time.tv_sec + (double) time.tv_usec / 1000000;
 }
 
+std::string
+get_cur_utc_time()
+{
+  char buf[32];
+  struct tm tm;
+  std::time_t now = std::time(nullptr);
+  MURXLA_EXIT_ERROR(gmtime_r(&now, &tm) == nullptr) << "failed to get time";
+  std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
+  return buf;
+}
+
 /* -------------------------------------------------------------------------- */
 
 std::tuple<uint32_t, std::string, std::vector<std::string>>
@@ -11,6 +11,7 @@
 #define __MURXLA__UTIL_H
 
 #include <cstdint>
+#include <nlohmann/json_fwd.hpp>
 #include <string>
 #include <vector>
 
@@ -133,8 +134,21 @@ bool find_in_file(const std::string& file_name,
 
 /* -------------------------------------------------------------------------- */
 
+/**
+ * Serialize given JSON value to a single line.
+ *
+ * Error messages and solver output are not necessarily valid UTF-8, invalid
+ * bytes are thus replaced rather than raising an exception.
+ */
+std::string dump_json(const nlohmann::json& j);
+
+/* -------------------------------------------------------------------------- */
+
 double get_cur_wall_time();
 
+/** Get the current time in ISO 8601 format (UTC). */
+std::string get_cur_utc_time();
+
 /* -------------------------------------------------------------------------- */
 
 /**
@@ -0,0 +1,78 @@
+/***
+ * Murxla: A Model-Based API Fuzzer for SMT solvers.
+ *
+ * This file is part of Murxla.
+ *
+ * Copyright (C) 2019-2022 by the authors listed in the AUTHORS file.
+ *
+ * See LICENSE for more information on using this software.
+ */
+#include <filesystem>
+
+#include "error_db.hpp"
+#include "gtest/gtest.h"
+
+using namespace murxla;
+
+TEST(error_db, get_unique_key)
+{
+  ErrorDatabase::ErrorMap errors;
+  std::string e = "unexpected result";
+
+  ASSERT_EQ(ErrorDatabase::get_unique_key(errors, e, ""), e);
+  ASSERT_EQ(ErrorDatabase::get_unique_key(errors, e, "sig"), e);
+
+  /* Distinct errors with the same message are distinguished by signature. */
+  errors.emplace(e, ErrorInfo(1, e, {1}, "sig1"));
+  ASSERT_EQ(ErrorDatabase::get_unique_key(errors, e, "sig2"), e + "\nsig2");
+
+  /* An error without signature with the same message as an error with
+   * signature (which is not in the text index) gets a new key. */
+  std::string key = ErrorDatabase::get_unique_key(errors, e, "");
+  ASSERT_EQ(errors.find(key), errors.end());
+  errors.emplace(key, ErrorInfo(2, e, {2}));
+  std::string key2 = ErrorDatabase::get_unique_key(errors, e, "");
+  ASSERT_EQ(errors.find(key2), errors.end());
+  ASSERT_NE(key, key2);
+
+  /* The same holds for the disambiguated key of an error with signature. */
+  errors.emplace(e + "\nsig2", ErrorInfo(3, e, {3}, "sig2"));
+  key = ErrorDatabase::get_unique_key(errors, e, "sig2");
+  ASSERT_EQ(errors.find(key), errors.end());
+}
+
+TEST(error_db, update)
+{
+  std::string file_name =
+      (std::filesystem::temp_directory_path() / "murxla-test-error-db.jsonl")
+          .string();
+  std::filesystem::remove(file_name);
+
+  ErrorDatabase::ErrorMap errors;
+  {
+    ErrorDatabase db(file_name);
+    ErrorDatabase::Lock lock(&db);
+    ASSERT_TRUE(db.update(errors).empty());
+    errors.emplace("e1", ErrorInfo(1, "error 1", {1}));
+    errors.emplace("e2", ErrorInfo(2, "error 2", {2}));
+    db.add("e1", errors.at("e1"), 1);
+    db.add("e2", errors.at("e2"), 2);
+    /* Further occurrences are recorded when the database is closed. */
+    db.add("e1", errors.at("e1"), 3);
+    db.add("e1", errors.at("e1"), 4);
+    ASSERT_EQ(errors.at("e1").num_recorded, 3);
+  }
+
+  ErrorDatabase::ErrorMap loaded;
+  ErrorDatabase db(file_name);
+  ErrorDatabase::Lock lock(&db);
+  ASSERT_EQ(db.update(loaded).size(), 2);
+  ASSERT_TRUE(loaded.at("e1").known);
+  ASSERT_EQ(loaded.at("e1").id, 1);
+  ASSERT_EQ(loaded.at("e1").errmsg, "error 1");
+  ASSERT_EQ(loaded.at("e1").num_recorded, 3);
+  ASSERT_EQ(loaded.at("e2").num_recorded, 1);
+  ASSERT_TRUE(db.update(loaded).empty());
+
+  std::filesystem::remove(file_name);
+}
@@ -0,0 +1,101 @@
+#include "error_index.hpp"
+#include "gtest/gtest.h"
+
+using namespace murxla;
+
+TEST(error_index, diff)
+{
+  ASSERT_EQ(ErrorIndex::diff("a b c", "a b c"), 0.0);
+  ASSERT_EQ(ErrorIndex::diff("error at line 12", "error at line 345"), 0.0);
+  ASSERT_EQ(ErrorIndex::diff("abc def", "abc xyz"), 3.0 / 7.0);
+  ASSERT_EQ(ErrorIndex::diff("abc", "abc def"), 1.0 / 7.0);
+  ASSERT_EQ(ErrorIndex::diff("a1 b", "a2 b"), 1.0 / 4.0);
+}
+
+TEST(error_index, find)
+{
+  ErrorIndex index;
+  std::string e1 =
+      "Fatal failure within void foo() at src/foo.cpp line "
+      "123 assertion 'x == y' failed";
+  std::string e2 = "unexpected result";
+
+  ASSERT_EQ(index.find(e1), nullptr);
+  index.add(e1);
+  index.add(e2);
+  ASSERT_EQ(index.size(), 2);
+
+  const std::string* res = index.find(e1);
+  ASSERT_NE(res, nullptr);
+  ASSERT_EQ(*res, e1);
+
+  /* Differs in numbers only. */
+  res = index.find(
+      "Fatal failure within void foo() at src/foo.cpp line "
+      "456 assertion 'x == y' failed");
+  ASSERT_NE(res, nullptr);
+  ASSERT_EQ(*res, e1);
+
+  /* Differs in less than 5% of characters. */
+  res = index.find(
+      "Fatal failure within void foo() at src/foo.cpp line "
+      "123 assertion 'x == z' failed");
+  ASSERT_NE(res, nullptr);
+  ASSERT_EQ(*res, e1);
+
+  /* Differs in more than 5% of characters. */
+  ASSERT_EQ(index.find("Fatal failure within void bar() at src/bar.cpp line "
+                       "123 assertion 'x != y' failed"),
+            nullptr);
+  ASSERT_EQ(index.find("unexpected results"), nullptr);
+  ASSERT_EQ(index.find(""), nullptr);
+
+  index.clear();
+  ASSERT_EQ(index.size(), 0);
+  ASSERT_EQ(index.find(e1), nullptr);
+}
+
+TEST(error_index, get_error_signature)
+{
+  std::string asan =
+      "=================================================================\n"
+      "==4711==ERROR: AddressSanitizer: heap-use-after-free on address "
+      "0x602000000010 at pc 0x55d1 bp 0x7ffd sp 0x7ffc\n"
+      "READ of size 4 at 0x602000000010 thread T0\n"
+      "    #0 0x55d1 in __interceptor_memcpy (/usr/lib/libasan.so+0x3a9d)\n"
+      "    #1 0x55d2 in foo /src/foo.c:12:3\n"
+      "    #2 0x55d3 in bar /src/bar.c:34:5\n"
+      "    #3 0x55d4 in baz /src/baz.c:56:7\n"
+      "    #4 0x55d5 in main /src/main.c:78:9\n"
+      "\n"
+      "0x602000000010 is located 0 bytes inside of 4-byte region\n"
+      "freed by thread T0 here:\n"
+      "    #0 0x55d6 in free (/usr/lib/libasan.so+0x10d7)\n"
+      "    #1 0x55d7 in qux /src/qux.c:90:1\n"
+      "\n"
+      "SUMMARY: AddressSanitizer: heap-use-after-free /src/foo.c:12:3 in foo\n";
+  ASSERT_EQ(get_error_signature(asan, 0),
+            "AddressSanitizer: heap-use-after-free\nin foo\nin bar\nin baz\n");
+  ASSERT_EQ(get_error_signature(asan, 6, 1),
+            "AddressSanitizer: heap-use-after-free\nin foo\nsignal 6\n");
+
+  ASSERT_EQ(get_error_signature(
+                "/src/foo.c:12:3: runtime error: signed integer overflow\n", 0),
+            "UndefinedBehaviorSanitizer: runtime error at /src/foo.c:12\n");
+
+  ASSERT_EQ(get_error_signature("solver: /src/foo.c:42: int foo(int): "
+                                "Assertion `x > 0' failed.\n",
+                                6),
+            "assertion at /src/foo.c:42\nsignal 6\n");
+  ASSERT_EQ(get_error_signature("Assertion failed: (x > 0), function foo, "
+                                "file foo.c, line 42.\n",
+                                6),
+            "assertion at foo.c:42\nsignal 6\n");
+  ASSERT_EQ(get_error_signature("Fatal failure within void foo() at "
+                                "/src/foo.cpp:42\n",
+                                6),
+            "assertion at /src/foo.cpp:42\nsignal 6\n");
+
+  ASSERT_EQ(get_error_signature("unexpected result\n", 0), "");
+  ASSERT_EQ(get_error_signature("", 11), "");
+}
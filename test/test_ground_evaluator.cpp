@@ -0,0 +1,307 @@
+#include <memory>
+#include <optional>
+
+#include "gtest/gtest.h"
+#include "solver/meta/ground_evaluator.hpp"
+
+using namespace murxla;
+
+namespace {
+
+using Value = GroundEvaluator::Value;
+
+/** A sort that only provides its kind and bit-vector size. */
+class TestSort : public AbsSort
+{
+ public:
+  TestSort(SortKind kind, uint32_t bv_size = 0) : d_bv_size(bv_size)
+  {
+    set_kind(kind);
+  }
+  size_t hash() const override { return 0; }
+  std::string to_string() const override { return ""; }
+  bool equals(const Sort& other) const override { return this == other.get(); }
+  uint32_t get_bv_size() const override { return d_bv_size; }
+
+ private:
+  uint32_t d_bv_size;
+};
+
+/** A term that only provides its string representation. */
+class TestTerm : public AbsTerm
+{
+ public:
+  TestTerm(const std::string& repr = "") : d_repr(repr) {}
+  size_t hash() const override { return 0; }
+  std::string to_string() const override { return d_repr; }
+  bool equals(const Term& other) const override { return this == other.get(); }
+
+ private:
+  std::string d_repr;
+};
+
+Value
+mk_bool(bool value)
+{
+  Value res;
+  res.d_kind = Value::BOOL;
+  res.d_bool = value;
+  return res;
+}
+
+Value
+mk_bv(uint64_t value, uint32_t size)
+{
+  Value res;
+  res.d_kind    = Value::BV;
+  res.d_bv      = value;
+  res.d_bv_size = size;
+  return res;
+}
+
+Value
+mk_num(int64_t num, int64_t den = 1)
+{
+  Value res;
+  res.d_kind = Value::NUM;
+  res.d_num  = num;
+  res.d_den  = den;
+  return res;
+}
+
+/**
+ * Evaluate a term of given kind and indices over bit-vector values of given
+ * size.
+ */
+std::optional<Value>
+eval_bv(Op::Kind kind,
+        uint32_t size,
+        const std::vector<uint64_t>& values,
+        const std::vector<uint32_t>& indices = {})
+{
+  GroundEvaluator ge;
+  Sort sort = std::make_shared<TestSort>(SORT_BV, size);
+  std::vector<Term> args;
+  for (uint64_t value : values)
+  {
+    args.push_back(std::make_shared<TestTerm>());
+    ge.add_value(args.back(), sort, std::to_string(value), Solver::Base::DEC);
+  }
+  Term term = std::make_shared<TestTerm>();
+  ge.add_term(term, kind, args, indices);
+  return ge.evaluate(term);
+}
+
+/** Evaluate a term of given kind over integer values. */
+std::optional<Value>
+eval_int(Op::Kind kind, const std::vector<int64_t>& values)
+{
+  GroundEvaluator ge;
+  Sort sort = std::make_shared<TestSort>(SORT_INT);
+  std::vector<Term> args;
+  for (int64_t value : values)
+  {
+    args.push_back(std::make_shared<TestTerm>());
+    ge.add_value(args.back(), sort, std::to_string(value));
+  }
+  Term term = std::make_shared<TestTerm>();
+  ge.add_term(term, kind, args, {});
+  return ge.evaluate(term);
+}
+
+}  // namespace
+
+TEST(ground_evaluator, parse_value_bool)
+{
+  ASSERT_EQ(GroundEvaluator::parse_value("true", SORT_BOOL, 0), mk_bool(true));
+  ASSERT_EQ(GroundEvaluator::parse_value("false", SORT_BOOL, 0),
+            mk_bool(false));
+  ASSERT_FALSE(GroundEvaluator::parse_value("#b1", SORT_BOOL, 0));
+  ASSERT_FALSE(GroundEvaluator::parse_value("true false", SORT_BOOL, 0));
+}
+
+TEST(ground_evaluator, parse_value_bv)
+{
+  ASSERT_EQ(GroundEvaluator::parse_value("#b0101", SORT_BV, 4), mk_bv(5, 4));
+  ASSERT_EQ(GroundEvaluator::parse_value("#x0f", SORT_BV, 8), mk_bv(15, 8));
+  ASSERT_EQ(GroundEvaluator::parse_value("#x0F", SORT_BV, 8), mk_bv(15, 8));
+  ASSERT_EQ(GroundEvaluator::parse_value("(_ bv5 4)", SORT_BV, 4),
+            mk_bv(5, 4));
+  ASSERT_EQ(GroundEvaluator::parse_value(
+                "(_ bv18446744073709551615 64)", SORT_BV, 64),
+            mk_bv(UINT64_MAX, 64));
+  ASSERT_EQ(
+      GroundEvaluator::parse_value("#xffffffffffffffff", SORT_BV, 64),
+      mk_bv(UINT64_MAX, 64));
+
+  /* size mismatch */
+  ASSERT_FALSE(GroundEvaluator::parse_value("#b0101", SORT_BV, 8));
+  ASSERT_FALSE(GroundEvaluator::parse_value("#x0f", SORT_BV, 4));
+  ASSERT_FALSE(GroundEvaluator::parse_value("(_ bv5 4)", SORT_BV, 8));
+  /* out of range */
+  ASSERT_FALSE(GroundEvaluator::parse_value("(_ bv16 4)", SORT_BV, 4));
+  ASSERT_FALSE(GroundEvaluator::parse_value(
+      "(_ bv18446744073709551616 64)", SORT_BV, 64));
+  /* unsupported size */
+  ASSERT_FALSE(GroundEvaluator::parse_value(
+      "#x00000000000000000", SORT_BV, 68));
+  /* malformed */
+  ASSERT_FALSE(GroundEvaluator::parse_value("#b0102", SORT_BV, 4));
+  ASSERT_FALSE(GroundEvaluator::parse_value("(_ bv5 4", SORT_BV, 4));
+  ASSERT_FALSE(GroundEvaluator::parse_value("5", SORT_BV, 4));
+}
+
+TEST(ground_evaluator, parse_value_num)
+{
+  ASSERT_EQ(GroundEvaluator::parse_value("5", SORT_INT, 0), mk_num(5));
+  ASSERT_EQ(GroundEvaluator::parse_value("(- 5)", SORT_INT, 0), mk_num(-5));
+  ASSERT_EQ(GroundEvaluator::parse_value("-5", SORT_INT, 0), mk_num(-5));
+  ASSERT_EQ(GroundEvaluator::parse_value("1.5", SORT_REAL, 0), mk_num(3, 2));
+  ASSERT_EQ(GroundEvaluator::parse_value("(/ 1 3)", SORT_REAL, 0),
+            mk_num(1, 3));
+  ASSERT_EQ(GroundEvaluator::parse_value("(/ 2.0 4.0)", SORT_REAL, 0),
+            mk_num(1, 2));
+  ASSERT_EQ(GroundEvaluator::parse_value("(- (/ 1 3))", SORT_REAL, 0),
+            mk_num(-1, 3));
+  ASSERT_EQ(GroundEvaluator::parse_value("(/ (- 1) 3)", SORT_REAL, 0),
+            mk_num(-1, 3));
+  ASSERT_EQ(GroundEvaluator::parse_value("2/4", SORT_REAL, 0), mk_num(1, 2));
+
+  ASSERT_FALSE(GroundEvaluator::parse_value("(/ 1 0)", SORT_REAL, 0));
+  ASSERT_FALSE(GroundEvaluator::parse_value("(- 5", SORT_INT, 0));
+  ASSERT_FALSE(GroundEvaluator::parse_value("5 6", SORT_INT, 0));
+  ASSERT_FALSE(GroundEvaluator::parse_value("abc", SORT_INT, 0));
+  ASSERT_FALSE(GroundEvaluator::parse_value("", SORT_INT, 0));
+  ASSERT_FALSE(
+      GroundEvaluator::parse_value("99999999999999999999", SORT_INT, 0));
+}
+
+TEST(ground_evaluator, bv_div_by_zero)
+{
+  /* 4-bit, 13 = -3 */
+  ASSERT_EQ(eval_bv(Op::BV_UDIV, 4, {5, 0}), mk_bv(15, 4));
+  ASSERT_EQ(eval_bv(Op::BV_UREM, 4, {5, 0}), mk_bv(5, 4));
+  ASSERT_EQ(eval_bv(Op::BV_SDIV, 4, {5, 0}), mk_bv(15, 4));
+  ASSERT_EQ(eval_bv(Op::BV_SDIV, 4, {13, 0}), mk_bv(1, 4));
+  ASSERT_EQ(eval_bv(Op::BV_SREM, 4, {5, 0}), mk_bv(5, 4));
+  ASSERT_EQ(eval_bv(Op::BV_SREM, 4, {13, 0}), mk_bv(13, 4));
+  ASSERT_EQ(eval_bv(Op::BV_SMOD, 4, {5, 0}), mk_bv(5, 4));
+  ASSERT_EQ(eval_bv(Op::BV_SMOD, 4, {13, 0}), mk_bv(13, 4));
+  ASSERT_EQ(eval_bv(Op::BV_SDIV, 64, {UINT64_MAX, 0}), mk_bv(1, 64));
+  ASSERT_EQ(eval_bv(Op::BV_SMOD, 64, {UINT64_MAX, 0}), mk_bv(UINT64_MAX, 64));
+}
+
+TEST(ground_evaluator, bv_signed_div)
+{
+  /* 4-bit, 9 = -7, 14 = -2, 13 = -3, 15 = -1 */
+  ASSERT_EQ(eval_bv(Op::BV_SDIV, 4, {9, 2}), mk_bv(13, 4));
+  ASSERT_EQ(eval_bv(Op::BV_SDIV, 4, {7, 14}), mk_bv(13, 4));
+  ASSERT_EQ(eval_bv(Op::BV_SDIV, 4, {9, 14}), mk_bv(3, 4));
+  ASSERT_EQ(eval_bv(Op::BV_SREM, 4, {9, 2}), mk_bv(15, 4));
+  ASSERT_EQ(eval_bv(Op::BV_SREM, 4, {7, 14}), mk_bv(1, 4));
+  ASSERT_EQ(eval_bv(Op::BV_SREM, 4, {9, 14}), mk_bv(15, 4));
+  ASSERT_EQ(eval_bv(Op::BV_SMOD, 4, {9, 2}), mk_bv(1, 4));
+  ASSERT_EQ(eval_bv(Op::BV_SMOD, 4, {7, 14}), mk_bv(15, 4));
+  ASSERT_EQ(eval_bv(Op::BV_SMOD, 4, {9, 14}), mk_bv(15, 4));
+  ASSERT_EQ(eval_bv(Op::BV_SMOD, 4, {8, 2}), mk_bv(0, 4));
+  /* min signed / -1 overflows to min signed */
+  ASSERT_EQ(eval_bv(Op::BV_SDIV, 4, {8, 15}), mk_bv(8, 4));
+}
+
+TEST(ground_evaluator, bv_width64)
+{
+  uint64_t v = 0x1234567890abcdef;
+  ASSERT_EQ(eval_bv(Op::BV_EXTRACT, 64, {UINT64_MAX}, {63, 0}),
+            mk_bv(UINT64_MAX, 64));
+  ASSERT_EQ(eval_bv(Op::BV_EXTRACT, 64, {0x8000000000000000}, {63, 63}),
+            mk_bv(1, 1));
+  ASSERT_EQ(eval_bv(Op::BV_EXTRACT, 64, {v}, {31, 0}), mk_bv(0x90abcdef, 32));
+  ASSERT_EQ(eval_bv(Op::BV_EXTRACT, 64, {v}, {63, 32}),
+            mk_bv(0x12345678, 32));
+
+  ASSERT_EQ(eval_bv(Op::BV_ROTATE_LEFT, 64, {0x8000000000000001}, {4}),
+            mk_bv(0x18, 64));
+  ASSERT_EQ(eval_bv(Op::BV_ROTATE_RIGHT, 64, {0x8000000000000001}, {4}),
+            mk_bv(0x1800000000000000, 64));
+  ASSERT_EQ(eval_bv(Op::BV_ROTATE_LEFT, 64, {v}, {0}), mk_bv(v, 64));
+  ASSERT_EQ(eval_bv(Op::BV_ROTATE_LEFT, 64, {v}, {64}), mk_bv(v, 64));
+  ASSERT_EQ(eval_bv(Op::BV_ROTATE_RIGHT, 64, {v}, {64}), mk_bv(v, 64));
+  ASSERT_EQ(eval_bv(Op::BV_ROTATE_LEFT, 64, {v}, {68}),
+            eval_bv(Op::BV_ROTATE_LEFT, 64, {v}, {4}));
+  ASSERT_EQ(eval_bv(Op::BV_ROTATE_LEFT, 64, {v}, {60}),
+            eval_bv(Op::BV_ROTATE_RIGHT, 64, {v}, {4}));
+
+  ASSERT_EQ(eval_bv(Op::BV_CONCAT, 32, {0x12345678, 0x90abcdef}),
+            mk_bv(v, 64));
+  ASSERT_FALSE(eval_bv(Op::BV_CONCAT, 64, {v, 1}));
+  ASSERT_FALSE(eval_bv(Op::BV_ZERO_EXTEND, 64, {v}, {1}));
+  ASSERT_EQ(eval_bv(Op::BV_SIGN_EXTEND, 32, {0x80000000}, {32}),
+            mk_bv(0xffffffff80000000, 64));
+
+  ASSERT_EQ(eval_bv(Op::BV_SHL, 64, {v, 64}), mk_bv(0, 64));
+  ASSERT_EQ(eval_bv(Op::BV_LSHR, 64, {v, 63}), mk_bv(0, 64));
+  ASSERT_EQ(eval_bv(Op::BV_ASHR, 64, {0x8000000000000000, 63}),
+            mk_bv(UINT64_MAX, 64));
+  ASSERT_EQ(eval_bv(Op::BV_ASHR, 64, {0x8000000000000000, 64}),
+            mk_bv(UINT64_MAX, 64));
+  ASSERT_EQ(eval_bv(Op::BV_NEG, 64, {1}), mk_bv(UINT64_MAX, 64));
+  ASSERT_EQ(eval_bv(Op::BV_SLT, 64, {0x8000000000000000, 0}), mk_bool(true));
+  ASSERT_EQ(eval_bv(Op::BV_ULT, 64, {0x8000000000000000, 0}), mk_bool(false));
+}
+
+TEST(ground_evaluator, int_div_mod)
+{
+  ASSERT_EQ(eval_int(Op::INT_DIV, {7, 2}), mk_num(3));
+  ASSERT_EQ(eval_int(Op::INT_MOD, {7, 2}), mk_num(1));
+  ASSERT_EQ(eval_int(Op::INT_DIV, {-7, 2}), mk_num(-4));
+  ASSERT_EQ(eval_int(Op::INT_MOD, {-7, 2}), mk_num(1));
+  ASSERT_EQ(eval_int(Op::INT_DIV, {7, -2}), mk_num(-3));
+  ASSERT_EQ(eval_int(Op::INT_MOD, {7, -2}), mk_num(1));
+  ASSERT_EQ(eval_int(Op::INT_DIV, {-7, -2}), mk_num(4));
+  ASSERT_EQ(eval_int(Op::INT_MOD, {-7, -2}), mk_num(1));
+  ASSERT_EQ(eval_int(Op::INT_DIV, {-8, 2}), mk_num(-4));
+  ASSERT_EQ(eval_int(Op::INT_MOD, {-8, 2}), mk_num(0));
+  /* left associative */
+  ASSERT_EQ(eval_int(Op::INT_DIV, {-7, 2, 3}), mk_num(-2));
+
+  /* division by zero is unspecified */
+  ASSERT_FALSE(eval_int(Op::INT_DIV, {7, 0}));
+  ASSERT_FALSE(eval_int(Op::INT_MOD, {7, 0}));
+  /* overflow */
+  ASSERT_FALSE(eval_int(Op::INT_ADD, {INT64_MAX, 1}));
+  ASSERT_FALSE(eval_int(Op::INT_MUL, {INT64_MAX, 2}));
+}
+
+TEST(ground_evaluator, model)
+{
+  GroundEvaluator ge;
+  Sort sort_bv  = std::make_shared<TestSort>(SORT_BV, 64);
+  Sort sort_int = std::make_shared<TestSort>(SORT_INT);
+  Term x        = std::make_shared<TestTerm>();
+  Term y        = std::make_shared<TestTerm>();
+  Term t        = std::make_shared<TestTerm>();
+  Term u        = std::make_shared<TestTerm>();
+  ge.add_const(x, sort_bv);
+  ge.add_const(y, sort_int);
+  ge.add_term(t, Op::BV_EXTRACT, {x}, {63, 60});
+  ge.add_term(u, Op::INT_NEG, {y}, {});
+
+  ASSERT_TRUE(ge.is_supported({t, u}));
+  ASSERT_EQ(ge.get_consts({t, u}).size(), 2u);
+
+  ASSERT_TRUE(ge.set_model({x, y},
+                           {std::make_shared<TestTerm>("#xf000000000000000"),
+                            std::make_shared<TestTerm>("(- 3)")}));
+  ASSERT_EQ(ge.evaluate(t), mk_bv(15, 4));
+  ASSERT_EQ(ge.evaluate(u), mk_num(3));
+
+  ASSERT_TRUE(ge.set_model({x, y},
+                           {std::make_shared<TestTerm>("(_ bv0 64)"),
+                            std::make_shared<TestTerm>("3")}));
+  ASSERT_EQ(ge.evaluate(t), mk_bv(0, 4));
+  ASSERT_EQ(ge.evaluate(u), mk_num(-3));
+
+  ASSERT_FALSE(ge.set_model({x, y},
+                            {std::make_shared<TestTerm>("#x00"),
+                             std::make_shared<TestTerm>("3")}));
+}
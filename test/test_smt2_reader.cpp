@@ -0,0 +1,87 @@
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "solver/smt2/smt2_reader.hpp"
+
+using namespace murxla::smt2;
+
+namespace {
+
+/**
+ * Read all responses from 'input' with a reader that reads chunks of size
+ * 'chunk_size'.
+ */
+std::vector<std::string>
+read_all(const std::string& input, size_t chunk_size)
+{
+  int32_t fd[2];
+  EXPECT_EQ(pipe(fd), 0);
+  EXPECT_EQ(write(fd[1], input.data(), input.size()),
+            static_cast<ssize_t>(input.size()));
+  close(fd[1]);
+
+  std::vector<std::string> res;
+  Smt2Reader reader(fd[0], chunk_size);
+  for (;;)
+  {
+    std::string_view r = reader.read();
+    if (r == Smt2Reader::RESPONSE_EOF) break;
+    res.emplace_back(r);
+  }
+  close(fd[0]);
+  return res;
+}
+
+}  // namespace
+
+TEST(smt2_reader, lines)
+{
+  for (size_t chunk_size : {1, 3, 4096})
+  {
+    std::vector<std::string> expected = {"success", "sat", "unknown"};
+    ASSERT_EQ(read_all("success\nsat\r\n\n  unknown\n", chunk_size), expected);
+  }
+}
+
+TEST(smt2_reader, sexprs)
+{
+  for (size_t chunk_size : {1, 3, 4096})
+  {
+    std::vector<std::string> expected = {
+        "(\n  (define-fun x () Int 1)\n)",
+        "((x #b01) (y (- 1)))",
+        "success"};
+    ASSERT_EQ(read_all("(\n  (define-fun x () Int 1)\n)\n"
+                       "((x #b01) (y (- 1)))\nsuccess\n",
+                       chunk_size),
+              expected);
+  }
+}
+
+TEST(smt2_reader, quoted)
+{
+  for (size_t chunk_size : {1, 3, 4096})
+  {
+    std::vector<std::string> expected = {
+        "((|)| 1) (|a(b| 2))",
+        "(error \"unexpected ) in \"\"(\"\" \")",
+        "((x \"(\") ; comment )\n (y \")\"))",
+        "success"};
+    ASSERT_EQ(read_all("((|)| 1) (|a(b| 2))\n"
+                       "(error \"unexpected ) in \"\"(\"\" \")\n"
+                       "((x \"(\") ; comment )\n (y \")\"))\n"
+                       "success\n",
+                       chunk_size),
+              expected);
+  }
+}
+
+TEST(smt2_reader, eof)
+{
+  std::vector<std::string> expected = {"sat"};
+  ASSERT_EQ(read_all("sat\n(model", 4096), expected);
+  ASSERT_EQ(read_all("sat\nsucc", 2), expected);
+}